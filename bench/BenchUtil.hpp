@@ -0,0 +1,46 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace hft::bench {
+
+/**
+ * @brief Print min and percentiles of samples (sorts them in place)
+ *
+ * @param label
+ * @param samples nanoseconds
+ */
+inline void PrintDistribution(const char* label, std::vector<double>& samples)
+{
+    if (samples.empty()) {
+        std::printf("%-24s no samples\n", label);
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double quantile) {
+        const auto index = static_cast<std::size_t>(quantile * static_cast<double>(samples.size() - 1));
+        return samples[index];
+    };
+    std::printf("%-24s n=%-8zu min=%-8.0f p50=%-8.0f p90=%-8.0f p99=%-8.0f p99.9=%-8.0f max=%.0f ns\n",
+        label, samples.size(), samples.front(), at(0.5), at(0.9), at(0.99), at(0.999), samples.back());
+}
+
+/**
+ * @brief Value of --name N on the command line, or fallback
+ *
+ */
+inline auto ArgOr(int argc, char** argv, const char* name, long long fallback) -> long long
+{
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) {
+            return std::atoll(argv[i + 1]);
+        }
+    }
+    return fallback;
+}
+
+} // namespace hft::bench
@@ -0,0 +1,129 @@
+// Core to core latency matrix and a suggested pipeline stage placement.
+//
+// Every ordered pair of cpus runs a ping-pong over SPSCRingBuffer (the
+// same hand-off the pipeline stages use) and reports the median round trip.
+// The matrix is printed with the latency tiers found in it, typically SMT
+// siblings, shared L3 (CCX / die) and sockets, followed by the placement of
+// the stages of a topology config that minimises weighted hand-off latency.
+// Run it on an otherwise idle machine, one pair is measured at a time.
+//
+// Topology config, one item per line (see StageGraph):
+//     stage feed
+//     stage engine
+//     link feed engine 1.0
+// Without --config the feed, engine, gateway, drop copy pipeline is used.
+//
+// Usage: core_latency_bench [--cpus N] [--first N] [--trips N] [--config FILE]
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BenchUtil.hpp"
+#include "CorePlacement.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+auto ConfigPath(int argc, char** argv) -> const char*
+{
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--config") == 0) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
+void PrintMatrix(const CoreLatencyMatrix& matrix)
+{
+    std::printf("round trip ns, row pings column\n%6s", "");
+    for (const int cpu : matrix.cpus) {
+        std::printf("%7d", cpu);
+    }
+    std::printf("\n");
+    for (std::size_t a = 0; a < matrix.Size(); ++a) {
+        std::printf("%6d", matrix.cpus[a]);
+        for (std::size_t b = 0; b < matrix.Size(); ++b) {
+            if (a == b) {
+                std::printf("%7s", "-");
+            } else if (std::isnan(matrix.At(a, b))) {
+                std::printf("%7s", "n/a");
+            } else {
+                std::printf("%7.0f", matrix.At(a, b));
+            }
+        }
+        std::printf("\n");
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const auto hardware = static_cast<long long>(std::thread::hardware_concurrency());
+    const long long first = hft::bench::ArgOr(argc, argv, "--first", 0);
+    const long long count = hft::bench::ArgOr(argc, argv, "--cpus", hardware - first);
+    const auto trips = static_cast<std::size_t>(hft::bench::ArgOr(argc, argv, "--trips", 2000));
+
+    StageGraph graph = StageGraph::Default();
+    if (const char* path = ConfigPath(argc, argv)) {
+        std::ifstream file(path);
+        std::stringstream text;
+        text << file.rdbuf();
+        graph = StageGraph {};
+        if (!file || !graph.Parse(text.str())) {
+            std::fprintf(stderr, "cannot read topology config %s\n", path);
+            return 1;
+        }
+    }
+
+    std::vector<int> cpus;
+    for (long long cpu = first; cpu < first + count; ++cpu) {
+        cpus.push_back(static_cast<int>(cpu));
+    }
+    if (cpus.size() < 2) {
+        std::fprintf(stderr, "need at least two cpus, have %zu\n", cpus.size());
+        return 1;
+    }
+    std::printf("core to core latency, %zu cpus, %zu round trips per pair\n", cpus.size(), trips);
+
+    const CoreLatencyMatrix matrix = MeasureCoreLatencyMatrix(cpus, trips);
+    PrintMatrix(matrix);
+
+    const CoreClusters clusters = DetectClusters(matrix);
+    if (clusters.levels.empty()) {
+        std::printf("\nno latency tiers, all pairs within one tier\n");
+    }
+    for (const auto& level : clusters.levels) {
+        std::printf("\n%zu clusters at <= %.0f ns:", level.clusters.size(), level.threshold_ns);
+        for (const auto& cluster : level.clusters) {
+            std::printf(" {");
+            for (std::size_t i = 0; i < cluster.size(); ++i) {
+                std::printf(i == 0 ? "%d" : " %d", matrix.cpus[cluster[i]]);
+            }
+            std::printf("}");
+        }
+        std::printf("\n");
+    }
+
+    const std::vector<std::size_t> placement = SuggestPlacement(graph, matrix);
+    if (placement.empty()) {
+        std::printf("\n%zu stages do not fit %zu cpus\n", graph.stages.size(), cpus.size());
+        return 1;
+    }
+    std::printf("\nsuggested placement, weighted hand-off cost %.0f ns\n", PlacementCost(graph, matrix, placement));
+    for (std::size_t stage = 0; stage < graph.stages.size(); ++stage) {
+        std::printf("  %-16s cpu %d\n", graph.stages[stage].c_str(), matrix.cpus[placement[stage]]);
+    }
+    for (const auto& link : graph.links) {
+        std::printf("  %s -> %s  %.0f ns x %.2f\n", graph.stages[link.from].c_str(), graph.stages[link.to].c_str(),
+            matrix.Distance(placement[link.from], placement[link.to]), link.weight);
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+// CSV tick file ingestion throughput.
+//
+// Writes a synthetic vendor file (timestamp,instrument,side,price,quantity)
+// to /tmp, then parses it from the page cache with 1..N threads into a
+// counting sink. Reports GB/s overall and per thread; the target is at
+// least 1 GB/s per core.
+//
+// Usage: csv_ingest_bench [--mb N] [--threads N] [--cpu-base N]
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include "BenchUtil.hpp"
+#include "CsvIngest.hpp"
+#include "LoadGenerator.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+struct CountingSink {
+    std::uint64_t checksum = 0;
+
+    void operator()(const MarketEvent* records, std::size_t count) noexcept
+    {
+        // Touch every record so the parse cannot be optimized away
+        for (std::size_t i = 0; i < count; ++i) {
+            checksum += static_cast<std::uint64_t>(records[i].price) ^ records[i].quantity;
+        }
+    }
+};
+
+auto WriteSyntheticFile(const std::string& path, long long megabytes) -> bool
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::fputs("timestamp,instrument,side,price,quantity\n", file);
+    FastRng rng(1);
+    const auto target = static_cast<std::uint64_t>(megabytes) << 20;
+    std::uint64_t written = 0;
+    std::uint64_t timestamp = 1700000000000000000ULL;
+    char line[96];
+    while (written < target) {
+        timestamp += rng.NextBelow(5000);
+        const int length = std::snprintf(line, sizeof(line), "%llu,%u,%c,%u.%04u,%u\n",
+            static_cast<unsigned long long>(timestamp), rng.NextBelow(5000), rng.NextBelow(2) != 0 ? 'B' : 'S',
+            50 + rng.NextBelow(500), rng.NextBelow(10000), 1 + rng.NextBelow(1000));
+        std::fwrite(line, 1, static_cast<std::size_t>(length), file);
+        written += static_cast<std::uint64_t>(length);
+    }
+    return std::fclose(file) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const long long megabytes = hft::bench::ArgOr(argc, argv, "--mb", 256);
+    const auto max_threads = static_cast<unsigned>(hft::bench::ArgOr(argc, argv, "--threads", 4));
+    const auto cpu_base = static_cast<int>(hft::bench::ArgOr(argc, argv, "--cpu-base", -1));
+
+    const std::string path = "/tmp/hft_csv_bench_" + std::to_string(::getpid()) + ".csv";
+    if (!WriteSyntheticFile(path, megabytes)) {
+        std::printf("cannot write %s\n", path.c_str());
+        return 1;
+    }
+    CsvTickFile file;
+    const bool opened = file.Open(path.c_str());
+    ::unlink(path.c_str());
+    if (!opened) {
+        std::printf("cannot map %s\n", path.c_str());
+        return 1;
+    }
+    std::printf("csv ingest, %.0f MB file\n", static_cast<double>(file.Size()) / (1 << 20));
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        CsvConfig config;
+        config.threads = threads;
+        config.cpu_base = cpu_base;
+        // Warm the page cache and the mapping once, then measure
+        (void)IngestCsv(file, config, [](std::size_t) { return CountingSink {}; });
+        const auto start = std::chrono::steady_clock::now();
+        const CsvIngestStats stats = IngestCsv(file, config, [](std::size_t) { return CountingSink {}; });
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double gigabytes = static_cast<double>(stats.bytes) / 1e9;
+        std::printf("threads=%-3u records=%-10llu malformed=%-4llu %.2f GB/s total, %.2f GB/s per thread\n", threads,
+            static_cast<unsigned long long>(stats.records), static_cast<unsigned long long>(stats.malformed),
+            gigabytes / seconds, gigabytes / seconds / threads);
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+// Two phase L3 book rebuild from an ITCH 5.0 file with 1, 2, 4 and 8 threads.
+//
+// Phase one indexes every book message by stock locate with a parallel scan
+// of the mapped file, phase two replays each symbol into its own L3Book on
+// the worker pool, snapshotting every minute of exchange time. Without
+// --file a synthetic day over 8,000 symbols is generated in memory.
+// Scaling needs as many idle cores as threads.
+//
+// Usage: itch_rebuild_bench [--file PATH] [--messages N] [--symbols N] [--max-threads N]
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "BenchUtil.hpp"
+#include "ItchReplay.hpp"
+#include "LoadGenerator.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+auto Seconds(std::chrono::steady_clock::time_point start) -> double
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+auto PathArg(int argc, char** argv) -> const char*
+{
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--file") == 0) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Adds, executions, replaces and deletes spread over symbols, a few much busier
+ *
+ */
+auto SyntheticDay(std::uint16_t symbols, long long messages) -> ItchWriter
+{
+    ItchWriter writer;
+    FastRng rng(17);
+    std::vector<std::vector<std::uint64_t>> live(symbols + 1U);
+    std::uint64_t next_ref = 1;
+    for (std::uint16_t locate = 1; locate <= symbols; ++locate) {
+        writer.StockDirectory(locate, "S" + std::to_string(locate));
+    }
+    // 09:30 to 16:00
+    const std::uint64_t open = 34200ULL * 1000000000ULL;
+    const std::uint64_t step = 23400ULL * 1000000000ULL / static_cast<std::uint64_t>(messages > 0 ? messages : 1);
+    for (long long i = 0; i < messages; ++i) {
+        const auto locate = static_cast<std::uint16_t>(1 + (rng.NextBelow(4) == 0 ? rng.NextBelow(20) : rng.NextBelow(symbols)));
+        const std::uint64_t timestamp = open + static_cast<std::uint64_t>(i) * step;
+        auto& refs = live[locate];
+        const std::uint32_t choice = refs.size() < 20 ? 0 : rng.NextBelow(4);
+        if (choice == 0) {
+            const Side side = rng.NextBelow(2) == 0 ? Side::Buy : Side::Sell;
+            const std::uint32_t price = side == Side::Buy ? 500000 - rng.NextBelow(50) * 100 : 500100 + rng.NextBelow(50) * 100;
+            writer.AddOrder(locate, timestamp, next_ref, side, 100 * (1 + rng.NextBelow(10)), price);
+            refs.push_back(next_ref++);
+            continue;
+        }
+        const std::size_t slot = rng.NextBelow(static_cast<std::uint32_t>(refs.size()));
+        if (choice == 1) {
+            writer.Replace(locate, timestamp, refs[slot], next_ref, 100, 500000 - rng.NextBelow(50) * 100);
+            refs[slot] = next_ref++;
+            continue;
+        }
+        if (choice == 2) {
+            writer.Execute(locate, timestamp, refs[slot], 1000);
+        } else {
+            writer.Delete(locate, timestamp, refs[slot]);
+        }
+        refs[slot] = refs.back();
+        refs.pop_back();
+    }
+    return writer;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const long long messages = hft::bench::ArgOr(argc, argv, "--messages", 4000000);
+    const auto symbols = static_cast<std::uint16_t>(hft::bench::ArgOr(argc, argv, "--symbols", 8000));
+    const auto max_threads = static_cast<unsigned>(hft::bench::ArgOr(argc, argv, "--max-threads", 8));
+    const char* path = PathArg(argc, argv);
+
+    ItchFile file;
+    ItchWriter writer;
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+    if (path != nullptr) {
+        if (!file.Open(path)) {
+            std::printf("cannot open %s\n", path);
+            return 1;
+        }
+        data = file.Data();
+        size = file.Size();
+    } else {
+        writer = SyntheticDay(symbols, messages);
+        data = writer.Bytes().data();
+        size = writer.Bytes().size();
+    }
+    std::printf("itch rebuild, %.1f MB\n", static_cast<double>(size) / 1e6);
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        ItchConfig config;
+        config.threads = threads;
+        config.snapshot_interval_ns = 60ULL * 1000000000ULL;
+
+        ItchIndex index;
+        auto start = std::chrono::steady_clock::now();
+        const ItchStats scan = index.Build(data, size, config);
+        const double scan_seconds = Seconds(start);
+
+        std::vector<std::int64_t> checksums(threads, 0);
+        start = std::chrono::steady_clock::now();
+        const ItchStats replay = ReplayBooks(data, index, config, [&](unsigned worker) {
+            return [&checksums, worker](std::uint16_t, std::uint64_t, const L3Book& book) { checksums[worker] += book.BestBid().price; };
+        });
+        const double replay_seconds = Seconds(start);
+
+        std::printf("%u threads  scan %7.3f s (%6.0f MB/s)  replay %7.3f s (%6.2f M msg/s)  %zu symbols  %llu snapshots  %llu rejected  %llu rescans\n",
+            threads, scan_seconds, static_cast<double>(size) / 1e6 / scan_seconds, replay_seconds,
+            static_cast<double>(replay.book_messages) / 1e6 / replay_seconds, index.ActiveLocates().size(),
+            static_cast<unsigned long long>(replay.snapshots), static_cast<unsigned long long>(replay.rejected),
+            static_cast<unsigned long long>(scan.rescanned_chunks));
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Kill switch reaction time.
+//
+// A gateway thread spins on an (empty) order ring with the kill switch
+// armed and mass cancel templates for every instrument pre-encoded. The
+// calling thread trips the switch; the transport stamps when the first
+// cancel reaches the wire. Measured for an in-process trip and for a trip
+// through a second mapping of the shared memory switch, as an operator
+// tool in another process would do it.
+//
+// Usage: kill_switch_bench [--trials N] [--instruments N] [--cpu-base N]
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "Affinity.hpp"
+#include "BenchUtil.hpp"
+#include "Gateway.hpp"
+#include "KillSwitch.hpp"
+#include "SPSC.hpp"
+#include "Tsc.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+using OrderRing = SPSCRingBuffer<EncodedOrder, 4096>;
+
+struct Options {
+    long long trials = 2000;
+    long long instruments = 64;
+    int cpu_base = -1;
+};
+
+/**
+ * @brief Transport that stamps the first send after each trip
+ *
+ */
+struct StampingTransport {
+    std::atomic<std::uint64_t> first_send { 0 };
+    std::atomic<std::uint64_t> sends { 0 };
+
+    void Send(const EncodedOrder& /*order*/) noexcept
+    {
+        if (first_send.load(std::memory_order_relaxed) == 0) {
+            first_send.store(ReadTsc(), std::memory_order_release);
+        }
+        sends.store(sends.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+void Pin(const Options& options, int offset)
+{
+    if (options.cpu_base >= 0) {
+        (void)PinThisThread(options.cpu_base + offset);
+    }
+}
+
+auto Run(KillSwitch& watched, KillSwitch& tripped, const Options& options) -> std::vector<double>
+{
+    const auto burst = static_cast<std::uint64_t>(options.instruments);
+    std::vector<EncodedOrder> templates(static_cast<std::size_t>(options.instruments));
+    for (std::size_t i = 0; i < templates.size(); ++i) {
+        OrderEncoder::EncodeMassCancel(static_cast<std::uint32_t>(i), templates[i]);
+    }
+    StampingTransport transport;
+    Gateway<StampingTransport> gateway(transport);
+    gateway.ArmKillSwitch(&watched, std::move(templates));
+    OrderRing orders;
+
+    std::atomic<bool> stop { false };
+    std::thread gateway_thread([&] {
+        Pin(options, 1);
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (gateway.Poll(orders) == 0) {
+                CpuRelax();
+            }
+        }
+    });
+
+    Pin(options, 0);
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(options.trials));
+    const double ticks_per_ns = TscPerNanosecond();
+    const auto settle = static_cast<std::uint64_t>(20000 * ticks_per_ns);
+    for (long long i = 0; i < options.trials; ++i) {
+        transport.first_send.store(0, std::memory_order_relaxed);
+        tripped.Reset();
+        // Let the gateway go back to its untripped loop before the next trip
+        const std::uint64_t until = ReadTsc() + settle;
+        while (ReadTsc() < until) {
+            CpuRelax();
+        }
+        tripped.Trip(KillReason::Manual);
+        std::uint64_t sent_at = 0;
+        while ((sent_at = transport.first_send.load(std::memory_order_acquire)) == 0) {
+            CpuRelax();
+        }
+        latencies.push_back(static_cast<double>(sent_at - tripped.TripTimestamp()) / ticks_per_ns);
+        // The rest of the burst must be out before first_send is cleared,
+        // or a late cancel stamps a time from before the next trip
+        const auto expected = static_cast<std::uint64_t>(i + 1) * burst;
+        while (transport.sends.load(std::memory_order_acquire) < expected) {
+            CpuRelax();
+        }
+    }
+    stop.store(true, std::memory_order_relaxed);
+    gateway_thread.join();
+    return latencies;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    options.trials = hft::bench::ArgOr(argc, argv, "--trials", options.trials);
+    options.instruments = hft::bench::ArgOr(argc, argv, "--instruments", options.instruments);
+    options.cpu_base = static_cast<int>(hft::bench::ArgOr(argc, argv, "--cpu-base", options.cpu_base));
+
+    std::printf("kill switch trip -> first cancel on the wire, %lld trials, %lld cancel templates\n", options.trials, options.instruments);
+    (void)TscPerNanosecond();
+
+    KillSwitch local;
+    auto in_process = Run(local, local, options);
+    hft::bench::PrintDistribution("in-process trip", in_process);
+
+    const std::string name = "/hft_kill_bench_" + std::to_string(::getpid());
+    SharedKillSwitch watched;
+    SharedKillSwitch operator_tool;
+    if (!watched.Open(name.c_str()) || !operator_tool.Open(name.c_str())) {
+        std::printf("shared memory kill switch unavailable\n");
+        return 1;
+    }
+    SharedKillSwitch::Unlink(name.c_str());
+    auto shared = Run(watched.Get(), operator_tool.Get(), options);
+    hft::bench::PrintDistribution("shared memory trip", shared);
+    return 0;
+}
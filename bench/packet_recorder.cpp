@@ -0,0 +1,74 @@
+// Capture side cost of the pcapng recorder.
+//
+// The calling thread captures fixed size datagrams as fast as it can while
+// a recorder thread drains the ring into a pcapng file in /tmp. Reports
+// the per packet cost of Capture() and the sustained recording rate.
+//
+// Usage: packet_recorder_bench [--packets N] [--size N] [--cpu-base N]
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "Affinity.hpp"
+#include "BenchUtil.hpp"
+#include "PacketRecorder.hpp"
+#include "Tsc.hpp"
+
+using namespace hft::core;
+
+int main(int argc, char** argv)
+{
+    const long long packets = hft::bench::ArgOr(argc, argv, "--packets", 2000000);
+    const auto size = static_cast<std::size_t>(hft::bench::ArgOr(argc, argv, "--size", 128));
+    const int cpu_base = static_cast<int>(hft::bench::ArgOr(argc, argv, "--cpu-base", -1));
+
+    const std::string path = "/tmp/hft_recorder_bench_" + std::to_string(::getpid()) + ".pcapng";
+    auto recorder = std::make_unique<PacketRecorder<>>();
+    if (!recorder->Open(path.c_str())) {
+        std::printf("cannot open %s\n", path.c_str());
+        return 1;
+    }
+
+    std::atomic<bool> stop { false };
+    std::thread writer([&] {
+        if (cpu_base >= 0) {
+            (void)PinThisThread(cpu_base + 1);
+        }
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (recorder->Poll() == 0) {
+                CpuRelax();
+            }
+        }
+    });
+    if (cpu_base >= 0) {
+        (void)PinThisThread(cpu_base);
+    }
+
+    std::vector<std::uint8_t> datagram(size, 0xAB);
+    std::vector<double> samples;
+    samples.reserve(static_cast<std::size_t>(packets));
+    const double ticks_per_ns = TscPerNanosecond();
+    std::uint64_t dropped = 0;
+    const std::uint64_t begin = ReadTsc();
+    for (long long i = 0; i < packets; ++i) {
+        const std::uint64_t start = ReadTsc();
+        if (!recorder->Capture(static_cast<std::uint64_t>(i), datagram.data(), datagram.size())) {
+            ++dropped;
+        }
+        samples.push_back(static_cast<double>(ReadTsc() - start) / ticks_per_ns);
+    }
+    const double capture_seconds = static_cast<double>(ReadTsc() - begin) / ticks_per_ns / 1e9;
+    stop.store(true, std::memory_order_relaxed);
+    writer.join();
+    recorder->Close();
+    ::unlink(path.c_str());
+
+    std::printf("pcapng recorder, %lld packets of %zu bytes, %llu dropped (ring full), %.2f Mpps offered\n", packets, size,
+        static_cast<unsigned long long>(dropped), static_cast<double>(packets) / capture_seconds / 1e6);
+    hft::bench::PrintDistribution("Capture()", samples);
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Book building throughput with 1, 2, 4 and 8 builder threads.
+//
+// The main thread plays the partitioner: it dispatches a pregenerated feed
+// over 5,000 instruments, with a few hot symbols taking a large share as at
+// the open, and calls RebalanceHot() periodically. Throughput is events
+// from the first dispatch until every builder has drained its ring. Each
+// builder needs its own core; on fewer cores the numbers measure the
+// scheduler, not the partitioning.
+//
+// Usage: partitioned_books_bench [--events N] [--instruments N] [--rebalance-every N] [--cpu-base N]
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Affinity.hpp"
+#include "BenchUtil.hpp"
+#include "LoadGenerator.hpp"
+#include "PartitionedBooks.hpp"
+#include "Tsc.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+using Builder = PartitionedBookBuilder<8, 65536>;
+
+constexpr std::uint32_t kHotSymbols = 8;
+
+auto MakeFeed(std::uint32_t instruments, long long count) -> std::vector<MarketEvent>
+{
+    FastRng rng(3);
+    std::vector<MarketEvent> events(static_cast<std::size_t>(count));
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        MarketEvent& event = events[i];
+        // Half the flow on a handful of symbols
+        event.instrument = rng.NextBelow(2) == 0 ? rng.NextBelow(kHotSymbols) : rng.NextBelow(instruments);
+        event.side = rng.NextBelow(2) == 0 ? Side::Buy : Side::Sell;
+        event.price = event.side == Side::Buy ? 10000 - rng.NextBelow(10) : 10001 + rng.NextBelow(10);
+        event.quantity = rng.NextBelow(100);
+        event.action = BookAction::Modify;
+        event.sequence = i;
+    }
+    return events;
+}
+
+auto Run(const std::vector<MarketEvent>& events, std::uint32_t instruments, std::uint32_t partitions, long long rebalance_every, int cpu_base) -> double
+{
+    auto builder = std::make_unique<Builder>(instruments, partitions);
+    std::atomic<bool> done { false };
+    std::vector<std::thread> workers;
+    for (std::uint32_t p = 0; p < partitions; ++p) {
+        workers.emplace_back([&, p] {
+            if (cpu_base >= 0) {
+                (void)PinThisThread(cpu_base + 1 + static_cast<int>(p));
+            }
+            while (!done.load(std::memory_order_relaxed)) {
+                if (builder->Poll(p, 256) == 0) {
+                    CpuRelax();
+                }
+            }
+        });
+    }
+
+    const std::uint64_t start = ReadTsc();
+    long long since_rebalance = 0;
+    for (const MarketEvent& event : events) {
+        while (!builder->Dispatch(event)) {
+            CpuRelax();
+        }
+        if (rebalance_every > 0 && ++since_rebalance == rebalance_every) {
+            since_rebalance = 0;
+            (void)builder->RebalanceHot();
+        }
+    }
+    while (!builder->Drained()) {
+        CpuRelax();
+    }
+    const std::uint64_t ticks = ReadTsc() - start;
+    done.store(true, std::memory_order_relaxed);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    const double seconds = static_cast<double>(ticks) / TscPerNanosecond() / 1e9;
+    const double rate = static_cast<double>(events.size()) / seconds;
+    std::printf("%u builders   %8.2f M events/s   %llu moves\n", partitions, rate / 1e6,
+        static_cast<unsigned long long>(builder->GetMoveCount()));
+    return rate;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const long long event_count = hft::bench::ArgOr(argc, argv, "--events", 4000000);
+    const auto instruments = static_cast<std::uint32_t>(hft::bench::ArgOr(argc, argv, "--instruments", 5000));
+    const long long rebalance_every = hft::bench::ArgOr(argc, argv, "--rebalance-every", 65536);
+    const int cpu_base = static_cast<int>(hft::bench::ArgOr(argc, argv, "--cpu-base", -1));
+    std::printf("partitioned book building, %lld events over %u instruments, %u cores available\n", event_count, instruments,
+        std::thread::hardware_concurrency());
+    if (cpu_base >= 0) {
+        (void)PinThisThread(cpu_base);
+    }
+    (void)TscPerNanosecond();
+
+    const std::vector<MarketEvent> events = MakeFeed(instruments, event_count);
+    const double single = Run(events, instruments, 1, rebalance_every, cpu_base);
+    for (const std::uint32_t partitions : { 2U, 4U, 8U }) {
+        const double rate = Run(events, instruments, partitions, rebalance_every, cpu_base);
+        std::printf("             speedup %.2fx of %u\n", rate / single, partitions);
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Quote update throughput of QuoteEngine on one core.
+//
+// 5,000 instruments each hold a few levels per side. A pregenerated stream
+// of level updates near the touch is applied in bursts; every top of book
+// change goes through QuoteEngine::OnBook and each burst ends with one
+// Flush into the gateway ring. The ring is drained between bursts outside
+// the timed region, as the gateway thread would.
+//
+// Usage: quote_engine_bench [--instruments N] [--events N] [--burst N] [--threshold N]
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "BenchUtil.hpp"
+#include "LoadGenerator.hpp"
+#include "OrderBook.hpp"
+#include "QuoteEngine.hpp"
+#include "SPSC.hpp"
+#include "Tsc.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+constexpr std::int64_t kBasePrice = 10000;
+constexpr std::int64_t kHalfBook = 5; // bids at base - 1 .. base - 5, asks at base + 1 .. base + 5
+
+using OrderRing = SPSCRingBuffer<EncodedOrder, 1 << 15>;
+
+auto MakeEvents(std::uint32_t instruments, long long count, FastRng& rng) -> std::vector<MarketEvent>
+{
+    std::vector<MarketEvent> events(static_cast<std::size_t>(count));
+    for (MarketEvent& event : events) {
+        event.instrument = rng.NextBelow(instruments);
+        event.side = rng.NextBelow(2) == 0 ? Side::Buy : Side::Sell;
+        const std::int64_t offset = 1 + static_cast<std::int64_t>(rng.NextBelow(3));
+        event.price = event.side == Side::Buy ? kBasePrice - offset : kBasePrice + offset;
+        event.quantity = 1 + rng.NextBelow(100);
+        event.action = BookAction::Modify;
+    }
+    return events;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const auto instruments = static_cast<std::uint32_t>(hft::bench::ArgOr(argc, argv, "--instruments", 5000));
+    const long long event_count = hft::bench::ArgOr(argc, argv, "--events", 5000000);
+    const auto burst = static_cast<std::size_t>(hft::bench::ArgOr(argc, argv, "--burst", 64));
+    const std::int64_t threshold = hft::bench::ArgOr(argc, argv, "--threshold", 1);
+    std::printf("quote engine, %u instruments, %lld book updates in bursts of %zu, requote threshold %lld\n", instruments,
+        event_count, burst, static_cast<long long>(threshold));
+
+    FastRng rng(7);
+    std::vector<OrderBook<>> books(instruments);
+    QuoteEngine engine(instruments, 0.5);
+    QuoteParams params;
+    params.half_spread = 2;
+    params.requote_threshold = threshold;
+    params.quantity = 10;
+    for (std::uint32_t instrument = 0; instrument < instruments; ++instrument) {
+        engine.SetParams(instrument, params);
+        for (std::int64_t offset = 1; offset <= kHalfBook; ++offset) {
+            MarketEvent event;
+            event.instrument = instrument;
+            event.quantity = 50;
+            event.side = Side::Buy;
+            event.price = kBasePrice - offset;
+            books[instrument].Apply(event);
+            event.side = Side::Sell;
+            event.price = kBasePrice + offset;
+            books[instrument].Apply(event);
+        }
+    }
+    const std::vector<MarketEvent> events = MakeEvents(instruments, event_count, rng);
+    auto ring = std::make_unique<OrderRing>();
+
+    const double ticks_per_ns = TscPerNanosecond();
+    std::vector<double> per_update;
+    per_update.reserve(events.size() / burst + 1);
+    std::uint64_t busy_ticks = 0;
+    std::uint64_t top_changes = 0;
+    EncodedOrder drained;
+    for (std::size_t start = 0; start < events.size(); start += burst) {
+        const std::size_t end = start + burst < events.size() ? start + burst : events.size();
+        const std::uint64_t begin = ReadTsc();
+        for (std::size_t i = start; i < end; ++i) {
+            const MarketEvent& event = events[i];
+            OrderBook<>& book = books[event.instrument];
+            if (book.Apply(event)) {
+                ++top_changes;
+                (void)engine.OnBook(event, book);
+            }
+        }
+        (void)engine.Flush(*ring);
+        const std::uint64_t ticks = ReadTsc() - begin;
+        busy_ticks += ticks;
+        per_update.push_back(static_cast<double>(ticks) / ticks_per_ns / static_cast<double>(end - start));
+        while (ring->Pop(drained)) {
+        }
+    }
+
+    const double seconds = static_cast<double>(busy_ticks) / ticks_per_ns / 1e9;
+    hft::bench::PrintDistribution("ns per update", per_update);
+    std::printf("%.2f M book updates/s, %.2f M top of book changes/s, %.2f M quote orders/s\n",
+        static_cast<double>(events.size()) / seconds / 1e6, static_cast<double>(top_changes) / seconds / 1e6,
+        static_cast<double>(engine.GetSentCount()) / seconds / 1e6);
+    std::printf("requotes suppressed by threshold: %llu of %llu top changes, ring drops %llu\n",
+        static_cast<unsigned long long>(engine.GetSuppressedCount()), static_cast<unsigned long long>(top_changes),
+        static_cast<unsigned long long>(engine.GetDropCount()));
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Key search over the occupied region of a ring, AVX2 gather vs scalar.
+//
+// A full, wrapped SPSCRingBuffer of MarketEvent (32 bit instrument key) and
+// a RingBuffer of OrderRequest (64 bit order id key) are searched for keys
+// that are absent, so both scans walk the whole region.
+//
+// Usage: ring_search_bench [--searches N]
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "BenchUtil.hpp"
+#include "MarketData.hpp"
+#include "Order.hpp"
+#include "RingBuffer.hpp"
+#include "RingSearch.hpp"
+#include "SPSC.hpp"
+#include "Tsc.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+constexpr std::size_t kCapacity = 4096;
+
+/**
+ * @brief Fill ring until full, after moving head half way so the region wraps
+ *
+ */
+template <typename Ring, typename T, typename Fill>
+void FillWrapped(Ring& ring, T value, Fill fill)
+{
+    for (std::size_t i = 0; i < kCapacity / 2; ++i) {
+        (void)ring.Push(value);
+    }
+    T out;
+    while (ring.Pop(out)) {
+    }
+    for (std::uint32_t i = 0;; ++i) {
+        fill(value, i);
+        if (!ring.Push(value)) {
+            break;
+        }
+    }
+}
+
+template <typename Search>
+auto Measure(long long searches, Search search) -> std::vector<double>
+{
+    std::vector<double> samples;
+    samples.reserve(static_cast<std::size_t>(searches));
+    const double ticks_per_ns = TscPerNanosecond();
+    std::size_t sink = 0;
+    for (long long i = 0; i < searches; ++i) {
+        const std::uint64_t start = ReadTsc();
+        sink += search();
+        samples.push_back(static_cast<double>(ReadTsc() - start) / ticks_per_ns);
+    }
+    if (sink != 0) {
+        std::printf("unexpected matches: %zu\n", sink);
+    }
+    return samples;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const long long searches = hft::bench::ArgOr(argc, argv, "--searches", 20000);
+    std::printf("ring search over %zu wrapped slots, %lld searches per case\n", kCapacity - 1, searches);
+    (void)TscPerNanosecond();
+
+    std::size_t hits[16];
+
+    auto events = std::make_unique<SPSCRingBuffer<MarketEvent, kCapacity>>();
+    FillWrapped(*events, MarketEvent {}, [](MarketEvent& event, std::uint32_t i) { event.instrument = i % 1000; });
+    const auto event_segments = events->Segments();
+    auto scalar32 = Measure(searches, [&] { return FindAllScalar<&MarketEvent::instrument>(event_segments, 5000U, hits, 16); });
+    hft::bench::PrintDistribution("u32 instrument scalar", scalar32);
+    auto simd32 = Measure(searches, [&] { return FindAll<&MarketEvent::instrument>(event_segments, 5000U, hits, 16); });
+    hft::bench::PrintDistribution("u32 instrument simd", simd32);
+
+    auto orders = std::make_unique<RingBuffer<OrderRequest, kCapacity, OverflowPolicy::Reject, ThreadModel::SPSC>>();
+    FillWrapped(*orders, OrderRequest {}, [](OrderRequest& order, std::uint32_t i) { order.order_id = i + 1; });
+    const auto order_segments = orders->Segments();
+    auto scalar64 = Measure(searches, [&] { return FindAllScalar<&OrderRequest::order_id>(order_segments, 0U, hits, 16); });
+    hft::bench::PrintDistribution("u64 order id scalar", scalar64);
+    auto simd64 = Measure(searches, [&] { return FindAll<&OrderRequest::order_id>(order_segments, 0U, hits, 16); });
+    hft::bench::PrintDistribution("u64 order id simd", simd64);
+    return 0;
+}
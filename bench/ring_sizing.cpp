@@ -0,0 +1,76 @@
+// Capacity recommendation for the feed to book builder ring under bursty load.
+//
+// A LoadGenerator paces Hawkes arrivals (bursts as at the open) into a
+// RecordedRing; a builder thread drains it into a BookBuilder. At the end
+// the recorded occupancy gives the worst backlog and the smallest
+// power-of-two capacity that would have absorbed it with 25% margin. Swap
+// the arrival model for ReplayArrivals to size from a recorded session.
+// With both threads on one core the backlog includes scheduler slices.
+//
+// Usage: ring_sizing_bench [--events N] [--rate N] [--bucket-ns N] [--cpu-base N]
+
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include "Affinity.hpp"
+#include "BenchUtil.hpp"
+#include "LoadGenerator.hpp"
+#include "OrderBook.hpp"
+#include "RingSizing.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+constexpr std::size_t kCapacity = 65536;
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const auto events = static_cast<std::uint64_t>(hft::bench::ArgOr(argc, argv, "--events", 2000000));
+    const auto rate = static_cast<double>(hft::bench::ArgOr(argc, argv, "--rate", 2000000));
+    const auto bucket_ns = static_cast<double>(hft::bench::ArgOr(argc, argv, "--bucket-ns", 1000));
+    const int cpu_base = static_cast<int>(hft::bench::ArgOr(argc, argv, "--cpu-base", -1));
+    std::printf("ring sizing, %llu Hawkes events at %.1f M/s, %.0f ns buckets\n", static_cast<unsigned long long>(events), rate / 1e6,
+        bucket_ns);
+
+    (void)TscPerNanosecond();
+    // Session length with a 2x allowance for generator lateness
+    const auto buckets = static_cast<std::size_t>(2.0 * static_cast<double>(events) / rate * 1e9 / bucket_ns) + 1;
+    auto ring = std::make_unique<RecordedRing<MarketEvent, kCapacity>>(bucket_ns, buckets);
+    auto books = std::make_unique<BookBuilder<8>>(1024);
+    std::atomic<bool> done { false };
+
+    std::thread builder([&] {
+        if (cpu_base >= 0) {
+            (void)PinThisThread(cpu_base + 1);
+        }
+        MarketEvent event;
+        while (true) {
+            if (ring->Pop(event)) {
+                (void)books->Apply(event);
+            } else if (done.load(std::memory_order_acquire)) {
+                if (ring->Empty()) {
+                    break;
+                }
+            } else {
+                CpuRelax();
+            }
+        }
+    });
+
+    LoadGeneratorConfig config;
+    config.cpu = cpu_base;
+    LoadGenerator<HawkesArrivals> generator(HawkesArrivals(rate, 0.8, 2000.0), config);
+    const GeneratorStats stats = generator.Run(*ring, events);
+    done.store(true, std::memory_order_release);
+    builder.join();
+
+    std::printf("emitted %llu, dropped %llu, max lateness %.0f us\n", static_cast<unsigned long long>(stats.emitted),
+        static_cast<unsigned long long>(stats.dropped), static_cast<double>(stats.max_lateness) / TscPerNanosecond() / 1000.0);
+    Print(std::cout, "feed->builder", ring->Analyze());
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Routing decision latency of SmartOrderRouter across 16 venues.
+//
+// Every venue shows a random top of book for every instrument, venues have
+// random fees and latency estimates. Each sample routes one marketable
+// parent order, so all 16 seqlock snapshots are read and ranked and the
+// parent is split into child orders (about two at the default quantity,
+// venues display 1-100); the venue rings are drained outside the timed region.
+//
+// Usage: smart_router_bench [--routes N] [--instruments N] [--quantity N]
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "BenchUtil.hpp"
+#include "LoadGenerator.hpp"
+#include "SmartOrderRouter.hpp"
+#include "Tsc.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+constexpr std::uint32_t kVenues = 16;
+constexpr double kTargetNs = 500.0;
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const long long routes = hft::bench::ArgOr(argc, argv, "--routes", 200000);
+    const auto instruments = static_cast<std::uint32_t>(hft::bench::ArgOr(argc, argv, "--instruments", 1000));
+    const auto quantity = static_cast<std::uint32_t>(hft::bench::ArgOr(argc, argv, "--quantity", 100));
+    std::printf("smart order router, %u venues, %u instruments, %lld routes of %u\n", kVenues, instruments, routes, quantity);
+
+    FastRng rng(42);
+    ConsolidatedBook<kVenues> book(instruments);
+    for (std::uint32_t instrument = 0; instrument < instruments; ++instrument) {
+        for (std::uint32_t venue = 0; venue < kVenues; ++venue) {
+            VenueQuote quote;
+            quote.bid_price = 10000 - static_cast<std::int64_t>(rng.NextBelow(10));
+            quote.ask_price = 10001 + static_cast<std::int64_t>(rng.NextBelow(10));
+            quote.bid_quantity = 1 + rng.NextBelow(100);
+            quote.ask_quantity = 1 + rng.NextBelow(100);
+            book.Update(venue, instrument, quote);
+        }
+    }
+
+    RouterConfig config;
+    config.latency_cost_per_us = 1;
+    auto router = std::make_unique<SmartOrderRouter<kVenues>>(book, kVenues, config);
+    for (std::uint32_t venue = 0; venue < kVenues; ++venue) {
+        router->SetVenue(venue, VenueProfile { static_cast<std::int64_t>(rng.NextBelow(5)) - 2, 2000 + rng.NextBelow(20000), true });
+    }
+
+    const double ticks_per_ns = TscPerNanosecond();
+    std::vector<double> samples;
+    samples.reserve(static_cast<std::size_t>(routes));
+    SmartOrderRouter<kVenues>::Result result;
+    std::uint64_t children = 0;
+    EncodedOrder drained;
+    for (long long i = 0; i < routes; ++i) {
+        OrderRequest parent;
+        parent.order_id = static_cast<std::uint64_t>(i);
+        parent.instrument = rng.NextBelow(instruments);
+        parent.side = (i & 1) != 0 ? Side::Buy : Side::Sell;
+        parent.price = parent.side == Side::Buy ? 10020 : 9980;
+        parent.quantity = quantity;
+
+        const std::uint64_t start = ReadTsc();
+        router->Route(parent, result);
+        samples.push_back(static_cast<double>(ReadTsc() - start) / ticks_per_ns);
+
+        children += result.child_count;
+        for (std::uint32_t c = 0; c < result.child_count; ++c) {
+            (void)router->Ring(result.children[c].venue).Pop(drained);
+        }
+    }
+
+    hft::bench::PrintDistribution("route (ns)", samples);
+    std::printf("children per parent %.2f, ring drops %llu\n", static_cast<double>(children) / static_cast<double>(routes),
+        static_cast<unsigned long long>(router->GetDropCount()));
+    std::sort(samples.begin(), samples.end());
+    const double p50 = samples[samples.size() / 2];
+    std::printf("p50 %.1f ns vs %.0f ns target: %s\n", p50, kTargetNs, p50 < kTargetNs ? "met" : "missed");
+    return 0;
+}
@@ -0,0 +1,200 @@
+// Tick-to-trade latency of the trading pipeline.
+//
+// A probe packet stamped with the TSC is injected at the feed source and
+// travels feed handler -> book -> strategy -> risk -> order encoding ->
+// gateway, where the transport stamps the encoded order bytes. Measured
+// with no background traffic, steady Poisson traffic and Hawkes bursts.
+//
+// Usage: tick_to_trade_bench [--probes N] [--interval-ns N] [--rate N] [--cpu-base N]
+
+#include <atomic>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Affinity.hpp"
+#include "BenchUtil.hpp"
+#include "FeedHandler.hpp"
+#include "Gateway.hpp"
+#include "LoadGenerator.hpp"
+#include "SPSC.hpp"
+#include "TradingEngine.hpp"
+#include "Tsc.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+constexpr std::uint32_t kBackgroundInstruments = 1024;
+constexpr std::uint32_t kProbeInstrument = kBackgroundInstruments;
+constexpr std::int64_t kProbePrice = 50000;
+
+using PacketRing = SPSCRingBuffer<FeedPacket, 65536>;
+using EventRing = SPSCRingBuffer<MarketEvent, 65536>;
+using OrderRing = SPSCRingBuffer<EncodedOrder, 4096>;
+
+enum class Load {
+    Idle,
+    Steady,
+    Burst
+};
+
+struct Options {
+    long long probes = 20000;
+    long long interval_ns = 5000;
+    double rate = 2e6;
+    int cpu_base = -1;
+};
+
+/**
+ * @brief Transport that stamps the time the order bytes reach the wire
+ *
+ */
+struct StampingTransport {
+    std::vector<std::uint64_t> ticks;
+    std::atomic<std::uint64_t> received { 0 };
+
+    void Send(const EncodedOrder& order) noexcept
+    {
+        const std::uint64_t now = ReadTsc();
+        if (ticks.size() < ticks.capacity()) {
+            ticks.push_back(now - order.origin_timestamp);
+        }
+        received.store(received.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+void Pin(const Options& options, int offset)
+{
+    if (options.cpu_base >= 0) {
+        (void)PinThisThread(options.cpu_base + offset);
+    }
+}
+
+auto RunScenario(Load load, const Options& options) -> std::vector<double>
+{
+    auto background = std::make_unique<PacketRing>();
+    auto probes = std::make_unique<PacketRing>();
+    auto events = std::make_unique<EventRing>();
+    auto orders = std::make_unique<OrderRing>();
+
+    RiskLimits limits;
+    limits.max_position = options.probes + 1;
+    TradingEngine<> engine(kBackgroundInstruments + 1, limits);
+    TakerThreshold threshold;
+    threshold.buy_at_or_below = kProbePrice;
+    engine.Strategy().SetThreshold(kProbeInstrument, threshold);
+
+    StampingTransport transport;
+    transport.ticks.reserve(static_cast<std::size_t>(options.probes));
+    Gateway<StampingTransport> gateway(transport);
+    FeedHandler feed;
+
+    std::atomic<bool> stop { false };
+    std::vector<std::thread> threads;
+
+    threads.emplace_back([&] {
+        Pin(options, 1);
+        while (!stop.load(std::memory_order_relaxed)) {
+            // Probe line first, it is the one being measured
+            if (feed.Poll(*probes, *events) + feed.Poll(*background, *events) == 0) {
+                CpuRelax();
+            }
+        }
+    });
+    threads.emplace_back([&] {
+        Pin(options, 2);
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (engine.Poll(*events, *orders) == 0) {
+                CpuRelax();
+            }
+        }
+    });
+    threads.emplace_back([&] {
+        Pin(options, 3);
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (gateway.Poll(*orders) == 0) {
+                CpuRelax();
+            }
+        }
+    });
+    if (load != Load::Idle) {
+        threads.emplace_back([&] {
+            LoadGeneratorConfig config;
+            config.instruments = kBackgroundInstruments;
+            config.cpu = options.cpu_base >= 0 ? options.cpu_base + 4 : -1;
+            PacketEncodingRing<PacketRing> line(*background);
+            const auto count = std::numeric_limits<std::uint64_t>::max();
+            if (load == Load::Steady) {
+                LoadGenerator<PoissonArrivals>(PoissonArrivals(options.rate), config).Run(line, count, &stop);
+            } else {
+                LoadGenerator<HawkesArrivals>(HawkesArrivals(options.rate, 0.9, 1e7), config).Run(line, count, &stop);
+            }
+        });
+    }
+
+    // Probe injector on the calling thread
+    Pin(options, 0);
+    const auto interval = static_cast<std::uint64_t>(static_cast<double>(options.interval_ns) * TscPerNanosecond());
+    std::uint64_t next = ReadTsc();
+    for (long long i = 0; i < options.probes; ++i) {
+        next += interval;
+        while (ReadTsc() < next) {
+            CpuRelax();
+        }
+        MarketEvent probe;
+        probe.sequence = static_cast<std::uint64_t>(i);
+        probe.instrument = kProbeInstrument;
+        probe.price = kProbePrice;
+        probe.quantity = 1;
+        probe.action = BookAction::Add;
+        probe.side = Side::Sell;
+        probe.timestamp = ReadTsc();
+        while (!probes->Push(EncodePacket(probe))) {
+            CpuRelax();
+        }
+    }
+
+    const std::uint64_t deadline = ReadTsc() + static_cast<std::uint64_t>(1e9 * TscPerNanosecond());
+    while (transport.received.load(std::memory_order_acquire) < static_cast<std::uint64_t>(options.probes) && ReadTsc() < deadline) {
+        std::this_thread::yield();
+    }
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(transport.ticks.size());
+    const double ticks_per_ns = TscPerNanosecond();
+    for (const std::uint64_t ticks : transport.ticks) {
+        latencies.push_back(static_cast<double>(ticks) / ticks_per_ns);
+    }
+    if (latencies.size() < static_cast<std::size_t>(options.probes)) {
+        std::printf("warning: %zu of %lld probes reached the gateway\n", latencies.size(), options.probes);
+    }
+    return latencies;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    options.probes = hft::bench::ArgOr(argc, argv, "--probes", options.probes);
+    options.interval_ns = hft::bench::ArgOr(argc, argv, "--interval-ns", options.interval_ns);
+    options.rate = static_cast<double>(hft::bench::ArgOr(argc, argv, "--rate", static_cast<long long>(options.rate)));
+    options.cpu_base = static_cast<int>(hft::bench::ArgOr(argc, argv, "--cpu-base", options.cpu_base));
+
+    std::printf("tick-to-trade, %lld probes every %lld ns, background %.0f events/s\n", options.probes, options.interval_ns, options.rate);
+    (void)TscPerNanosecond();
+
+    auto idle = RunScenario(Load::Idle, options);
+    hft::bench::PrintDistribution("idle", idle);
+    auto steady = RunScenario(Load::Steady, options);
+    hft::bench::PrintDistribution("steady (poisson)", steady);
+    auto burst = RunScenario(Load::Burst, options);
+    hft::bench::PrintDistribution("burst (hawkes)", burst);
+    return 0;
+}
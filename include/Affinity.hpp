@@ -0,0 +1,33 @@
+#pragma once
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace hft::core {
+
+/**
+ * @brief Pin the calling thread to one cpu
+ *
+ * @param cpu
+ * @return true
+ * @return false when the cpu is not available or the platform is not supported
+ */
+[[nodiscard]] inline auto PinThisThread(int cpu) noexcept -> bool
+{
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+} // namespace hft::core
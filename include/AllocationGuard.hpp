@@ -0,0 +1,155 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * HFT_HOT_PATH_SCOPE() marks the enclosing scope as a region that must not allocate.
+ *
+ * Compiled in only when HFT_ENABLE_ALLOC_GUARD is defined (cmake -DENABLE_ALLOC_GUARD=ON),
+ * otherwise the macro expands to nothing. Marking is header only; allocations
+ * are only seen in binaries linking the hft_alloc_guard library, which
+ * replaces operator new and malloc.
+ */
+#if defined(HFT_ENABLE_ALLOC_GUARD)
+#define HFT_ALLOC_CONCAT_IMPL(a, b) a##b
+#define HFT_ALLOC_CONCAT(a, b) HFT_ALLOC_CONCAT_IMPL(a, b)
+#define HFT_HOT_PATH_SCOPE() ::hft::alloc::HotPathScope HFT_ALLOC_CONCAT(hft_hot_path_scope_, __LINE__)
+#else
+#define HFT_HOT_PATH_SCOPE() static_cast<void>(0)
+#endif
+
+namespace hft::alloc {
+
+/**
+ * @brief What an allocation inside a hot path region does
+ *
+ */
+enum class Policy : int {
+    Count = 0, /// count it and keep its call stack
+    Abort = 1, /// print its call stack to stderr and abort
+};
+
+/**
+ * @brief One allocation seen inside a hot path region
+ *
+ */
+struct AllocationRecord {
+    static constexpr std::size_t kMaxFrames = 16;
+
+    std::size_t bytes = 0;
+    int frame_count = 0;
+    std::array<void*, kMaxFrames> frames {}; /// return addresses, innermost first
+};
+
+namespace detail {
+
+    inline constexpr std::size_t kMaxRecords = 64;
+
+    // Written by the owning thread, read by the hooks on that same thread
+    inline thread_local std::uint32_t hot_path_depth = 0;
+    inline thread_local std::uint64_t thread_allocations = 0;
+
+    inline std::atomic<std::uint64_t> allocations { 0 };
+#if defined(HFT_ALLOC_GUARD_ABORT)
+    inline std::atomic<Policy> policy { Policy::Abort };
+#else
+    inline std::atomic<Policy> policy { Policy::Count };
+#endif
+    inline std::atomic<bool> installed { false };
+
+    // The first kMaxRecords allocations, record_count keeps counting past them
+    inline std::array<AllocationRecord, kMaxRecords> records {};
+    inline std::atomic<std::size_t> record_count { 0 };
+
+} // namespace detail
+
+/**
+ * @brief Marks the current thread as on the hot path until destroyed, nests
+ *
+ * Cheap enough to leave in: two thread local updates and no calls.
+ */
+class HotPathScope {
+public:
+    HotPathScope() noexcept
+        : start_(detail::thread_allocations)
+    {
+        ++detail::hot_path_depth;
+    }
+
+    ~HotPathScope()
+    {
+        --detail::hot_path_depth;
+    }
+
+    HotPathScope(const HotPathScope&) = delete;
+    auto operator=(const HotPathScope&) -> HotPathScope& = delete;
+
+    /**
+     * @brief Allocations by this thread since the scope was entered
+     *
+     */
+    [[nodiscard]] auto Allocations() const noexcept -> std::uint64_t
+    {
+        return detail::thread_allocations - start_;
+    }
+
+private:
+    std::uint64_t start_;
+};
+
+/**
+ * @brief True when the binary links hft_alloc_guard and its hooks are active
+ *
+ * False in sanitizer builds and off glibc, where the hooks are compiled out
+ * and every count stays 0.
+ */
+[[nodiscard]] inline auto HooksInstalled() noexcept -> bool
+{
+    return detail::installed.load(std::memory_order_relaxed);
+}
+
+inline void SetPolicy(Policy policy) noexcept
+{
+    detail::policy.store(policy, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Allocations inside hot path regions of all threads
+ *
+ */
+[[nodiscard]] inline auto HotPathAllocations() noexcept -> std::uint64_t
+{
+    return detail::allocations.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Copy of the recorded allocations, cold path, call outside any hot path region
+ *
+ */
+inline auto Records() -> std::vector<AllocationRecord>
+{
+    const std::size_t count = detail::record_count.load(std::memory_order_acquire);
+    return { detail::records.begin(), detail::records.begin() + static_cast<std::ptrdiff_t>(count < detail::kMaxRecords ? count : detail::kMaxRecords) };
+}
+
+/**
+ * @brief Forget the recorded allocations and counts, while no hot path thread runs
+ *
+ */
+inline void Reset() noexcept
+{
+    detail::allocations.store(0, std::memory_order_relaxed);
+    detail::record_count.store(0, std::memory_order_release);
+}
+
+/**
+ * @brief Write the recorded call stacks to fd, symbolized when the binary has symbols
+ *
+ * Defined by hft_alloc_guard; link with -rdynamic for function names.
+ */
+void PrintRecords(int fd);
+
+} // namespace hft::alloc
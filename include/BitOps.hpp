@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace hft::core {
+
+/**
+ * @brief Index of the lowest set bit, tzcnt/bsf. Undefined for 0.
+ *
+ * @param value
+ * @return unsigned
+ */
+[[nodiscard]] inline auto CountTrailingZeros(std::uint64_t value) noexcept -> unsigned
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+/**
+ * @brief Number of bits needed to represent value, 0 for 0
+ *
+ * @param value
+ * @return unsigned
+ */
+[[nodiscard]] inline auto BitWidth(std::uint64_t value) noexcept -> unsigned
+{
+    if (value == 0) {
+        return 0;
+    }
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return static_cast<unsigned>(index) + 1;
+#else
+    return 64U - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+}
+
+} // namespace hft::core
@@ -0,0 +1,179 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace hft::core {
+
+/**
+ * @brief SPSC ring of variable length byte records
+ *
+ * Each record is an 8 byte header (payload size) followed by the payload,
+ * padded to 8 bytes; records never wrap, a padding marker fills the gap at
+ * the end of the buffer instead. The producer can write in place with
+ * Reserve/Commit, the consumer reads in place with Peek/Release, so a
+ * record is copied exactly once.
+ *
+ * @tparam Capacity bytes, power of two; one record holds at most Capacity / 2
+ */
+template <std::size_t Capacity>
+class ByteRingBuffer {
+    static_assert((Capacity >= 64) && ((Capacity & (Capacity - 1)) == 0), "Capacity must be a power of 2 and at least 64.");
+
+    static constexpr std::size_t Mask = Capacity - 1;
+    static constexpr std::uint64_t kPadding = ~std::uint64_t { 0 };
+
+public:
+    static constexpr std::size_t kHeaderSize = sizeof(std::uint64_t);
+    static constexpr std::size_t kMaxRecord = Capacity / 2 - kHeaderSize;
+
+    /**
+     * @brief Producer side, room for size payload bytes or nullptr when full
+     *
+     * The record becomes visible on Commit(); calling Reserve again before
+     * that discards the reservation.
+     */
+    [[nodiscard]] auto Reserve(std::size_t size) noexcept -> std::uint8_t*
+    {
+        if (size > kMaxRecord) [[unlikely]] {
+            drop_count.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        const std::uint64_t current_tail = tail.load(std::memory_order_relaxed);
+        const std::size_t offset = current_tail & Mask;
+        const std::size_t record = Align(kHeaderSize + size);
+        const std::size_t contiguous = Capacity - offset;
+        const std::size_t needed = record <= contiguous ? record : contiguous + record;
+
+        if (current_tail + needed - cached_head_ > Capacity) {
+            cached_head_ = head.load(std::memory_order_acquire);
+            if (current_tail + needed - cached_head_ > Capacity) [[unlikely]] {
+                drop_count.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+
+        std::size_t start = offset;
+        if (record > contiguous) {
+            WriteHeader(offset, kPadding);
+            start = 0;
+        }
+        WriteHeader(start, size);
+        pending_ = needed;
+        return buffer_.data() + start + kHeaderSize;
+    }
+
+    /**
+     * @brief Producer side, publish the last reservation
+     *
+     */
+    void Commit() noexcept
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + pending_, std::memory_order_release);
+        pending_ = 0;
+    }
+
+    /**
+     * @brief Producer side, copy data in as one record
+     *
+     */
+    [[nodiscard]] auto Push(const void* data, std::size_t size) noexcept -> bool
+    {
+        std::uint8_t* payload = Reserve(size);
+        if (payload == nullptr) {
+            return false;
+        }
+        std::memcpy(payload, data, size);
+        Commit();
+        return true;
+    }
+
+    /**
+     * @brief Consumer side, oldest record in place; valid until Release()
+     *
+     * @return true
+     * @return false when empty
+     */
+    [[nodiscard]] auto Peek(const std::uint8_t*& out_data, std::size_t& out_size) noexcept -> bool
+    {
+        std::uint64_t current_head = head.load(std::memory_order_relaxed);
+        if (current_head == cached_tail_) {
+            cached_tail_ = tail.load(std::memory_order_acquire);
+            if (current_head == cached_tail_) {
+                return false;
+            }
+        }
+        std::uint64_t size = ReadHeader(current_head & Mask);
+        if (size == kPadding) {
+            current_head += Capacity - (current_head & Mask);
+            head.store(current_head, std::memory_order_release);
+            size = ReadHeader(0);
+        }
+        out_data = buffer_.data() + (current_head & Mask) + kHeaderSize;
+        out_size = static_cast<std::size_t>(size);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side, free the record returned by the last Peek
+     *
+     */
+    void Release() noexcept
+    {
+        const std::uint64_t current_head = head.load(std::memory_order_relaxed);
+        const std::uint64_t size = ReadHeader(current_head & Mask);
+        head.store(current_head + Align(kHeaderSize + static_cast<std::size_t>(size)), std::memory_order_release);
+    }
+
+    [[nodiscard]] auto Empty() const noexcept -> bool
+    {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Bytes in use including headers and padding
+     *
+     */
+    [[nodiscard]] auto UsedBytes() const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed));
+    }
+
+    [[nodiscard]] auto GetDropCount() const noexcept -> std::size_t
+    {
+        return drop_count.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr auto Align(std::size_t size) noexcept -> std::size_t
+    {
+        return (size + 7) & ~std::size_t { 7 };
+    }
+
+    void WriteHeader(std::size_t offset, std::uint64_t value) noexcept
+    {
+        std::memcpy(buffer_.data() + offset, &value, sizeof(value));
+    }
+
+    [[nodiscard]] auto ReadHeader(std::size_t offset) const noexcept -> std::uint64_t
+    {
+        std::uint64_t value = 0;
+        std::memcpy(&value, buffer_.data() + offset, sizeof(value));
+        return value;
+    }
+
+    alignas(64) std::array<std::uint8_t, Capacity> buffer_ {};
+
+    // Free running byte positions, each side caches the other's to avoid cross core loads
+    alignas(64) std::atomic<std::uint64_t> tail { 0 }; // Producer controlled
+    std::uint64_t cached_head_ = 0;
+    std::size_t pending_ = 0;
+    alignas(64) std::atomic<std::uint64_t> head { 0 }; // Consumer controlled
+    std::uint64_t cached_tail_ = 0;
+
+    alignas(64) std::atomic<std::size_t> drop_count { 0 };
+};
+
+} // namespace hft::core
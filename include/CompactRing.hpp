@@ -0,0 +1,160 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include "ThreadModel.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Many small rings sharing one slab of storage
+ *
+ * Meant for one queue per instrument. Each ring only carries two packed
+ * 32 bit indices (8 bytes) next to each other, payload of ring i lives at
+ * slab[i * Capacity]. Indices run free and are masked on access, so all
+ * Capacity slots are usable.
+ *
+ * Head and tail of a ring share a cache line on purpose; compactness is
+ * preferred over false sharing protection here.
+ *
+ * @tparam T  parameter type
+ * @tparam Capacity  of every ring
+ * @tparam Model  SingleThread or SPSC (one producer and one consumer per ring)
+ */
+template <typename T, std::uint32_t Capacity, ThreadModel Model = ThreadModel::SPSC>
+class CompactRingPool {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
+    static_assert((Capacity != 0U) && ((Capacity & (Capacity - 1)) == 0), "Capacity must be a power of 2.");
+    static_assert(Model != ThreadModel::MPMC, "CompactRingPool supports SingleThread and SPSC only.");
+
+    static constexpr std::uint32_t Mask = Capacity - 1;
+
+    using Index = typename detail::ModelTraits<Model, std::uint32_t>::Index;
+
+    struct Header {
+        Index tail { 0 }; // Producer controlled
+        Index head { 0 }; // Consumer controlled
+    };
+
+public:
+    /**
+     * @brief Handle to a single ring of the pool, same API as the other rings
+     *
+     */
+    class Ring {
+    public:
+        [[nodiscard]] auto Push(const T& value) noexcept -> bool
+        {
+            const std::uint32_t curr_tail = header_->tail.load(std::memory_order_relaxed);
+            if (curr_tail - header_->head.load(std::memory_order_acquire) == Capacity) [[unlikely]] {
+                return false;
+            }
+            slots_[curr_tail & Mask] = value;
+            header_->tail.store(curr_tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        [[nodiscard]] auto Pop(T& out_value) noexcept -> bool
+        {
+            const std::uint32_t curr_head = header_->head.load(std::memory_order_relaxed);
+            if (curr_head == header_->tail.load(std::memory_order_acquire)) {
+                return false;
+            }
+            out_value = slots_[curr_head & Mask];
+            header_->head.store(curr_head + 1, std::memory_order_release);
+            return true;
+        }
+
+        auto Front() const noexcept -> T
+        {
+            assert(!Empty());
+            return slots_[header_->head.load(std::memory_order_relaxed) & Mask];
+        }
+
+        [[nodiscard]] auto Empty() const noexcept -> bool
+        {
+            return header_->head.load(std::memory_order_relaxed) == header_->tail.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] auto Size() const noexcept -> std::uint32_t
+        {
+            return header_->tail.load(std::memory_order_relaxed) - header_->head.load(std::memory_order_relaxed);
+        }
+
+    private:
+        friend class CompactRingPool;
+
+        Ring(Header* header, T* slots) noexcept
+            : header_(header)
+            , slots_(slots)
+        {
+        }
+
+        Header* header_;
+        T* slots_;
+    };
+
+    /**
+     * @brief Allocate headers and the payload slab once, up front
+     *
+     * @param ring_count number of rings, e.g. number of instruments
+     */
+    explicit CompactRingPool(std::uint32_t ring_count)
+        : ring_count_(ring_count)
+        , headers_(std::make_unique<Header[]>(ring_count))
+        , slab_(std::make_unique<T[]>(static_cast<std::size_t>(ring_count) * Capacity))
+    {
+    }
+
+    /**
+     * @brief Get the handle of ring id
+     *
+     * @param id
+     * @return Ring
+     */
+    [[nodiscard]] auto Get(std::uint32_t id) noexcept -> Ring
+    {
+        assert(id < ring_count_);
+        return Ring(&headers_[id], &slab_[static_cast<std::size_t>(id) * Capacity]);
+    }
+
+    [[nodiscard]] auto Push(std::uint32_t id, const T& value) noexcept -> bool
+    {
+        return Get(id).Push(value);
+    }
+
+    [[nodiscard]] auto Pop(std::uint32_t id, T& out_value) noexcept -> bool
+    {
+        return Get(id).Pop(out_value);
+    }
+
+    [[nodiscard]] auto Empty(std::uint32_t id) const noexcept -> bool
+    {
+        assert(id < ring_count_);
+        return headers_[id].head.load(std::memory_order_relaxed) == headers_[id].tail.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto RingCount() const noexcept -> std::uint32_t
+    {
+        return ring_count_;
+    }
+
+    /**
+     * @brief Bytes used by a single ring, header plus its share of the slab
+     *
+     * @return std::size_t
+     */
+    [[nodiscard]] static constexpr auto BytesPerRing() noexcept -> std::size_t
+    {
+        return sizeof(Header) + (sizeof(T) * Capacity);
+    }
+
+private:
+    std::uint32_t ring_count_;
+    // Headers are packed together so scans over all instruments stay in cache
+    std::unique_ptr<Header[]> headers_;
+    std::unique_ptr<T[]> slab_;
+};
+
+} // namespace hft::core
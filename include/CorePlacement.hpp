@@ -0,0 +1,443 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Affinity.hpp"
+#include "SPSC.hpp"
+#include "Tsc.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Median cache line round trip between two cpus, in ns
+ *
+ * A ping-pong over two SPSCRingBuffers: the thread on cpu_a pushes a
+ * token, the thread on cpu_b pops it and pushes it back. Every token moves
+ * the ring's slot and index lines across the two cores twice, which is
+ * what a pipeline hand-off between stages on those cores costs.
+ *
+ * @param cpu_a -1 leaves the thread floating
+ * @param cpu_b -1 leaves the thread floating
+ * @return double NaN when a cpu cannot be pinned
+ */
+inline auto MeasureRoundTrip(int cpu_a, int cpu_b, std::size_t round_trips = 2000) -> double
+{
+    struct Rings {
+        SPSCRingBuffer<std::uint64_t, 64> ping;
+        SPSCRingBuffer<std::uint64_t, 64> pong;
+    };
+    constexpr std::size_t kWarmup = 200;
+    auto rings = std::make_unique<Rings>();
+    std::atomic<int> pinned { 0 };
+    std::atomic<bool> failed { false };
+    std::vector<double> samples;
+    samples.reserve(round_trips);
+    const double ticks_per_ns = TscPerNanosecond();
+    // Spin, but let the peer run when both threads share a cpu
+    auto wait = [](std::size_t& spins) {
+        if (++spins % 4096 == 0) {
+            std::this_thread::yield();
+        } else {
+            CpuRelax();
+        }
+    };
+
+    std::thread echo([&] {
+        if (cpu_b >= 0 && !PinThisThread(cpu_b)) {
+            failed.store(true);
+        }
+        pinned.fetch_add(1);
+        std::size_t spins = 0;
+        while (pinned.load() != 2) {
+            wait(spins);
+        }
+        if (failed.load()) {
+            return;
+        }
+        std::uint64_t token = 0;
+        for (std::size_t i = 0; i < kWarmup + round_trips; ++i) {
+            while (!rings->ping.Pop(token)) {
+                wait(spins);
+            }
+            while (!rings->pong.Push(token)) {
+                wait(spins);
+            }
+        }
+    });
+    std::thread ping([&] {
+        if (cpu_a >= 0 && !PinThisThread(cpu_a)) {
+            failed.store(true);
+        }
+        pinned.fetch_add(1);
+        std::size_t spins = 0;
+        while (pinned.load() != 2) {
+            wait(spins);
+        }
+        if (failed.load()) {
+            return;
+        }
+        std::uint64_t token = 0;
+        for (std::size_t i = 0; i < kWarmup + round_trips; ++i) {
+            const std::uint64_t start = ReadTsc();
+            while (!rings->ping.Push(i)) {
+                wait(spins);
+            }
+            while (!rings->pong.Pop(token)) {
+                wait(spins);
+            }
+            if (i >= kWarmup) {
+                samples.push_back(static_cast<double>(ReadTsc() - start) / ticks_per_ns);
+            }
+        }
+    });
+    ping.join();
+    echo.join();
+
+    if (failed.load() || samples.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(samples.size() / 2), samples.end());
+    return samples[samples.size() / 2];
+}
+
+/**
+ * @brief Round trip latency between every pair of a set of cpus
+ *
+ */
+struct CoreLatencyMatrix {
+    std::vector<int> cpus;
+    std::vector<double> round_trip_ns; /// row major, cpus.size() squared, 0 on the diagonal
+
+    [[nodiscard]] auto Size() const noexcept -> std::size_t
+    {
+        return cpus.size();
+    }
+
+    [[nodiscard]] auto At(std::size_t a, std::size_t b) const noexcept -> double
+    {
+        return round_trip_ns[a * cpus.size() + b];
+    }
+
+    /**
+     * @brief Mean of both directions, NaN when either is unknown
+     *
+     */
+    [[nodiscard]] auto Distance(std::size_t a, std::size_t b) const noexcept -> double
+    {
+        return a == b ? 0.0 : (At(a, b) + At(b, a)) / 2.0;
+    }
+};
+
+/**
+ * @brief Measure every ordered pair of cpus
+ *
+ */
+inline auto MeasureCoreLatencyMatrix(const std::vector<int>& cpus, std::size_t round_trips = 2000) -> CoreLatencyMatrix
+{
+    CoreLatencyMatrix matrix;
+    matrix.cpus = cpus;
+    matrix.round_trip_ns.assign(cpus.size() * cpus.size(), 0.0);
+    for (std::size_t a = 0; a < cpus.size(); ++a) {
+        for (std::size_t b = 0; b < cpus.size(); ++b) {
+            if (a != b) {
+                matrix.round_trip_ns[a * cpus.size() + b] = MeasureRoundTrip(cpus[a], cpus[b], round_trips);
+            }
+        }
+    }
+    return matrix;
+}
+
+/**
+ * @brief Groups of cpus at each latency tier, tightest tier first
+ *
+ * On a typical machine the tiers are SMT siblings, cores sharing an L3
+ * (CCX / die) and sockets.
+ */
+struct CoreClusters {
+    struct Level {
+        double threshold_ns = 0.0; /// pairs at or below are in the same cluster
+        std::vector<std::vector<std::size_t>> clusters; /// indices into the matrix
+    };
+
+    std::vector<Level> levels;
+};
+
+/**
+ * @brief Find latency tiers as large relative gaps between pair latencies
+ *
+ * Distinct pair latencies are sorted; every step of at least gap_ratio
+ * between neighbours separates two tiers. Each tier's clusters are the
+ * connected components of pairs below the gap (single linkage), so noise
+ * inside a tier does not split it. Only tiers with more than one cluster
+ * are reported.
+ */
+inline auto DetectClusters(const CoreLatencyMatrix& matrix, double gap_ratio = 1.3) -> CoreClusters
+{
+    const std::size_t n = matrix.Size();
+    std::vector<double> distances;
+    for (std::size_t a = 0; a < n; ++a) {
+        for (std::size_t b = a + 1; b < n; ++b) {
+            const double distance = matrix.Distance(a, b);
+            if (!std::isnan(distance)) {
+                distances.push_back(distance);
+            }
+        }
+    }
+    std::sort(distances.begin(), distances.end());
+
+    CoreClusters result;
+    for (std::size_t i = 0; i + 1 < distances.size(); ++i) {
+        if (distances[i] <= 0.0 || distances[i + 1] / distances[i] < gap_ratio) {
+            continue;
+        }
+        CoreClusters::Level level;
+        level.threshold_ns = std::sqrt(distances[i] * distances[i + 1]);
+
+        std::vector<std::size_t> component(n, n);
+        for (std::size_t start = 0; start < n; ++start) {
+            if (component[start] != n) {
+                continue;
+            }
+            const std::size_t id = level.clusters.size();
+            level.clusters.emplace_back();
+            std::vector<std::size_t> stack { start };
+            component[start] = id;
+            while (!stack.empty()) {
+                const std::size_t a = stack.back();
+                stack.pop_back();
+                level.clusters[id].push_back(a);
+                for (std::size_t b = 0; b < n; ++b) {
+                    if (component[b] == n && matrix.Distance(a, b) <= level.threshold_ns) {
+                        component[b] = id;
+                        stack.push_back(b);
+                    }
+                }
+            }
+            std::sort(level.clusters[id].begin(), level.clusters[id].end());
+        }
+        if (level.clusters.size() > 1) {
+            result.levels.push_back(std::move(level));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Pipeline stages and how much traffic each hand-off carries
+ *
+ * Text form, one item per line, # starts a comment:
+ *     stage feed
+ *     stage engine
+ *     link feed engine 1.0
+ */
+struct StageGraph {
+    struct Link {
+        std::size_t from = 0;
+        std::size_t to = 0;
+        double weight = 1.0; /// relative messages per second over the hand-off
+    };
+
+    std::vector<std::string> stages;
+    std::vector<Link> links;
+
+    [[nodiscard]] auto Find(const std::string& name) const noexcept -> std::size_t
+    {
+        const auto found = std::find(stages.begin(), stages.end(), name);
+        return static_cast<std::size_t>(found - stages.begin());
+    }
+
+    /**
+     * @brief Parse the text form, false on an unknown keyword or stage
+     *
+     */
+    [[nodiscard]] auto Parse(const std::string& text) -> bool
+    {
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line)) {
+            line = line.substr(0, line.find('#'));
+            std::istringstream words(line);
+            std::string keyword;
+            if (!(words >> keyword)) {
+                continue;
+            }
+            if (keyword == "stage") {
+                std::string name;
+                if (!(words >> name) || Find(name) != stages.size()) {
+                    return false;
+                }
+                stages.push_back(name);
+            } else if (keyword == "link") {
+                std::string from;
+                std::string to;
+                Link link;
+                if (!(words >> from >> to)) {
+                    return false;
+                }
+                link.from = Find(from);
+                link.to = Find(to);
+                if (link.from == stages.size() || link.to == stages.size() || link.from == link.to) {
+                    return false;
+                }
+                if (!(words >> link.weight)) {
+                    link.weight = 1.0;
+                }
+                links.push_back(link);
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief The pipeline of this library: feed handler, trading engine, gateway, drop copy
+     *
+     */
+    static auto Default() -> StageGraph
+    {
+        StageGraph graph;
+        (void)graph.Parse("stage feed\n"
+                          "stage engine\n"
+                          "stage gateway\n"
+                          "stage drop_copy\n"
+                          "link feed engine 1.0\n"
+                          "link engine gateway 1.0\n"
+                          "link gateway drop_copy 0.2\n");
+        return graph;
+    }
+};
+
+/**
+ * @brief Weighted hand-off latency of a placement, stage i on matrix index placement[i]
+ *
+ */
+inline auto PlacementCost(const StageGraph& graph, const CoreLatencyMatrix& matrix, const std::vector<std::size_t>& placement) -> double
+{
+    double cost = 0.0;
+    for (const auto& link : graph.links) {
+        const double distance = matrix.Distance(placement[link.from], placement[link.to]);
+        cost += link.weight * (std::isnan(distance) ? 1e9 : distance);
+    }
+    return cost;
+}
+
+/**
+ * @brief One distinct cpu per stage, minimising the weighted hand-off latency
+ *
+ * Greedy seed (heaviest link on the closest pair, then the stage with the
+ * most traffic to placed stages on its best free cpu) improved by moves to
+ * free cpus and swaps until none helps.
+ *
+ * @return std::vector<std::size_t> matrix index per stage, empty when there are more stages than cpus
+ */
+inline auto SuggestPlacement(const StageGraph& graph, const CoreLatencyMatrix& matrix) -> std::vector<std::size_t>
+{
+    const std::size_t stages = graph.stages.size();
+    const std::size_t cpus = matrix.Size();
+    if (stages == 0 || stages > cpus) {
+        return {};
+    }
+    constexpr std::size_t kUnplaced = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> placement(stages, kUnplaced);
+    std::vector<bool> used(cpus, false);
+
+    auto traffic = [&](std::size_t stage, std::size_t cpu) {
+        double cost = 0.0;
+        double weight = 0.0;
+        for (const auto& link : graph.links) {
+            const std::size_t other = link.from == stage ? link.to : link.to == stage ? link.from : kUnplaced;
+            if (other != kUnplaced && placement[other] != kUnplaced) {
+                const double distance = matrix.Distance(cpu, placement[other]);
+                cost += link.weight * (std::isnan(distance) ? 1e9 : distance);
+                weight += link.weight;
+            }
+        }
+        return std::make_pair(cost, weight);
+    };
+
+    for (std::size_t placed = 0; placed < stages; ++placed) {
+        // Next stage: most traffic to stages already placed, the first stage of the heaviest link to start
+        std::size_t stage = kUnplaced;
+        double best_weight = -1.0;
+        for (std::size_t s = 0; s < stages; ++s) {
+            if (placement[s] != kUnplaced) {
+                continue;
+            }
+            double weight = 0.0;
+            for (const auto& link : graph.links) {
+                const bool touches = link.from == s || link.to == s;
+                const std::size_t other = link.from == s ? link.to : link.from;
+                if (touches && (placed == 0 || placement[other] != kUnplaced)) {
+                    weight = placed == 0 ? std::max(weight, link.weight) : weight + link.weight;
+                }
+            }
+            if (weight > best_weight) {
+                best_weight = weight;
+                stage = s;
+            }
+        }
+
+        std::size_t best_cpu = kUnplaced;
+        double best_cost = std::numeric_limits<double>::infinity();
+        for (std::size_t cpu = 0; cpu < cpus; ++cpu) {
+            if (used[cpu]) {
+                continue;
+            }
+            double cost = traffic(stage, cpu).first;
+            if (placed == 0) {
+                // Seed on the cpu with the closest neighbour
+                cost = std::numeric_limits<double>::infinity();
+                for (std::size_t other = 0; other < cpus; ++other) {
+                    const double distance = matrix.Distance(cpu, other);
+                    if (other != cpu && !std::isnan(distance)) {
+                        cost = std::min(cost, distance);
+                    }
+                }
+            }
+            if (cost < best_cost || best_cpu == kUnplaced) {
+                best_cost = cost;
+                best_cpu = cpu;
+            }
+        }
+        placement[stage] = best_cpu;
+        used[best_cpu] = true;
+    }
+
+    double cost = PlacementCost(graph, matrix, placement);
+    for (bool improved = true; improved;) {
+        improved = false;
+        for (std::size_t s = 0; s < stages; ++s) {
+            for (std::size_t cpu = 0; cpu < cpus; ++cpu) {
+                std::vector<std::size_t> candidate = placement;
+                if (used[cpu]) {
+                    const auto other = static_cast<std::size_t>(std::find(placement.begin(), placement.end(), cpu) - placement.begin());
+                    std::swap(candidate[s], candidate[other]);
+                } else {
+                    candidate[s] = cpu;
+                }
+                const double candidate_cost = PlacementCost(graph, matrix, candidate);
+                if (candidate_cost + 1e-9 < cost) {
+                    if (!used[cpu]) {
+                        used[placement[s]] = false;
+                        used[cpu] = true;
+                    }
+                    placement = std::move(candidate);
+                    cost = candidate_cost;
+                    improved = true;
+                }
+            }
+        }
+    }
+    return placement;
+}
+
+} // namespace hft::core
@@ -0,0 +1,538 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HFT_CSV_SSE2 1
+#endif
+
+#include "Affinity.hpp"
+#include "BitOps.hpp"
+#include "MarketData.hpp"
+#include "Tsc.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Layout of a vendor tick file
+ *
+ * One trade per line: timestamp,instrument,side,price,quantity
+ * e.g. 1700000000123456789,42,B,101.2500,300
+ * side is B or S, price is a decimal converted to fixed point with
+ * price_decimals digits (extra digits are truncated). CRLF is accepted.
+ */
+struct CsvConfig {
+    char delimiter = ',';
+    bool has_header = true;
+    unsigned price_decimals = 4;
+    unsigned threads = 1; /// chunks parsed in parallel, one per thread
+    int cpu_base = -1; /// pin chunk thread i to cpu_base + i, -1 leaves them floating
+};
+
+struct CsvIngestStats {
+    std::uint64_t records = 0;
+    std::uint64_t malformed = 0; /// lines skipped, wrong field count or bad number
+    std::uint64_t bytes = 0;
+
+    void Add(const CsvIngestStats& other) noexcept
+    {
+        records += other.records;
+        malformed += other.malformed;
+        bytes += other.bytes;
+    }
+};
+
+namespace detail {
+
+    /**
+     * @brief Positions of delimiters and newlines, found 64 bytes at a time
+     *
+     * Four SSE2 compares per 64 byte block build a bitmask of structural
+     * characters; Next() pops the lowest bit. Bytes past end are never read.
+     */
+    class StructuralScanner {
+    public:
+        StructuralScanner(const char* data, std::size_t begin, std::size_t end, char delimiter) noexcept
+            : data_(data)
+            , end_(end)
+            , block_(begin)
+            , delimiter_(delimiter)
+        {
+            mask_ = BlockMask(block_);
+        }
+
+        /**
+         * @brief Position of the next delimiter or newline, end when none is left
+         *
+         */
+        auto Next() noexcept -> std::size_t
+        {
+            while (mask_ == 0) {
+                block_ += 64;
+                if (block_ >= end_) {
+                    return end_;
+                }
+                mask_ = BlockMask(block_);
+            }
+            const std::size_t position = block_ + CountTrailingZeros(mask_);
+            mask_ &= mask_ - 1;
+            return position;
+        }
+
+    private:
+        auto BlockMask(std::size_t block) const noexcept -> std::uint64_t
+        {
+            const char* bytes = data_ + block;
+            if (block + 64 > end_) {
+                std::uint64_t mask = 0;
+                for (std::size_t i = 0; block + i < end_; ++i) {
+                    if (bytes[i] == delimiter_ || bytes[i] == '\n') {
+                        mask |= std::uint64_t { 1 } << i;
+                    }
+                }
+                return mask;
+            }
+#if defined(HFT_CSV_SSE2)
+            const __m128i delimiter = _mm_set1_epi8(delimiter_);
+            const __m128i newline = _mm_set1_epi8('\n');
+            std::uint64_t mask = 0;
+            for (int lane = 0; lane < 4; ++lane) {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + lane * 16));
+                const __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, delimiter), _mm_cmpeq_epi8(chunk, newline));
+                mask |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(hits))) << (lane * 16);
+            }
+            return mask;
+#else
+            std::uint64_t mask = 0;
+            for (std::size_t i = 0; i < 64; ++i) {
+                if (bytes[i] == delimiter_ || bytes[i] == '\n') {
+                    mask |= std::uint64_t { 1 } << i;
+                }
+            }
+            return mask;
+#endif
+        }
+
+        const char* data_;
+        std::size_t end_;
+        std::size_t block_;
+        std::uint64_t mask_ = 0;
+        char delimiter_;
+    };
+
+    /**
+     * @brief Value of 8 ASCII digits packed little endian, false if any byte is not a digit (SWAR)
+     *
+     */
+    inline auto EightDigits(std::uint64_t value, std::uint64_t& out) noexcept -> bool
+    {
+        const bool digits = ((value & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL)
+            & (((value + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL);
+        value = (value & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;
+        value = (value & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;
+        out = (value & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32;
+        return digits;
+    }
+
+    inline auto ParseEightDigits(const char* text, std::uint64_t& out) noexcept -> bool
+    {
+        std::uint64_t value = 0;
+        std::memcpy(&value, text, sizeof(value));
+        return EightDigits(value, out);
+    }
+
+    /**
+     * @brief Value of the 1..8 digits at text without branching on length, reads 8 bytes
+     *
+     * The digits are shifted to the top of the word and the bytes below
+     * filled with '0', i.e. leading zeros.
+     */
+    inline auto ParseShortDigits(const char* text, std::size_t length, std::uint64_t& out) noexcept -> bool
+    {
+        std::uint64_t value = 0;
+        std::memcpy(&value, text, sizeof(value));
+        const auto pad = static_cast<unsigned>(8 - length) * 8;
+        value = (value << pad) | (0x3030303030303030ULL & ((std::uint64_t { 1 } << pad) - 1));
+        return EightDigits(value, out);
+    }
+
+    /**
+     * @brief Unsigned decimal of at most 19 digits
+     *
+     * @tparam kPadded caller guarantees 8 readable bytes from text, lets
+     * short numbers skip the per digit loop
+     */
+    template <bool kPadded = false>
+    inline auto ParseUnsigned(const char* text, std::size_t length, std::uint64_t& out) noexcept -> bool
+    {
+        if (length == 0 || length > 19) {
+            return false;
+        }
+        if constexpr (kPadded) {
+            const std::size_t head = ((length - 1) & 7) + 1;
+            std::uint64_t value = 0;
+            bool digits = ParseShortDigits(text, head, value);
+            for (std::size_t i = head; i < length; i += 8) {
+                std::uint64_t eight = 0;
+                digits &= ParseEightDigits(text + i, eight);
+                value = value * 100000000ULL + eight;
+            }
+            out = value;
+            return digits;
+        } else {
+            std::uint64_t value = 0;
+            std::size_t i = 0;
+            for (; i + 8 <= length; i += 8) {
+                std::uint64_t eight = 0;
+                if (!ParseEightDigits(text + i, eight)) {
+                    return false;
+                }
+                value = value * 100000000ULL + eight;
+            }
+            for (; i < length; ++i) {
+                const auto digit = static_cast<unsigned>(text[i] - '0');
+                if (digit > 9) {
+                    return false;
+                }
+                value = value * 10 + digit;
+            }
+            out = value;
+            return true;
+        }
+    }
+
+    /**
+     * @brief Signed decimal to fixed point with decimals fraction digits, "101.25" -> 1012500 for 4
+     *
+     */
+    template <bool kPadded = false>
+    inline auto ParseFixedPoint(const char* text, std::size_t length, unsigned decimals, std::int64_t& out) noexcept -> bool
+    {
+        static constexpr std::uint64_t kPow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+        if (decimals >= sizeof(kPow10) / sizeof(kPow10[0])) {
+            return false;
+        }
+        const bool negative = length != 0 && text[0] == '-';
+        if (negative) {
+            ++text;
+            --length;
+        }
+        std::size_t integer_length = 0;
+        if constexpr (kPadded) {
+            // Locate the '.' among the first 8 bytes with a SWAR zero byte test, no per byte branch
+            std::uint64_t word = 0;
+            std::memcpy(&word, text, sizeof(word));
+            word ^= 0x2E2E2E2E2E2E2E2EULL;
+            const std::uint64_t dots = (word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL;
+            integer_length = dots == 0 ? 8 : CountTrailingZeros(dots) / 8;
+            integer_length = integer_length < length ? integer_length : length;
+        }
+        // Fields are short, a plain loop beats a memchr call
+        while (integer_length < length && text[integer_length] != '.') {
+            ++integer_length;
+        }
+        std::uint64_t integer = 0;
+        if (integer_length > 18 - decimals || !ParseUnsigned<kPadded>(text, integer_length, integer)) {
+            return false;
+        }
+        std::uint64_t fraction = 0;
+        if (integer_length < length) {
+            const char* digits = text + integer_length + 1;
+            const std::size_t fraction_length = length - integer_length - 1;
+            const std::size_t used = fraction_length < decimals ? fraction_length : decimals;
+            if (used != 0 && !ParseUnsigned<kPadded>(digits, used, fraction)) {
+                return false;
+            }
+            for (std::size_t i = used; i < fraction_length; ++i) {
+                if (static_cast<unsigned>(digits[i] - '0') > 9) {
+                    return false;
+                }
+            }
+            fraction *= kPow10[decimals - used];
+        }
+        const auto value = static_cast<std::int64_t>(integer * kPow10[decimals] + fraction);
+        out = negative ? -value : value;
+        return true;
+    }
+
+    /**
+     * @brief Convert the 5 fields of one line, false if any is malformed
+     *
+     */
+    template <bool kPadded>
+    inline auto ParseTickFields(const char* data, const std::size_t* starts, const std::size_t* ends, unsigned decimals, MarketEvent& event) noexcept -> bool
+    {
+        std::uint64_t timestamp = 0;
+        std::uint64_t instrument = 0;
+        std::uint64_t quantity = 0;
+        const char side = ends[2] - starts[2] == 1 ? data[starts[2]] : '\0';
+        // Non short circuit &, every field is parsed anyway and the checks stay branch free
+        const bool valid = ParseUnsigned<kPadded>(data + starts[0], ends[0] - starts[0], timestamp)
+            & ParseUnsigned<kPadded>(data + starts[1], ends[1] - starts[1], instrument) & (instrument <= UINT32_MAX)
+            & ((side == 'B') | (side == 'S'))
+            & ParseFixedPoint<kPadded>(data + starts[3], ends[3] - starts[3], decimals, event.price)
+            & ParseUnsigned<kPadded>(data + starts[4], ends[4] - starts[4], quantity) & (quantity <= UINT32_MAX);
+        event.timestamp = timestamp;
+        event.instrument = static_cast<std::uint32_t>(instrument);
+        event.quantity = static_cast<std::uint32_t>(quantity);
+        event.action = BookAction::Trade;
+        event.side = side == 'B' ? Side::Buy : Side::Sell;
+        return valid;
+    }
+
+} // namespace detail
+
+/**
+ * @brief Read only mapping of a tick file, split at line boundaries
+ *
+ */
+class CsvTickFile {
+public:
+    CsvTickFile() = default;
+
+    ~CsvTickFile()
+    {
+        Close();
+    }
+
+    CsvTickFile(const CsvTickFile&) = delete;
+    auto operator=(const CsvTickFile&) -> CsvTickFile& = delete;
+    CsvTickFile(CsvTickFile&&) = delete;
+    auto operator=(CsvTickFile&&) -> CsvTickFile& = delete;
+
+    /**
+     * @brief Map path, the kernel is told the access is sequential
+     *
+     */
+    [[nodiscard]] auto Open(const char* path) noexcept -> bool
+    {
+        Close();
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat status {};
+        if (::fstat(fd, &status) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<std::size_t>(status.st_size);
+        if (size_ == 0) {
+            ::close(fd);
+            data_ = "";
+            return true;
+        }
+        void* base = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            size_ = 0;
+            return false;
+        }
+        ::madvise(base, size_, MADV_SEQUENTIAL);
+        ::madvise(base, size_, MADV_WILLNEED);
+        data_ = static_cast<const char*>(base);
+        mapped_ = true;
+        return true;
+    }
+
+    void Close() noexcept
+    {
+        if (mapped_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+        mapped_ = false;
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    /**
+     * @brief Split into at most parts [begin, end) ranges, each ending after a newline
+     *
+     * @param skip_header leave out the first line
+     */
+    [[nodiscard]] auto Chunks(unsigned parts, bool skip_header) const -> std::vector<std::pair<std::size_t, std::size_t>>
+    {
+        std::size_t begin = 0;
+        if (skip_header) {
+            begin = LineEnd(0);
+        }
+        std::vector<std::pair<std::size_t, std::size_t>> chunks;
+        parts = parts == 0 ? 1 : parts;
+        const std::size_t nominal = (size_ - begin) / parts + 1;
+        while (begin < size_) {
+            const std::size_t end = LineEnd(begin + nominal < size_ ? begin + nominal - 1 : size_);
+            chunks.emplace_back(begin, end);
+            begin = end;
+        }
+        return chunks;
+    }
+
+    [[nodiscard]] auto Data() const noexcept -> const char*
+    {
+        return data_;
+    }
+
+    [[nodiscard]] auto Size() const noexcept -> std::size_t
+    {
+        return size_;
+    }
+
+private:
+    /**
+     * @brief Position after the newline at or after position
+     *
+     */
+    auto LineEnd(std::size_t position) const noexcept -> std::size_t
+    {
+        if (position >= size_) {
+            return size_;
+        }
+        const auto* newline = static_cast<const char*>(std::memchr(data_ + position, '\n', size_ - position));
+        return newline == nullptr ? size_ : static_cast<std::size_t>(newline - data_) + 1;
+    }
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+};
+
+/**
+ * @brief Parse the lines of data[begin, end) and hand them to sink in batches
+ *
+ * Emits Trade MarketEvents whose sequence is the byte offset of the line,
+ * so records of different chunks can be merged back into file order.
+ *
+ * @tparam Sink callable (const MarketEvent* records, std::size_t count)
+ */
+template <typename Sink>
+auto ParseCsvTicks(const char* data, std::size_t begin, std::size_t end, const CsvConfig& config, Sink& sink) noexcept -> CsvIngestStats
+{
+    constexpr std::size_t kColumns = 5;
+    constexpr std::size_t kBatch = 256;
+
+    CsvIngestStats stats;
+    stats.bytes = end - begin;
+    MarketEvent batch[kBatch];
+    std::size_t batched = 0;
+
+    detail::StructuralScanner scanner(data, begin, end, config.delimiter);
+    std::size_t line_start = begin;
+    while (line_start < end) {
+        std::size_t starts[kColumns];
+        std::size_t ends[kColumns];
+        std::size_t fields = 0;
+        std::size_t field_start = line_start;
+        std::size_t position = 0;
+        while (true) {
+            position = scanner.Next();
+            if (fields < kColumns) {
+                starts[fields] = field_start;
+                ends[fields] = position;
+            }
+            ++fields;
+            field_start = position + 1;
+            if (position >= end || data[position] == '\n') {
+                break;
+            }
+        }
+        const std::size_t line_end = position;
+        if (fields == kColumns && ends[4] > starts[4] && data[ends[4] - 1] == '\r') {
+            --ends[4];
+        }
+
+        MarketEvent& event = batch[batched];
+        bool valid = false;
+        if (fields == kColumns) [[likely]] {
+            // All but the last lines of a chunk have 8 readable bytes after every field start
+            valid = line_end + 8 <= end ? detail::ParseTickFields<true>(data, starts, ends, config.price_decimals, event)
+                                        : detail::ParseTickFields<false>(data, starts, ends, config.price_decimals, event);
+        }
+        if (valid) [[likely]] {
+            event.sequence = line_start;
+            if (++batched == kBatch) {
+                sink(static_cast<const MarketEvent*>(batch), batched);
+                stats.records += batched;
+                batched = 0;
+            }
+        } else if (!(fields == 1 && (line_end == line_start || (line_end == line_start + 1 && data[line_start] == '\r')))) {
+            // Blank lines are not errors
+            ++stats.malformed;
+        }
+        line_start = line_end + 1;
+    }
+    if (batched != 0) {
+        sink(static_cast<const MarketEvent*>(batch), batched);
+        stats.records += batched;
+    }
+    return stats;
+}
+
+/**
+ * @brief Sink pushing each record into a ring, spinning while it is full
+ *
+ */
+template <typename Ring>
+struct RingSink {
+    Ring* ring;
+
+    void operator()(const MarketEvent* records, std::size_t count) noexcept
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            while (!ring->Push(records[i])) {
+                CpuRelax();
+            }
+        }
+    }
+};
+
+/**
+ * @brief Parse file with config.threads threads, chunk i goes to make_sink(i)
+ *
+ * Chunk 0 is parsed on the calling thread. Within a chunk records keep
+ * file order; across chunks use MarketEvent::sequence (line offset). A
+ * typical setup gives every chunk its own SPSCRingBuffer via RingSink.
+ *
+ * @tparam SinkFactory callable (std::size_t chunk) -> Sink
+ */
+template <typename SinkFactory>
+auto IngestCsv(const CsvTickFile& file, const CsvConfig& config, SinkFactory make_sink) -> CsvIngestStats
+{
+    const auto chunks = file.Chunks(config.threads, config.has_header);
+    std::vector<CsvIngestStats> results(chunks.size());
+    auto parse = [&](std::size_t index) {
+        if (config.cpu_base >= 0) {
+            (void)PinThisThread(config.cpu_base + static_cast<int>(index));
+        }
+        auto sink = make_sink(index);
+        results[index] = ParseCsvTicks(file.Data(), chunks[index].first, chunks[index].second, config, sink);
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < chunks.size(); ++i) {
+        workers.emplace_back(parse, i);
+    }
+    if (!chunks.empty()) {
+        parse(0);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    CsvIngestStats total;
+    for (const auto& result : results) {
+        total.Add(result);
+    }
+    return total;
+}
+
+} // namespace hft::core
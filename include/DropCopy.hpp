@@ -0,0 +1,408 @@
+#pragma once
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "OrderEncoder.hpp"
+#include "OrderEvent.hpp"
+#include "Tsc.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Serialization of the audit trail
+ *
+ */
+enum class DropCopyFormat {
+    Binary, /// fixed 64 byte DropCopyRecord per event
+    Fix /// FIX 4.4 ExecutionReport (35=8) per event, UTC timestamps from the calibrated TSC
+};
+
+/**
+ * @brief Binary drop copy record, little endian, 64 bytes
+ *
+ */
+struct DropCopyRecord {
+    std::uint64_t sequence = 0;
+    std::uint64_t timestamp = 0;
+    std::uint64_t order_id = 0;
+    std::int64_t price = 0;
+    std::uint32_t instrument = 0;
+    std::uint32_t quantity = 0;
+    std::uint8_t event_type = 0;
+    std::uint8_t action = 0;
+    std::uint8_t side = 0;
+    std::uint8_t padding[21] {};
+};
+
+static_assert(sizeof(DropCopyRecord) == 64, "DropCopyRecord layout is part of the file format.");
+
+/**
+ * @brief Drop copy / audit trail stage, runs on its own (non critical) thread
+ *
+ * Producers only push an OrderEvent into the DropCopyQueue. Poll drains a
+ * batch, serializes it into one buffer and issues a single write to the
+ * file and a single send to the TCP consumer. The file is the record of
+ * truth; when the TCP consumer cannot keep up its pending bytes are capped
+ * and the connection is dropped rather than stalling the writer.
+ */
+class DropCopyWriter {
+public:
+    static constexpr std::size_t kBatch = 512;
+    static constexpr std::size_t kMaxPendingTcp = 4 << 20;
+
+    /**
+     * @brief Anchors event TSC timestamps to the wall clock, cold path (TSC calibration)
+     *
+     */
+    DropCopyWriter(DropCopyQueue& queue, DropCopyFormat format)
+        : queue_(queue)
+        , format_(format)
+        , ticks_per_ns_(TscPerNanosecond())
+        , anchor_tsc_(ReadTsc())
+        , anchor_utc_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count())
+    {
+        buffer_.reserve(kBatch * 512);
+        pending_tcp_.reserve(kMaxPendingTcp);
+        SetFixCompIds("HFTCORE", "DROPCOPY");
+    }
+
+    ~DropCopyWriter()
+    {
+        Close();
+    }
+
+    DropCopyWriter(const DropCopyWriter&) = delete;
+    auto operator=(const DropCopyWriter&) -> DropCopyWriter& = delete;
+    DropCopyWriter(DropCopyWriter&&) = delete;
+    auto operator=(DropCopyWriter&&) -> DropCopyWriter& = delete;
+
+    /**
+     * @brief Append to path, creating it when missing
+     *
+     */
+    [[nodiscard]] auto OpenFile(const char* path) noexcept -> bool
+    {
+        file_fd_ = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        return file_fd_ >= 0;
+    }
+
+    /**
+     * @brief Connect to a drop copy consumer on the local host
+     *
+     */
+    [[nodiscard]] auto ConnectTcp(std::uint16_t port) noexcept -> bool
+    {
+        socket_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (socket_fd_ < 0) {
+            return false;
+        }
+        sockaddr_in address {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        const int one = 1;
+        ::setsockopt(socket_fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (::connect(socket_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+            || ::fcntl(socket_fd_, F_SETFL, ::fcntl(socket_fd_, F_GETFL) | O_NONBLOCK) != 0) {
+            CloseSocket();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Drain up to one batch, serialize and write it
+     *
+     * @return std::size_t number of events written
+     */
+    auto Poll() noexcept -> std::size_t
+    {
+        buffer_.clear();
+        std::size_t count = 0;
+        OrderEvent event;
+        while (count < kBatch && queue_.Pop(event)) {
+            Serialize(event);
+            ++count;
+        }
+        if (count == 0) {
+            FlushTcp();
+            return 0;
+        }
+        WriteFile(buffer_.data(), buffer_.size());
+        SendTcp(buffer_.data(), buffer_.size());
+        written_ += count;
+        return count;
+    }
+
+    /**
+     * @brief Drain everything that is queued, then fsync the file
+     *
+     */
+    void Flush() noexcept
+    {
+        while (Poll() != 0) {
+        }
+        if (file_fd_ >= 0) {
+            ::fsync(file_fd_);
+        }
+    }
+
+    void Close() noexcept
+    {
+        if (file_fd_ >= 0) {
+            ::close(file_fd_);
+            file_fd_ = -1;
+        }
+        CloseSocket();
+    }
+
+    [[nodiscard]] auto GetWrittenCount() const noexcept -> std::uint64_t
+    {
+        return written_;
+    }
+
+    [[nodiscard]] auto GetFileErrorCount() const noexcept -> std::uint64_t
+    {
+        return file_errors_;
+    }
+
+    /**
+     * @brief Bytes the TCP consumer never received because it fell behind or went away
+     *
+     */
+    [[nodiscard]] auto GetTcpDroppedBytes() const noexcept -> std::uint64_t
+    {
+        return tcp_dropped_bytes_;
+    }
+
+    /**
+     * @brief SenderCompID (49) and TargetCompID (56) of FIX output, truncated to 15 characters
+     *
+     */
+    void SetFixCompIds(const char* sender, const char* target) noexcept
+    {
+        std::snprintf(sender_comp_id_.data(), sender_comp_id_.size(), "%s", sender);
+        std::snprintf(target_comp_id_.data(), target_comp_id_.size(), "%s", target);
+    }
+
+    /**
+     * @brief FIX UTCTimestamp with milliseconds, YYYYMMDD-HH:MM:SS.sss
+     *
+     * @return int characters written, excluding the terminator
+     */
+    static auto FormatUtcTimestamp(std::int64_t utc_ns, char* out, std::size_t capacity) noexcept -> int
+    {
+        const std::int64_t ms = utc_ns / 1000000;
+        const auto seconds = static_cast<std::time_t>(ms / 1000);
+        std::tm utc {};
+        if (::gmtime_r(&seconds, &utc) == nullptr) [[unlikely]] {
+            return 0;
+        }
+        return std::snprintf(out, capacity, "%04d%02d%02d-%02d:%02d:%02d.%03d", utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday,
+            utc.tm_hour, utc.tm_min, utc.tm_sec, static_cast<int>(ms % 1000));
+    }
+
+    /**
+     * @brief FIX checksum, byte sum modulo 256
+     *
+     */
+    static auto FixChecksum(const char* data, std::size_t size) noexcept -> unsigned
+    {
+        unsigned sum = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            sum += static_cast<unsigned char>(data[i]);
+        }
+        return sum % 256;
+    }
+
+private:
+    void Serialize(const OrderEvent& event) noexcept
+    {
+        OrderRequest order;
+        if (!OrderEncoder::Decode(event.order.bytes.data(), event.order.length, order)) [[unlikely]] {
+            order = OrderRequest {};
+        }
+        ++sequence_;
+        if (format_ == DropCopyFormat::Binary) {
+            DropCopyRecord record;
+            record.sequence = sequence_;
+            record.timestamp = event.timestamp;
+            record.order_id = order.order_id;
+            record.price = order.price;
+            record.instrument = order.instrument;
+            record.quantity = order.quantity;
+            record.event_type = static_cast<std::uint8_t>(event.type);
+            record.action = static_cast<std::uint8_t>(order.action);
+            record.side = static_cast<std::uint8_t>(order.side);
+            const auto* bytes = reinterpret_cast<const char*>(&record);
+            buffer_.insert(buffer_.end(), bytes, bytes + sizeof(record));
+            return;
+        }
+        SerializeFix(event, order);
+    }
+
+    auto TscToUtcNanoseconds(std::uint64_t tsc) const noexcept -> std::int64_t
+    {
+        const auto ticks = static_cast<double>(static_cast<std::int64_t>(tsc - anchor_tsc_));
+        return anchor_utc_ns_ + static_cast<std::int64_t>(ticks / ticks_per_ns_);
+    }
+
+    void SerializeFix(const OrderEvent& event, const OrderRequest& order) noexcept
+    {
+        constexpr char kSoh = '\x01';
+        // 150 ExecType and 39 OrdStatus: 0 new, 4 cancelled, 5 replaced, 8 rejected
+        char exec_type = '0';
+        if (event.type == OrderEventType::RiskRejected) {
+            exec_type = '8';
+        } else if (event.type == OrderEventType::Cancelled || order.action == OrderAction::Cancel) {
+            exec_type = '4';
+        } else if (order.action == OrderAction::Replace) {
+            exec_type = '5';
+        }
+        // Nothing is filled at this stage, a live order leaves its full quantity
+        const std::uint32_t leaves = exec_type == '0' || exec_type == '5' ? order.quantity : 0;
+
+        char transact_time[32];
+        char sending_time[32];
+        if (FormatUtcTimestamp(TscToUtcNanoseconds(event.timestamp), transact_time, sizeof(transact_time)) <= 0
+            || FormatUtcTimestamp(TscToUtcNanoseconds(ReadTsc()), sending_time, sizeof(sending_time)) <= 0) [[unlikely]] {
+            return;
+        }
+
+        char body[512];
+        const int body_length = std::snprintf(body, sizeof(body),
+            "35=8%c49=%s%c56=%s%c34=%llu%c52=%s%c"
+            "37=%llu%c11=%llu%c17=%llu%c150=%c%c39=%c%c55=%u%c54=%c%c38=%u%c44=%lld%c"
+            "151=%u%c14=0%c6=0%c60=%s%c",
+            kSoh, sender_comp_id_.data(), kSoh, target_comp_id_.data(), kSoh,
+            static_cast<unsigned long long>(sequence_), kSoh, sending_time, kSoh,
+            static_cast<unsigned long long>(order.order_id), kSoh,
+            static_cast<unsigned long long>(order.order_id), kSoh,
+            static_cast<unsigned long long>(sequence_), kSoh,
+            exec_type, kSoh, exec_type, kSoh,
+            order.instrument, kSoh,
+            order.side == Side::Buy ? '1' : '2', kSoh,
+            order.quantity, kSoh,
+            static_cast<long long>(order.price), kSoh,
+            leaves, kSoh, kSoh, kSoh,
+            transact_time, kSoh);
+        if (body_length <= 0 || static_cast<std::size_t>(body_length) >= sizeof(body)) [[unlikely]] {
+            return;
+        }
+
+        char header[32];
+        const int header_length = std::snprintf(header, sizeof(header), "8=FIX.4.4%c9=%d%c", kSoh, body_length, kSoh);
+        const std::size_t start = buffer_.size();
+        buffer_.insert(buffer_.end(), header, header + header_length);
+        buffer_.insert(buffer_.end(), body, body + body_length);
+
+        char trailer[16];
+        const unsigned checksum = FixChecksum(buffer_.data() + start, buffer_.size() - start);
+        const int trailer_length = std::snprintf(trailer, sizeof(trailer), "10=%03u%c", checksum, kSoh);
+        buffer_.insert(buffer_.end(), trailer, trailer + trailer_length);
+    }
+
+    void WriteFile(const char* data, std::size_t size) noexcept
+    {
+        if (file_fd_ < 0) {
+            return;
+        }
+        while (size > 0) {
+            const ssize_t written = ::write(file_fd_, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ++file_errors_;
+                return;
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+
+    void SendTcp(const char* data, std::size_t size) noexcept
+    {
+        if (socket_fd_ < 0) {
+            return;
+        }
+        if (!pending_tcp_.empty()) {
+            FlushTcp();
+        }
+        if (pending_tcp_.empty()) {
+            const ssize_t sent = ::send(socket_fd_, data, size, MSG_NOSIGNAL);
+            if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                tcp_dropped_bytes_ += size;
+                CloseSocket();
+                return;
+            }
+            const std::size_t done = sent > 0 ? static_cast<std::size_t>(sent) : 0;
+            data += done;
+            size -= done;
+        }
+        if (size == 0) {
+            return;
+        }
+        if (pending_tcp_.size() + size > kMaxPendingTcp) {
+            // Consumer is too slow, give up on it instead of blocking the file
+            tcp_dropped_bytes_ += pending_tcp_.size() + size;
+            CloseSocket();
+            return;
+        }
+        pending_tcp_.insert(pending_tcp_.end(), data, data + size);
+    }
+
+    void FlushTcp() noexcept
+    {
+        if (socket_fd_ < 0 || pending_tcp_.empty()) {
+            return;
+        }
+        const ssize_t sent = ::send(socket_fd_, pending_tcp_.data(), pending_tcp_.size(), MSG_NOSIGNAL);
+        if (sent > 0) {
+            pending_tcp_.erase(pending_tcp_.begin(), pending_tcp_.begin() + sent);
+        } else if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            tcp_dropped_bytes_ += pending_tcp_.size();
+            CloseSocket();
+        }
+    }
+
+    void CloseSocket() noexcept
+    {
+        if (socket_fd_ >= 0) {
+            ::close(socket_fd_);
+            socket_fd_ = -1;
+        }
+        pending_tcp_.clear();
+    }
+
+    DropCopyQueue& queue_;
+    DropCopyFormat format_;
+    std::vector<char> buffer_;
+    std::vector<char> pending_tcp_;
+    int file_fd_ = -1;
+    int socket_fd_ = -1;
+    std::uint64_t sequence_ = 0;
+    double ticks_per_ns_;
+    std::uint64_t anchor_tsc_;
+    std::int64_t anchor_utc_ns_;
+    std::array<char, 16> sender_comp_id_ {};
+    std::array<char, 16> target_comp_id_ {};
+    std::uint64_t written_ = 0;
+    std::uint64_t file_errors_ = 0;
+    std::uint64_t tcp_dropped_bytes_ = 0;
+};
+
+} // namespace hft::core
@@ -0,0 +1,186 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <type_traits>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace hft::core {
+
+/**
+ * @brief SPSC Ring Buffer whose consumer may sleep in epoll
+ *
+ * While the consumer spins it is a plain SPSC ring. Before blocking in
+ * epoll_wait the consumer calls PrepareToSleep(), which advertises that it
+ * is sleeping and re-checks the ring; the first Push after that writes the
+ * eventfd and clears the flag, later pushes do not touch the kernel.
+ *
+ * The flag/tail handshake is a Dekker pattern, so Push pays one seq_cst
+ * fence on top of the SPSC push; no lock and no syscall unless the
+ * consumer is actually asleep.
+ *
+ * Typical consumer loop:
+ *   epoll_ctl(ep, EPOLL_CTL_ADD, ring.EventFd(), ...) once
+ *   while (running) {
+ *       while (ring.Pop(v)) handle(v);
+ *       if (ring.PrepareToSleep()) { epoll_wait(ep, ...); ring.OnWake(); }
+ *   }
+ *
+ * @tparam T
+ * @tparam Capacity
+ */
+template <typename T, std::size_t Capacity>
+class EventFdRingBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
+    static_assert((Capacity != 0u) && ((Capacity & (Capacity - 1)) == 0), "Capacity must be power of 2.");
+
+    static constexpr std::size_t Mask = Capacity - 1;
+
+public:
+    EventFdRingBuffer() noexcept
+        : event_fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+    }
+
+    ~EventFdRingBuffer()
+    {
+        if (event_fd_ >= 0) {
+            ::close(event_fd_);
+        }
+    }
+
+    EventFdRingBuffer(const EventFdRingBuffer&) = delete;
+    auto operator=(const EventFdRingBuffer&) -> EventFdRingBuffer& = delete;
+    EventFdRingBuffer(EventFdRingBuffer&&) = delete;
+    auto operator=(EventFdRingBuffer&&) -> EventFdRingBuffer& = delete;
+
+    /**
+     * @brief Producer side
+     *
+     * @param value
+     * @return true
+     * @return false
+     */
+    [[nodiscard]] auto Push(const T& value) noexcept -> bool
+    {
+        const std::size_t curr_tail = tail.load(std::memory_order_relaxed);
+        const std::size_t next_tail = (curr_tail + 1) & Mask;
+
+        if (next_tail == head.load(std::memory_order_acquire)) [[unlikely]] {
+            drop_count.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        buffer_[curr_tail] = value;
+        tail.store(next_tail, std::memory_order_release);
+
+        // Pairs with the fence in PrepareToSleep: either we see the flag or the consumer sees the tail
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed) && sleeping.exchange(false, std::memory_order_relaxed)) [[unlikely]] {
+            Signal();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Consumer side
+     *
+     * @param out_value
+     * @return true
+     * @return false
+     */
+    [[nodiscard]] auto Pop(T& out_value) noexcept -> bool
+    {
+        const std::size_t curr_head = head.load(std::memory_order_relaxed);
+
+        if (curr_head == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        out_value = buffer_[curr_head];
+        head.store((curr_head + 1) & Mask, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side, announce sleeping and re-check the ring
+     *
+     * @return true when the consumer may block on EventFd()
+     * @return false when data arrived meanwhile, keep draining
+     */
+    [[nodiscard]] auto PrepareToSleep() noexcept -> bool
+    {
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (head.load(std::memory_order_relaxed) != tail.load(std::memory_order_acquire)) {
+            sleeping.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Consumer side, call after epoll_wait returns for any reason
+     *
+     * Clears the sleeping flag and resets the eventfd counter.
+     */
+    void OnWake() noexcept
+    {
+        sleeping.store(false, std::memory_order_relaxed);
+        std::uint64_t count = 0;
+        while (::read(event_fd_, &count, sizeof(count)) < 0 && errno == EINTR) {
+        }
+    }
+
+    /**
+     * @brief Non blocking eventfd to register with epoll (EPOLLIN), -1 if creation failed
+     *
+     */
+    [[nodiscard]] auto EventFd() const noexcept -> int
+    {
+        return event_fd_;
+    }
+
+    [[nodiscard]] auto GetDropCount() const noexcept -> std::size_t
+    {
+        return drop_count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of eventfd writes, i.e. consumer wake ups caused by the ring
+     *
+     */
+    [[nodiscard]] auto GetSignalCount() const noexcept -> std::size_t
+    {
+        return signal_count.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto Empty() const noexcept -> bool
+    {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_relaxed);
+    }
+
+private:
+    void Signal() noexcept
+    {
+        const std::uint64_t one = 1;
+        while (::write(event_fd_, &one, sizeof(one)) < 0 && errno == EINTR) {
+        }
+        signal_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    alignas(64) std::array<T, Capacity> buffer_ {};
+
+    alignas(64) std::atomic<std::size_t> tail { 0 }; // Producer controlled
+    alignas(64) std::atomic<std::size_t> head { 0 }; // Consumer controlled
+    alignas(64) std::atomic<bool> sleeping { false }; // Consumer sets, producer clears
+
+    alignas(64) std::atomic<std::size_t> drop_count { 0 };
+    std::atomic<std::size_t> signal_count { 0 };
+    int event_fd_;
+};
+
+} // namespace hft::core
@@ -0,0 +1,141 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include "MarketData.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Wire format of the (synthetic) market data feed, one event per packet
+ *
+ */
+struct FeedPacket {
+    std::uint64_t send_timestamp = 0; /// TSC at the source, carried into MarketEvent::timestamp
+    std::uint64_t sequence = 0;
+    std::int64_t price = 0;
+    std::uint32_t instrument = 0;
+    std::uint32_t quantity = 0;
+    std::uint8_t action = 0;
+    std::uint8_t side = 0;
+    std::uint8_t padding[6] {};
+};
+
+static_assert(std::is_trivially_copyable_v<FeedPacket>, "FeedPacket must be trivially copyable.");
+static_assert(sizeof(FeedPacket) == 40, "FeedPacket layout is part of the wire format.");
+
+/**
+ * @brief Encode an event into a packet, used by simulators and replay
+ *
+ * @param event
+ * @return FeedPacket
+ */
+[[nodiscard]] inline auto EncodePacket(const MarketEvent& event) noexcept -> FeedPacket
+{
+    FeedPacket packet;
+    packet.send_timestamp = event.timestamp;
+    packet.sequence = event.sequence;
+    packet.price = event.price;
+    packet.instrument = event.instrument;
+    packet.quantity = event.quantity;
+    packet.action = static_cast<std::uint8_t>(event.action);
+    packet.side = static_cast<std::uint8_t>(event.side);
+    return packet;
+}
+
+/**
+ * @brief Decode a packet, rejecting out of range enums
+ *
+ * @param packet
+ * @param out_event
+ * @return true
+ * @return false
+ */
+[[nodiscard]] inline auto DecodePacket(const FeedPacket& packet, MarketEvent& out_event) noexcept -> bool
+{
+    if (packet.action > static_cast<std::uint8_t>(BookAction::Trade) || packet.side > static_cast<std::uint8_t>(Side::Sell)) [[unlikely]] {
+        return false;
+    }
+    out_event.timestamp = packet.send_timestamp;
+    out_event.sequence = packet.sequence;
+    out_event.price = packet.price;
+    out_event.instrument = packet.instrument;
+    out_event.quantity = packet.quantity;
+    out_event.action = static_cast<BookAction>(packet.action);
+    out_event.side = static_cast<Side>(packet.side);
+    return true;
+}
+
+/**
+ * @brief Ring adaptor that encodes MarketEvents into FeedPackets on Push
+ *
+ * Lets LoadGenerator drive a raw packet ring directly.
+ *
+ * @tparam Ring ring of FeedPacket
+ */
+template <typename Ring>
+class PacketEncodingRing {
+public:
+    explicit PacketEncodingRing(Ring& ring) noexcept
+        : ring_(ring)
+    {
+    }
+
+    [[nodiscard]] auto Push(const MarketEvent& event) noexcept -> bool
+    {
+        return ring_.Push(EncodePacket(event));
+    }
+
+private:
+    Ring& ring_;
+};
+
+/**
+ * @brief First stage, decodes raw packets from one or more feed lines
+ *
+ */
+class FeedHandler {
+public:
+    /**
+     * @brief Decode up to max_burst packets from in into out
+     *
+     * @tparam InRing ring of FeedPacket
+     * @tparam OutRing ring of MarketEvent
+     * @return std::size_t number of forwarded events
+     */
+    template <typename InRing, typename OutRing>
+    auto Poll(InRing& in, OutRing& out, std::size_t max_burst = 32) noexcept -> std::size_t
+    {
+        std::size_t forwarded = 0;
+        FeedPacket packet;
+        MarketEvent event;
+        while (forwarded < max_burst && in.Pop(packet)) {
+            if (!DecodePacket(packet, event)) [[unlikely]] {
+                ++malformed_;
+                continue;
+            }
+            // Downstream full means the event is lost, a real feed would trigger recovery here
+            if (!out.Push(event)) [[unlikely]] {
+                ++dropped_;
+                continue;
+            }
+            ++forwarded;
+        }
+        return forwarded;
+    }
+
+    [[nodiscard]] auto GetMalformedCount() const noexcept -> std::uint64_t
+    {
+        return malformed_;
+    }
+
+    [[nodiscard]] auto GetDropCount() const noexcept -> std::uint64_t
+    {
+        return dropped_;
+    }
+
+private:
+    std::uint64_t malformed_ = 0;
+    std::uint64_t dropped_ = 0;
+};
+
+} // namespace hft::core
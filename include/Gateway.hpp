@@ -0,0 +1,130 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "AllocationGuard.hpp"
+#include "KillSwitch.hpp"
+#include "OrderEncoder.hpp"
+#include "OrderEvent.hpp"
+#include "Profile.hpp"
+#include "Tsc.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Last stage, hands encoded orders to the transport
+ *
+ * @tparam Transport anything with void Send(const EncodedOrder&), sends
+ *                   bytes[0, length); a socket in production, a recorder in
+ *                   tests and benchmarks
+ */
+template <typename Transport>
+class Gateway {
+public:
+    explicit Gateway(Transport& transport) noexcept
+        : transport_(transport)
+    {
+    }
+
+    /**
+     * @brief Send up to max_burst orders from in
+     *
+     * Under an exchange throttle, poll a CoalescingOrderQueue with the
+     * remaining message budget so unsent amends collapse while they wait.
+     *
+     * @tparam InRing ring of EncodedOrder, or a CoalescingOrderQueue
+     * @return std::size_t number of sent orders
+     */
+    template <typename InRing>
+    auto Poll(InRing& in, std::size_t max_burst = 32) noexcept -> std::size_t
+    {
+        if (kill_switch_ != nullptr && kill_switch_->IsTripped()) [[unlikely]] {
+            return OnKill(in, max_burst);
+        }
+
+        std::size_t sent = 0;
+        EncodedOrder order;
+        while (sent < max_burst && in.Pop(order)) {
+            HFT_PROFILE_SCOPE("gateway.send");
+            HFT_HOT_PATH_SCOPE();
+            transport_.Send(order);
+            if (drop_copy_ != nullptr) {
+                // The only audit cost on this path, a lost push shows up in the queue's drop count
+                (void)drop_copy_->Push(OrderEvent { ReadTsc(), order, OrderEventType::Sent });
+            }
+            ++sent;
+        }
+        sent_ += sent;
+        return sent;
+    }
+
+    [[nodiscard]] auto GetSentCount() const noexcept -> std::uint64_t
+    {
+        return sent_;
+    }
+
+    /**
+     * @brief Report every sent order to the drop copy stage, nullptr detaches
+     *
+     */
+    void AttachDropCopy(DropCopyQueue* queue) noexcept
+    {
+        drop_copy_ = queue;
+    }
+
+    /**
+     * @brief Watch kill_switch; on each trip send cancel_templates once and stop sending orders
+     *
+     * Templates are encoded up front (OrderEncoder::EncodeMassCancel) so the
+     * trip path is only transport sends. Cold path, copies the templates.
+     */
+    void ArmKillSwitch(const KillSwitch* kill_switch, std::vector<EncodedOrder> cancel_templates)
+    {
+        kill_switch_ = kill_switch;
+        cancel_templates_ = std::move(cancel_templates);
+    }
+
+    /**
+     * @brief Orders dropped because the kill switch was tripped
+     *
+     */
+    [[nodiscard]] auto GetKilledCount() const noexcept -> std::uint64_t
+    {
+        return killed_;
+    }
+
+private:
+    template <typename InRing>
+    auto OnKill(InRing& in, std::size_t max_burst) noexcept -> std::size_t
+    {
+        const std::uint32_t generation = kill_switch_->Generation();
+        if (generation != handled_generation_) {
+            handled_generation_ = generation;
+            for (const EncodedOrder& cancel : cancel_templates_) {
+                transport_.Send(cancel);
+                if (drop_copy_ != nullptr) {
+                    (void)drop_copy_->Push(OrderEvent { ReadTsc(), cancel, OrderEventType::Cancelled });
+                }
+            }
+            sent_ += cancel_templates_.size();
+        }
+        // Orders already queued must not leave after the trip
+        EncodedOrder order;
+        std::size_t discarded = 0;
+        while (discarded < max_burst && in.Pop(order)) {
+            ++discarded;
+        }
+        killed_ += discarded;
+        return 0;
+    }
+
+    Transport& transport_;
+    DropCopyQueue* drop_copy_ = nullptr;
+    const KillSwitch* kill_switch_ = nullptr;
+    std::vector<EncodedOrder> cancel_templates_;
+    std::uint32_t handled_generation_ = 0;
+    std::uint64_t killed_ = 0;
+    std::uint64_t sent_ = 0;
+};
+
+} // namespace hft::core
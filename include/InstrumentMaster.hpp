@@ -0,0 +1,439 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hft::core {
+
+/**
+ * @brief Fixed size instrument record as stored in the file
+ *
+ * The symbol lives in the string table at symbol_offset.
+ */
+struct InstrumentRecord {
+    std::uint32_t instrument_id = 0;
+    std::uint32_t symbol_offset = 0;
+    std::uint16_t symbol_length = 0;
+    std::uint16_t venue = 0;
+    std::uint32_t lot_size = 0;
+    std::int64_t tick_size = 0; /// in price units
+    std::int64_t multiplier = 0;
+    std::uint8_t reserved[32] {};
+};
+
+static_assert(std::is_trivially_copyable_v<InstrumentRecord>, "InstrumentRecord must be trivially copyable.");
+static_assert(sizeof(InstrumentRecord) == 64, "InstrumentRecord is one cache line on disk.");
+
+/**
+ * @brief Instrument definition used to build the file
+ *
+ */
+struct InstrumentDefinition {
+    std::uint32_t instrument_id = 0;
+    std::string symbol;
+    std::uint16_t venue = 0;
+    std::uint32_t lot_size = 1;
+    std::int64_t tick_size = 1;
+    std::int64_t multiplier = 1;
+};
+
+namespace detail {
+
+    /**
+     * @brief File layout: header | records | id index | symbol index | strings
+     *
+     * Indexes are open addressing tables of record index + 1 (0 is empty),
+     * bucket_count is a power of two, at most half full.
+     */
+    struct InstrumentFileHeader {
+        static constexpr std::uint64_t kMagic = 0x5254534D49544648ULL; // "HFTIMSTR"
+        static constexpr std::uint32_t kVersion = 2; // 2: mixed id hash
+
+        std::uint64_t magic = kMagic;
+        std::uint32_t version = kVersion;
+        std::uint32_t record_count = 0;
+        std::uint32_t bucket_count = 0;
+        std::uint32_t reserved = 0;
+        std::uint64_t records_offset = 0;
+        std::uint64_t id_index_offset = 0;
+        std::uint64_t symbol_index_offset = 0;
+        std::uint64_t strings_offset = 0;
+        std::uint64_t file_size = 0;
+    };
+
+    static_assert(sizeof(InstrumentFileHeader) == 64, "Header is one cache line.");
+
+    /**
+     * @brief Full avalanche (murmur3 finalizer), every output bit depends on every input bit
+     *
+     * Buckets are taken from the low bits; a bare multiply would leave them a
+     * function of the id's low bits only, and ids with a power of two stride
+     * would all share one probe chain.
+     */
+    inline auto HashId(std::uint32_t id) noexcept -> std::uint64_t
+    {
+        std::uint64_t hash = id;
+        hash ^= hash >> 33U;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33U;
+        hash *= 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 33U;
+        return hash;
+    }
+
+    inline auto HashSymbol(std::string_view symbol) noexcept -> std::uint64_t
+    {
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (const char c : symbol) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+} // namespace detail
+
+/**
+ * @brief Builds a compiled instrument master file, offline / cold path
+ *
+ */
+class InstrumentMasterWriter {
+public:
+    void Add(InstrumentDefinition definition)
+    {
+        definitions_.push_back(std::move(definition));
+    }
+
+    /**
+     * @brief Write the file next to path and rename it into place
+     *
+     * Processes that still map the old file keep a consistent view. The
+     * temporary file has a unique name, so concurrent writers do not clobber
+     * each other, and it is synced before the rename and the directory
+     * after, so a crash leaves either the old or the complete new file.
+     *
+     * @param path
+     * @return true
+     * @return false on I/O error, duplicate id, duplicate symbol or too long symbol
+     */
+    [[nodiscard]] auto Write(const std::string& path) const -> bool
+    {
+        using Header = detail::InstrumentFileHeader;
+
+        std::uint32_t bucket_count = 16;
+        while (bucket_count < definitions_.size() * 2) {
+            bucket_count *= 2;
+        }
+        const std::uint32_t mask = bucket_count - 1;
+
+        std::vector<InstrumentRecord> records(definitions_.size());
+        std::vector<std::uint32_t> id_index(bucket_count, 0);
+        std::vector<std::uint32_t> symbol_index(bucket_count, 0);
+        std::string strings;
+
+        for (std::size_t i = 0; i < definitions_.size(); ++i) {
+            const InstrumentDefinition& definition = definitions_[i];
+            if (definition.symbol.size() > UINT16_MAX) {
+                return false;
+            }
+            InstrumentRecord& record = records[i];
+            record.instrument_id = definition.instrument_id;
+            record.symbol_offset = static_cast<std::uint32_t>(strings.size());
+            record.symbol_length = static_cast<std::uint16_t>(definition.symbol.size());
+            record.venue = definition.venue;
+            record.lot_size = definition.lot_size;
+            record.tick_size = definition.tick_size;
+            record.multiplier = definition.multiplier;
+            strings += definition.symbol;
+
+            std::uint64_t bucket = detail::HashId(definition.instrument_id);
+            while (id_index[bucket & mask] != 0) {
+                if (records[id_index[bucket & mask] - 1].instrument_id == definition.instrument_id) {
+                    return false;
+                }
+                ++bucket;
+            }
+            id_index[bucket & mask] = static_cast<std::uint32_t>(i + 1);
+
+            bucket = detail::HashSymbol(definition.symbol);
+            while (symbol_index[bucket & mask] != 0) {
+                if (definitions_[symbol_index[bucket & mask] - 1].symbol == definition.symbol) {
+                    return false;
+                }
+                ++bucket;
+            }
+            symbol_index[bucket & mask] = static_cast<std::uint32_t>(i + 1);
+        }
+
+        Header header;
+        header.record_count = static_cast<std::uint32_t>(records.size());
+        header.bucket_count = bucket_count;
+        header.records_offset = sizeof(Header);
+        header.id_index_offset = header.records_offset + (records.size() * sizeof(InstrumentRecord));
+        header.symbol_index_offset = header.id_index_offset + (bucket_count * sizeof(std::uint32_t));
+        header.strings_offset = header.symbol_index_offset + (bucket_count * sizeof(std::uint32_t));
+        header.file_size = header.strings_offset + strings.size();
+
+        std::string temporary = path + ".XXXXXX";
+        const int fd = ::mkstemp(temporary.data());
+        if (fd < 0) {
+            return false;
+        }
+        // mkstemp creates 0600, the master is read by other users' processes
+        std::FILE* file = ::fchmod(fd, 0644) == 0 ? ::fdopen(fd, "wb") : nullptr;
+        if (file == nullptr) {
+            ::close(fd);
+            std::remove(temporary.c_str());
+            return false;
+        }
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = ok && (records.empty() || std::fwrite(records.data(), sizeof(InstrumentRecord), records.size(), file) == records.size());
+        ok = ok && std::fwrite(id_index.data(), sizeof(std::uint32_t), id_index.size(), file) == id_index.size();
+        ok = ok && std::fwrite(symbol_index.data(), sizeof(std::uint32_t), symbol_index.size(), file) == symbol_index.size();
+        ok = ok && (strings.empty() || std::fwrite(strings.data(), 1, strings.size(), file) == strings.size());
+        ok = ok && std::fflush(file) == 0 && ::fsync(fd) == 0;
+        ok = (std::fclose(file) == 0) && ok;
+        if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return SyncDirectory(path);
+    }
+
+private:
+    // Makes the rename durable
+    static auto SyncDirectory(const std::string& path) noexcept -> bool
+    {
+        const std::size_t slash = path.rfind('/');
+        const std::string directory = slash == std::string::npos ? std::string(".") : (slash == 0 ? std::string("/") : path.substr(0, slash));
+        const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) {
+            return false;
+        }
+        const bool ok = ::fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+    }
+
+    std::vector<InstrumentDefinition> definitions_;
+};
+
+/**
+ * @brief Read only, memory mapped view of a compiled instrument master
+ *
+ * The mapping is MAP_SHARED so every process on the host shares the same
+ * page cache pages. Lookups are a hash probe over the mapped index and
+ * return pointers into the mapping, valid until Close() / destruction.
+ */
+class InstrumentMaster {
+public:
+    InstrumentMaster() = default;
+
+    ~InstrumentMaster()
+    {
+        Close();
+    }
+
+    InstrumentMaster(const InstrumentMaster&) = delete;
+    auto operator=(const InstrumentMaster&) -> InstrumentMaster& = delete;
+
+    InstrumentMaster(InstrumentMaster&& other) noexcept
+    {
+        Take(other);
+    }
+
+    auto operator=(InstrumentMaster&& other) noexcept -> InstrumentMaster&
+    {
+        if (this != &other) {
+            Close();
+            Take(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Map path and validate its layout
+     *
+     * @param path
+     * @param prefault fault all pages in now (MAP_POPULATE) instead of on first lookup
+     * @return true
+     * @return false when the file is missing, truncated or of another format
+     */
+    [[nodiscard]] auto Open(const char* path, bool prefault = true) noexcept -> bool
+    {
+        using Header = detail::InstrumentFileHeader;
+        Close();
+
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat status {};
+        if (::fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(Header)) {
+            ::close(fd);
+            return false;
+        }
+        const auto size = static_cast<std::size_t>(status.st_size);
+        int flags = MAP_SHARED;
+#if defined(MAP_POPULATE)
+        if (prefault) {
+            flags |= MAP_POPULATE;
+        }
+#else
+        (void)prefault;
+#endif
+        void* base = ::mmap(nullptr, size, PROT_READ, flags, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            return false;
+        }
+        base_ = static_cast<const std::uint8_t*>(base);
+        size_ = size;
+
+        const auto* header = reinterpret_cast<const Header*>(base_);
+        const std::uint64_t bucket_bytes = static_cast<std::uint64_t>(header->bucket_count) * sizeof(std::uint32_t);
+        const bool valid = header->magic == Header::kMagic && header->version == Header::kVersion
+            && header->file_size == size && header->bucket_count != 0 && (header->bucket_count & (header->bucket_count - 1)) == 0
+            && header->records_offset == sizeof(Header)
+            && header->id_index_offset == header->records_offset + (static_cast<std::uint64_t>(header->record_count) * sizeof(InstrumentRecord))
+            && header->symbol_index_offset == header->id_index_offset + bucket_bytes
+            && header->strings_offset == header->symbol_index_offset + bucket_bytes
+            && header->strings_offset <= size;
+        if (!valid) {
+            Close();
+            return false;
+        }
+
+        records_ = reinterpret_cast<const InstrumentRecord*>(base_ + header->records_offset);
+        id_index_ = reinterpret_cast<const std::uint32_t*>(base_ + header->id_index_offset);
+        symbol_index_ = reinterpret_cast<const std::uint32_t*>(base_ + header->symbol_index_offset);
+        strings_ = reinterpret_cast<const char*>(base_ + header->strings_offset);
+        strings_size_ = size - header->strings_offset;
+        count_ = header->record_count;
+        mask_ = header->bucket_count - 1;
+        return true;
+    }
+
+    void Close() noexcept
+    {
+        if (base_ != nullptr) {
+            ::munmap(const_cast<std::uint8_t*>(base_), size_);
+        }
+        base_ = nullptr;
+        size_ = 0;
+        count_ = 0;
+    }
+
+    /**
+     * @brief Record of instrument id, nullptr when unknown
+     *
+     */
+    [[nodiscard]] auto FindById(std::uint32_t instrument_id) const noexcept -> const InstrumentRecord*
+    {
+        if (count_ == 0) {
+            return nullptr;
+        }
+        std::uint64_t bucket = detail::HashId(instrument_id);
+        // Bounded so a damaged index cannot spin forever
+        for (std::uint32_t probe = 0; probe <= mask_; ++probe, ++bucket) {
+            const std::uint32_t slot = id_index_[bucket & mask_];
+            if (slot == 0) {
+                return nullptr;
+            }
+            if (slot <= count_ && records_[slot - 1].instrument_id == instrument_id) {
+                return &records_[slot - 1];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Record of symbol, nullptr when unknown
+     *
+     */
+    [[nodiscard]] auto FindBySymbol(std::string_view symbol) const noexcept -> const InstrumentRecord*
+    {
+        if (count_ == 0) {
+            return nullptr;
+        }
+        std::uint64_t bucket = detail::HashSymbol(symbol);
+        // Bounded so a damaged index cannot spin forever
+        for (std::uint32_t probe = 0; probe <= mask_; ++probe, ++bucket) {
+            const std::uint32_t slot = symbol_index_[bucket & mask_];
+            if (slot == 0) {
+                return nullptr;
+            }
+            if (slot <= count_ && Symbol(records_[slot - 1]) == symbol) {
+                return &records_[slot - 1];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Symbol of a record of this file
+     *
+     */
+    [[nodiscard]] auto Symbol(const InstrumentRecord& record) const noexcept -> std::string_view
+    {
+        if (static_cast<std::size_t>(record.symbol_offset) + record.symbol_length > strings_size_) [[unlikely]] {
+            return {};
+        }
+        return { strings_ + record.symbol_offset, record.symbol_length };
+    }
+
+    /**
+     * @brief All records in file order
+     *
+     */
+    [[nodiscard]] auto Records() const noexcept -> const InstrumentRecord*
+    {
+        return records_;
+    }
+
+    [[nodiscard]] auto Size() const noexcept -> std::uint32_t
+    {
+        return count_;
+    }
+
+    [[nodiscard]] auto IsOpen() const noexcept -> bool
+    {
+        return base_ != nullptr;
+    }
+
+private:
+    void Take(InstrumentMaster& other) noexcept
+    {
+        base_ = std::exchange(other.base_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        records_ = other.records_;
+        id_index_ = other.id_index_;
+        symbol_index_ = other.symbol_index_;
+        strings_ = other.strings_;
+        strings_size_ = other.strings_size_;
+        count_ = std::exchange(other.count_, 0);
+        mask_ = other.mask_;
+    }
+
+    const std::uint8_t* base_ = nullptr;
+    std::size_t size_ = 0;
+    const InstrumentRecord* records_ = nullptr;
+    const std::uint32_t* id_index_ = nullptr;
+    const std::uint32_t* symbol_index_ = nullptr;
+    const char* strings_ = nullptr;
+    std::size_t strings_size_ = 0;
+    std::uint32_t count_ = 0;
+    std::uint32_t mask_ = 0;
+};
+
+} // namespace hft::core
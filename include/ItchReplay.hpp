@@ -0,0 +1,861 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Affinity.hpp"
+#include "MarketData.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Nasdaq TotalView-ITCH 5.0 framing as found in historical files
+ *
+ * Each message is a 2 byte big endian length followed by the message;
+ * every message starts with type (1), stock locate (2), tracking number
+ * (2) and a 6 byte timestamp in ns since midnight. Prices are 4 implied
+ * decimals.
+ */
+namespace itch {
+
+    inline constexpr std::size_t kLengthPrefix = 2;
+    inline constexpr std::size_t kLocateCount = 65536;
+
+    /**
+     * @brief Fixed length of each message type, 0 for unknown types
+     *
+     */
+    constexpr auto MessageLength(std::uint8_t type) noexcept -> std::uint16_t
+    {
+        switch (type) {
+        case 'S':
+            return 12;
+        case 'R':
+            return 39;
+        case 'H':
+            return 25;
+        case 'Y':
+            return 20;
+        case 'L':
+            return 26;
+        case 'V':
+            return 35;
+        case 'W':
+            return 12;
+        case 'K':
+            return 28;
+        case 'J':
+            return 35;
+        case 'h':
+            return 21;
+        case 'A':
+            return 36;
+        case 'F':
+            return 40;
+        case 'E':
+            return 31;
+        case 'C':
+            return 36;
+        case 'X':
+            return 23;
+        case 'D':
+            return 19;
+        case 'U':
+            return 35;
+        case 'P':
+            return 44;
+        case 'Q':
+            return 40;
+        case 'B':
+            return 19;
+        case 'I':
+            return 50;
+        case 'N':
+            return 20;
+        case 'O':
+            return 48;
+        default:
+            return 0;
+        }
+    }
+
+    /**
+     * @brief Messages that change the L3 book of their stock locate
+     *
+     */
+    constexpr auto IsBookMessage(std::uint8_t type) noexcept -> bool
+    {
+        return type == 'A' || type == 'F' || type == 'E' || type == 'C' || type == 'X' || type == 'D' || type == 'U';
+    }
+
+    template <std::size_t Bytes>
+    inline auto LoadBig(const std::uint8_t* data) noexcept -> std::uint64_t
+    {
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < Bytes; ++i) {
+            value = (value << 8U) | data[i];
+        }
+        return value;
+    }
+
+    template <std::size_t Bytes>
+    inline void StoreBig(std::uint8_t* data, std::uint64_t value) noexcept
+    {
+        for (std::size_t i = 0; i < Bytes; ++i) {
+            data[Bytes - 1 - i] = static_cast<std::uint8_t>(value >> (8 * i));
+        }
+    }
+
+    inline auto Locate(const std::uint8_t* message) noexcept -> std::uint16_t
+    {
+        return static_cast<std::uint16_t>(LoadBig<2>(message + 1));
+    }
+
+    inline auto Timestamp(const std::uint8_t* message) noexcept -> std::uint64_t
+    {
+        return LoadBig<6>(message + 5);
+    }
+
+} // namespace itch
+
+/**
+ * @brief Builds ITCH 5.0 files, for simulators, tests and benchmarks
+ *
+ */
+class ItchWriter {
+public:
+    void StockDirectory(std::uint16_t locate, std::string_view symbol)
+    {
+        std::uint8_t* message = Begin('R', locate, 0);
+        std::memset(message + 11, ' ', 8);
+        std::memcpy(message + 11, symbol.data(), symbol.size() < 8 ? symbol.size() : 8);
+    }
+
+    void AddOrder(std::uint16_t locate, std::uint64_t timestamp, std::uint64_t ref, Side side, std::uint32_t shares, std::uint32_t price)
+    {
+        std::uint8_t* message = Begin('A', locate, timestamp);
+        itch::StoreBig<8>(message + 11, ref);
+        message[19] = side == Side::Buy ? 'B' : 'S';
+        itch::StoreBig<4>(message + 20, shares);
+        std::memset(message + 24, ' ', 8);
+        itch::StoreBig<4>(message + 32, price);
+    }
+
+    void Execute(std::uint16_t locate, std::uint64_t timestamp, std::uint64_t ref, std::uint32_t shares)
+    {
+        std::uint8_t* message = Begin('E', locate, timestamp);
+        itch::StoreBig<8>(message + 11, ref);
+        itch::StoreBig<4>(message + 19, shares);
+    }
+
+    void Cancel(std::uint16_t locate, std::uint64_t timestamp, std::uint64_t ref, std::uint32_t shares)
+    {
+        std::uint8_t* message = Begin('X', locate, timestamp);
+        itch::StoreBig<8>(message + 11, ref);
+        itch::StoreBig<4>(message + 19, shares);
+    }
+
+    void Delete(std::uint16_t locate, std::uint64_t timestamp, std::uint64_t ref)
+    {
+        std::uint8_t* message = Begin('D', locate, timestamp);
+        itch::StoreBig<8>(message + 11, ref);
+    }
+
+    void Replace(std::uint16_t locate, std::uint64_t timestamp, std::uint64_t ref, std::uint64_t new_ref, std::uint32_t shares, std::uint32_t price)
+    {
+        std::uint8_t* message = Begin('U', locate, timestamp);
+        itch::StoreBig<8>(message + 11, ref);
+        itch::StoreBig<8>(message + 19, new_ref);
+        itch::StoreBig<4>(message + 27, shares);
+        itch::StoreBig<4>(message + 31, price);
+    }
+
+    /**
+     * @brief Non-book message (system event), skipped by the index
+     *
+     */
+    void SystemEvent(std::uint64_t timestamp, char code)
+    {
+        std::uint8_t* message = Begin('S', 0, timestamp);
+        message[11] = static_cast<std::uint8_t>(code);
+    }
+
+    [[nodiscard]] auto Bytes() const noexcept -> const std::vector<std::uint8_t>&
+    {
+        return bytes_;
+    }
+
+private:
+    auto Begin(std::uint8_t type, std::uint16_t locate, std::uint64_t timestamp) -> std::uint8_t*
+    {
+        const std::uint16_t length = itch::MessageLength(type);
+        const std::size_t start = bytes_.size();
+        bytes_.resize(start + itch::kLengthPrefix + length, 0);
+        std::uint8_t* framed = bytes_.data() + start;
+        itch::StoreBig<2>(framed, length);
+        std::uint8_t* message = framed + itch::kLengthPrefix;
+        message[0] = type;
+        itch::StoreBig<2>(message + 1, locate);
+        itch::StoreBig<6>(message + 5, timestamp);
+        return message;
+    }
+
+    std::vector<std::uint8_t> bytes_;
+};
+
+/**
+ * @brief Aggregate of one side price
+ *
+ */
+struct L3Level {
+    std::int64_t price = 0;
+    std::uint64_t shares = 0;
+    std::uint32_t orders = 0;
+};
+
+/**
+ * @brief Order by order book of one instrument
+ *
+ * Resting orders are kept in an open addressing table keyed by order
+ * reference, price levels in ordered maps so snapshots can walk any depth.
+ * Meant for historical replay, where one book is only touched by one thread.
+ */
+class L3Book {
+public:
+    struct Order {
+        std::uint64_t ref = 0; /// 0 marks a free slot
+        std::int64_t price = 0;
+        std::uint32_t shares = 0;
+        Side side = Side::Buy;
+    };
+
+    L3Book()
+        : orders_(64)
+    {
+    }
+
+    auto Add(std::uint64_t ref, Side side, std::int64_t price, std::uint32_t shares) -> bool
+    {
+        if (ref == 0 || shares == 0 || Find(ref) != nullptr) {
+            return false;
+        }
+        if ((count_ + 1) * 2 > orders_.size()) {
+            Grow();
+        }
+        Insert(Order { ref, price, shares, side });
+        ++count_;
+        L3Level& level = Levels(side)[price];
+        level.price = price;
+        level.shares += shares;
+        ++level.orders;
+        return true;
+    }
+
+    /**
+     * @brief Remove shares from a resting order (execution or partial cancel)
+     *
+     */
+    auto Reduce(std::uint64_t ref, std::uint32_t shares) -> bool
+    {
+        Order* order = Find(ref);
+        if (order == nullptr) {
+            return false;
+        }
+        if (shares >= order->shares) {
+            return Delete(ref);
+        }
+        order->shares -= shares;
+        Levels(order->side)[order->price].shares -= shares;
+        return true;
+    }
+
+    auto Delete(std::uint64_t ref) -> bool
+    {
+        Order* order = Find(ref);
+        if (order == nullptr) {
+            return false;
+        }
+        auto& levels = Levels(order->side);
+        const auto level = levels.find(order->price);
+        level->second.shares -= order->shares;
+        if (--level->second.orders == 0) {
+            levels.erase(level);
+        }
+        Erase(order);
+        --count_;
+        return true;
+    }
+
+    /**
+     * @brief Cancel ref and add new_ref on the same side, losing priority
+     *
+     */
+    auto Replace(std::uint64_t ref, std::uint64_t new_ref, std::int64_t price, std::uint32_t shares) -> bool
+    {
+        const Order* order = Find(ref);
+        if (order == nullptr) {
+            return false;
+        }
+        const Side side = order->side;
+        return Delete(ref) && Add(new_ref, side, price, shares);
+    }
+
+    [[nodiscard]] auto BestBid() const noexcept -> L3Level
+    {
+        return bids_.empty() ? L3Level {} : bids_.rbegin()->second;
+    }
+
+    [[nodiscard]] auto BestAsk() const noexcept -> L3Level
+    {
+        return asks_.empty() ? L3Level {} : asks_.begin()->second;
+    }
+
+    /**
+     * @brief index-th best level of side, shares 0 past the last level
+     *
+     */
+    [[nodiscard]] auto Level(Side side, std::size_t index) const noexcept -> L3Level
+    {
+        if (index >= LevelCount(side)) {
+            return L3Level {};
+        }
+        if (side == Side::Buy) {
+            return std::next(bids_.rbegin(), static_cast<std::ptrdiff_t>(index))->second;
+        }
+        return std::next(asks_.begin(), static_cast<std::ptrdiff_t>(index))->second;
+    }
+
+    [[nodiscard]] auto LevelCount(Side side) const noexcept -> std::size_t
+    {
+        return side == Side::Buy ? bids_.size() : asks_.size();
+    }
+
+    [[nodiscard]] auto OrderCount() const noexcept -> std::size_t
+    {
+        return count_;
+    }
+
+    [[nodiscard]] auto FindOrder(std::uint64_t ref) const noexcept -> const Order*
+    {
+        return const_cast<L3Book*>(this)->Find(ref);
+    }
+
+private:
+    auto Levels(Side side) noexcept -> std::map<std::int64_t, L3Level>&
+    {
+        return side == Side::Buy ? bids_ : asks_;
+    }
+
+    auto Home(std::uint64_t ref) const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>((ref * 0x9E3779B97F4A7C15ULL) >> 32U) & (orders_.size() - 1);
+    }
+
+    auto Find(std::uint64_t ref) noexcept -> Order*
+    {
+        const std::size_t mask = orders_.size() - 1;
+        for (std::size_t index = Home(ref);; index = (index + 1) & mask) {
+            Order& order = orders_[index];
+            if (order.ref == ref) {
+                return &order;
+            }
+            if (order.ref == 0) {
+                return nullptr;
+            }
+        }
+    }
+
+    void Insert(const Order& order) noexcept
+    {
+        const std::size_t mask = orders_.size() - 1;
+        std::size_t index = Home(order.ref);
+        while (orders_[index].ref != 0) {
+            index = (index + 1) & mask;
+        }
+        orders_[index] = order;
+    }
+
+    // Backward shift deletion, no tombstones
+    void Erase(Order* order) noexcept
+    {
+        const std::size_t mask = orders_.size() - 1;
+        std::size_t hole = static_cast<std::size_t>(order - orders_.data());
+        for (std::size_t index = (hole + 1) & mask; orders_[index].ref != 0; index = (index + 1) & mask) {
+            const std::size_t home = Home(orders_[index].ref);
+            if (((index - home) & mask) >= ((index - hole) & mask)) {
+                orders_[hole] = orders_[index];
+                hole = index;
+            }
+        }
+        orders_[hole] = Order {};
+    }
+
+    void Grow()
+    {
+        std::vector<Order> old(orders_.size() * 2);
+        old.swap(orders_);
+        for (const Order& order : old) {
+            if (order.ref != 0) {
+                Insert(order);
+            }
+        }
+    }
+
+    std::vector<Order> orders_;
+    std::size_t count_ = 0;
+    std::map<std::int64_t, L3Level> bids_;
+    std::map<std::int64_t, L3Level> asks_;
+};
+
+/**
+ * @brief Apply one ITCH book message to book
+ *
+ * @param message points at the type byte
+ * @return true
+ * @return false for non-book messages and unknown order references
+ */
+inline auto ApplyItchMessage(L3Book& book, const std::uint8_t* message) -> bool
+{
+    using itch::LoadBig;
+    switch (message[0]) {
+    case 'A':
+    case 'F':
+        return book.Add(LoadBig<8>(message + 11), message[19] == 'B' ? Side::Buy : Side::Sell,
+            static_cast<std::int64_t>(LoadBig<4>(message + 32)), static_cast<std::uint32_t>(LoadBig<4>(message + 20)));
+    case 'E':
+    case 'C':
+    case 'X':
+        return book.Reduce(LoadBig<8>(message + 11), static_cast<std::uint32_t>(LoadBig<4>(message + 19)));
+    case 'D':
+        return book.Delete(LoadBig<8>(message + 11));
+    case 'U':
+        return book.Replace(LoadBig<8>(message + 11), LoadBig<8>(message + 19),
+            static_cast<std::int64_t>(LoadBig<4>(message + 31)), static_cast<std::uint32_t>(LoadBig<4>(message + 27)));
+    default:
+        return false;
+    }
+}
+
+struct ItchConfig {
+    unsigned threads = 1; /// scan chunks and replay workers
+    int cpu_base = -1; /// pin thread i to cpu_base + i, -1 leaves them floating
+    std::uint64_t snapshot_interval_ns = 0; /// snapshot every interval of exchange time, 0 only at the end
+};
+
+struct ItchStats {
+    std::uint64_t messages = 0;
+    std::uint64_t book_messages = 0;
+    std::uint64_t malformed = 0; /// truncated tail, zero length or book message shorter than its type
+    std::uint64_t rescanned_chunks = 0; /// chunks whose resync point was wrong and got rescanned
+    std::uint64_t rejected = 0; /// replayed messages referring to unknown orders
+    std::uint64_t snapshots = 0;
+
+    void Add(const ItchStats& other) noexcept
+    {
+        messages += other.messages;
+        book_messages += other.book_messages;
+        malformed += other.malformed;
+        rescanned_chunks += other.rescanned_chunks;
+        rejected += other.rejected;
+        snapshots += other.snapshots;
+    }
+};
+
+/**
+ * @brief Read only mapping of an ITCH file
+ *
+ */
+class ItchFile {
+public:
+    ItchFile() = default;
+
+    ~ItchFile()
+    {
+        Close();
+    }
+
+    ItchFile(const ItchFile&) = delete;
+    auto operator=(const ItchFile&) -> ItchFile& = delete;
+    ItchFile(ItchFile&&) = delete;
+    auto operator=(ItchFile&&) -> ItchFile& = delete;
+
+    [[nodiscard]] auto Open(const char* path) noexcept -> bool
+    {
+        Close();
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat status {};
+        if (::fstat(fd, &status) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<std::size_t>(status.st_size);
+        if (size_ == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* base = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            size_ = 0;
+            return false;
+        }
+        // The scan is sequential per chunk but replay jumps around, only prefetch
+        ::madvise(base, size_, MADV_WILLNEED);
+        data_ = static_cast<const std::uint8_t*>(base);
+        return true;
+    }
+
+    void Close() noexcept
+    {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<std::uint8_t*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    [[nodiscard]] auto Data() const noexcept -> const std::uint8_t*
+    {
+        return data_;
+    }
+
+    [[nodiscard]] auto Size() const noexcept -> std::size_t
+    {
+        return size_;
+    }
+
+private:
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+namespace detail {
+
+    template <typename Task>
+    void RunOnThreads(unsigned threads, int cpu_base, Task task)
+    {
+        auto run = [&](unsigned index) {
+            if (cpu_base >= 0) {
+                (void)PinThisThread(cpu_base + static_cast<int>(index));
+            }
+            task(index);
+        };
+        std::vector<std::thread> workers;
+        for (unsigned i = 1; i < threads; ++i) {
+            workers.emplace_back(run, i);
+        }
+        run(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+} // namespace detail
+
+/**
+ * @brief Offsets of every book message, grouped by stock locate in file order
+ *
+ * Build() splits the file into one chunk per thread. A chunk finds its
+ * first message boundary by looking for a run of messages whose length
+ * prefix matches their type's fixed length, then hops length prefixes and
+ * buckets book message offsets by locate. Chunk ends are checked against
+ * the next chunk's start afterwards and a chunk that synced on a false
+ * boundary is rescanned, so the index always equals a sequential pass.
+ * The per-chunk buckets are merged into one compressed array per locate.
+ */
+class ItchIndex {
+public:
+    struct Range {
+        const std::uint64_t* offsets = nullptr; /// of the type byte, in file order
+        std::size_t size = 0;
+    };
+
+    auto Build(const std::uint8_t* data, std::size_t size, const ItchConfig& config) -> ItchStats
+    {
+        const unsigned threads = config.threads == 0 ? 1 : config.threads;
+        std::vector<std::size_t> starts(threads + 1);
+        for (unsigned i = 0; i <= threads; ++i) {
+            starts[i] = size / threads * i;
+        }
+        starts[threads] = size;
+
+        std::vector<Chunk> chunks(threads);
+        detail::RunOnThreads(threads, config.cpu_base, [&](unsigned index) {
+            Chunk& chunk = chunks[index];
+            chunk.begin = index == 0 ? 0 : Resync(data, size, starts[index], starts[index + 1]);
+            chunk.end = Scan(data, size, chunk.begin, starts[index + 1], chunk);
+        });
+
+        // Chunk i must start where chunk i - 1 stopped
+        ItchStats stats;
+        std::size_t expected = chunks[0].end;
+        for (unsigned i = 1; i < threads; ++i) {
+            Chunk& chunk = chunks[i];
+            if (chunk.begin == expected) {
+                expected = chunk.end;
+                continue;
+            }
+            chunk = Chunk {};
+            chunk.begin = expected;
+            chunk.end = expected < starts[i + 1] ? Scan(data, size, expected, starts[i + 1], chunk) : expected;
+            expected = chunk.end;
+            ++stats.rescanned_chunks;
+        }
+        Merge(chunks, config);
+
+        for (const Chunk& chunk : chunks) {
+            stats.messages += chunk.messages;
+            stats.book_messages += chunk.book_messages;
+            stats.malformed += chunk.malformed;
+        }
+        return stats;
+    }
+
+    [[nodiscard]] auto Messages(std::uint16_t locate) const noexcept -> Range
+    {
+        if (starts_.empty()) {
+            return Range {};
+        }
+        return Range { offsets_.data() + starts_[locate], starts_[locate + 1] - starts_[locate] };
+    }
+
+    /**
+     * @brief Symbol of a Stock Directory message, trailing spaces removed
+     *
+     */
+    [[nodiscard]] auto Symbol(std::uint16_t locate) const noexcept -> std::string_view
+    {
+        if (symbols_.empty()) {
+            return {};
+        }
+        const auto& symbol = symbols_[locate];
+        std::size_t length = symbol.size();
+        while (length != 0 && (symbol[length - 1] == ' ' || symbol[length - 1] == '\0')) {
+            --length;
+        }
+        return std::string_view(symbol.data(), length);
+    }
+
+    /**
+     * @brief Locates with book messages, busiest first
+     *
+     */
+    [[nodiscard]] auto ActiveLocates() const noexcept -> const std::vector<std::uint16_t>&
+    {
+        return active_;
+    }
+
+private:
+    static constexpr std::size_t kSyncRun = 8;
+
+    struct Chunk {
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        std::vector<std::vector<std::uint64_t>> buckets;
+        std::vector<std::pair<std::uint16_t, std::array<char, 8>>> symbols;
+        std::uint64_t messages = 0;
+        std::uint64_t book_messages = 0;
+        std::uint64_t malformed = 0;
+    };
+
+    static auto Plausible(const std::uint8_t* data, std::size_t size, std::size_t position) noexcept -> bool
+    {
+        for (std::size_t run = 0; run < kSyncRun; ++run) {
+            if (position == size) {
+                return run != 0;
+            }
+            if (position + itch::kLengthPrefix + 1 > size) {
+                return false;
+            }
+            const auto length = static_cast<std::uint16_t>(itch::LoadBig<2>(data + position));
+            if (length == 0 || itch::MessageLength(data[position + itch::kLengthPrefix]) != length) {
+                return false;
+            }
+            position += itch::kLengthPrefix + length;
+        }
+        return true;
+    }
+
+    /**
+     * @brief First position in [from, to) that looks like a message boundary, to when none
+     *
+     */
+    static auto Resync(const std::uint8_t* data, std::size_t size, std::size_t from, std::size_t to) noexcept -> std::size_t
+    {
+        for (std::size_t position = from; position < to; ++position) {
+            if (Plausible(data, size, position)) {
+                return position;
+            }
+        }
+        return to;
+    }
+
+    /**
+     * @brief Index messages starting in [begin, stop), returns the first boundary at or after stop
+     *
+     */
+    static auto Scan(const std::uint8_t* data, std::size_t size, std::size_t begin, std::size_t stop, Chunk& chunk) -> std::size_t
+    {
+        chunk.buckets.resize(itch::kLocateCount);
+        std::size_t position = begin;
+        while (position < stop) {
+            if (position + itch::kLengthPrefix + 3 > size) [[unlikely]] {
+                ++chunk.malformed;
+                return size;
+            }
+            const auto length = static_cast<std::size_t>(itch::LoadBig<2>(data + position));
+            const std::size_t next = position + itch::kLengthPrefix + length;
+            if (length < 3 || next > size) [[unlikely]] {
+                ++chunk.malformed;
+                return size;
+            }
+            const std::uint8_t* message = data + position + itch::kLengthPrefix;
+            if (itch::IsBookMessage(message[0]) && length < itch::MessageLength(message[0])) [[unlikely]] {
+                // Framed but short, replay would read its fields past the message
+                ++chunk.malformed;
+                position = next;
+                continue;
+            }
+            ++chunk.messages;
+            if (itch::IsBookMessage(message[0])) {
+                chunk.buckets[itch::Locate(message)].push_back(position + itch::kLengthPrefix);
+                ++chunk.book_messages;
+            } else if (message[0] == 'R' && length >= itch::MessageLength('R')) {
+                std::array<char, 8> symbol {};
+                std::memcpy(symbol.data(), message + 11, symbol.size());
+                chunk.symbols.emplace_back(itch::Locate(message), symbol);
+            }
+            position = next;
+        }
+        return position;
+    }
+
+    void Merge(std::vector<Chunk>& chunks, const ItchConfig& config)
+    {
+        const std::size_t threads = chunks.size();
+        // Per chunk write position of each locate: counts in chunk order
+        std::vector<std::uint64_t> bases(threads * itch::kLocateCount, 0);
+        starts_.assign(itch::kLocateCount + 1, 0);
+        for (std::size_t locate = 0; locate < itch::kLocateCount; ++locate) {
+            std::uint64_t total = 0;
+            for (std::size_t c = 0; c < threads; ++c) {
+                bases[c * itch::kLocateCount + locate] = total;
+                total += chunks[c].buckets.empty() ? 0 : chunks[c].buckets[locate].size();
+            }
+            starts_[locate + 1] = starts_[locate] + total;
+        }
+        offsets_.resize(starts_.back());
+
+        detail::RunOnThreads(static_cast<unsigned>(threads), config.cpu_base, [&](unsigned index) {
+            Chunk& chunk = chunks[index];
+            for (std::size_t locate = 0; locate < chunk.buckets.size(); ++locate) {
+                const auto& bucket = chunk.buckets[locate];
+                if (!bucket.empty()) {
+                    std::copy(bucket.begin(), bucket.end(), offsets_.begin() + static_cast<std::ptrdiff_t>(starts_[locate] + bases[index * itch::kLocateCount + locate]));
+                }
+            }
+            chunk.buckets = {};
+        });
+
+        symbols_.assign(itch::kLocateCount, std::array<char, 8> {});
+        for (const Chunk& chunk : chunks) {
+            for (const auto& [locate, symbol] : chunk.symbols) {
+                symbols_[locate] = symbol;
+            }
+        }
+
+        active_.clear();
+        for (std::size_t locate = 0; locate < itch::kLocateCount; ++locate) {
+            if (starts_[locate + 1] != starts_[locate]) {
+                active_.push_back(static_cast<std::uint16_t>(locate));
+            }
+        }
+        // Longest replays first so the last worker does not finish alone with a big symbol
+        std::stable_sort(active_.begin(), active_.end(), [&](std::uint16_t lhs, std::uint16_t rhs) {
+            return starts_[lhs + 1] - starts_[lhs] > starts_[rhs + 1] - starts_[rhs];
+        });
+    }
+
+    std::vector<std::uint64_t> starts_;
+    std::vector<std::uint64_t> offsets_;
+    std::vector<std::array<char, 8>> symbols_;
+    std::vector<std::uint16_t> active_;
+};
+
+/**
+ * @brief Replay every indexed symbol into its own L3Book on config.threads workers
+ *
+ * Workers take symbols busiest first from a shared counter; a symbol is
+ * replayed start to end by one worker, so its book needs no locking.
+ * Snapshots go to the worker's own sink: at each snapshot_interval_ns
+ * boundary of exchange time the symbol's messages cross (the book as it
+ * stood at the boundary, stamped with it) and once after the symbol's last
+ * message.
+ *
+ * @tparam SinkFactory callable (unsigned worker) -> Sink, Sink callable
+ *                     (std::uint16_t locate, std::uint64_t timestamp, const L3Book&)
+ */
+template <typename SinkFactory>
+auto ReplayBooks(const std::uint8_t* data, const ItchIndex& index, const ItchConfig& config, SinkFactory make_sink) -> ItchStats
+{
+    constexpr std::size_t kReplayPrefetch = 8;
+    const unsigned threads = config.threads == 0 ? 1 : config.threads;
+    const auto& locates = index.ActiveLocates();
+    std::atomic<std::size_t> next { 0 };
+    std::vector<ItchStats> results(threads);
+
+    detail::RunOnThreads(threads, config.cpu_base, [&](unsigned worker) {
+        auto sink = make_sink(worker);
+        ItchStats& stats = results[worker];
+        for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < locates.size(); i = next.fetch_add(1, std::memory_order_relaxed)) {
+            const std::uint16_t locate = locates[i];
+            const ItchIndex::Range range = index.Messages(locate);
+            L3Book book;
+            std::uint64_t boundary = 0;
+            std::uint64_t timestamp = 0;
+            for (std::size_t m = 0; m < range.size; ++m) {
+                // A symbol's messages are scattered over the file, fetch ahead of the replay
+                if (m + kReplayPrefetch < range.size) {
+                    __builtin_prefetch(data + range.offsets[m + kReplayPrefetch]);
+                }
+                const std::uint8_t* message = data + range.offsets[m];
+                timestamp = itch::Timestamp(message);
+                if (config.snapshot_interval_ns != 0 && timestamp >= boundary) {
+                    if (boundary != 0) {
+                        sink(locate, boundary, static_cast<const L3Book&>(book));
+                        ++stats.snapshots;
+                    }
+                    boundary = (timestamp / config.snapshot_interval_ns + 1) * config.snapshot_interval_ns;
+                }
+                stats.rejected += ApplyItchMessage(book, message) ? 0 : 1;
+            }
+            stats.book_messages += range.size;
+            sink(locate, timestamp, static_cast<const L3Book&>(book));
+            ++stats.snapshots;
+        }
+    });
+
+    ItchStats total;
+    for (const auto& result : results) {
+        total.Add(result);
+    }
+    return total;
+}
+
+} // namespace hft::core
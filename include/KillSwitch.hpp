@@ -0,0 +1,211 @@
+#pragma once
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "Tsc.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Why the kill switch was tripped
+ *
+ */
+enum class KillReason : std::uint32_t {
+    None = 0,
+    Manual,
+    Watchdog,
+    Signal,
+    External,
+    Risk
+};
+
+/**
+ * @brief Global trading halt flag
+ *
+ * Lives alone on its cache line(s), which stay shared read-only in every
+ * core's cache until a trip, so observing it costs one relaxed load per
+ * loop iteration. Trip() is lock free and async signal safe and may be
+ * called from any thread, a watchdog, a signal handler or, through
+ * SharedKillSwitch, another process.
+ *
+ * Every trip bumps a generation so stages react exactly once per trip
+ * even if the switch is reset and tripped again.
+ */
+class alignas(64) KillSwitch {
+public:
+    /**
+     * @brief Process wide instance
+     *
+     */
+    static auto Global() noexcept -> KillSwitch&
+    {
+        static KillSwitch instance;
+        return instance;
+    }
+
+    void Trip(KillReason reason) noexcept
+    {
+        trip_timestamp_.store(ReadTsc(), std::memory_order_relaxed);
+        reason_.store(static_cast<std::uint32_t>(reason), std::memory_order_relaxed);
+        generation_.fetch_add(1, std::memory_order_relaxed);
+        tripped_.store(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Hot path check
+     *
+     */
+    [[nodiscard]] auto IsTripped() const noexcept -> bool
+    {
+        return tripped_.load(std::memory_order_relaxed) != 0;
+    }
+
+    /**
+     * @brief Re-enable trading, operator action
+     *
+     */
+    void Reset() noexcept
+    {
+        reason_.store(static_cast<std::uint32_t>(KillReason::None), std::memory_order_relaxed);
+        tripped_.store(0, std::memory_order_release);
+    }
+
+    [[nodiscard]] auto Reason() const noexcept -> KillReason
+    {
+        return static_cast<KillReason>(reason_.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Number of trips so far, read after IsTripped() returned true
+     *
+     */
+    [[nodiscard]] auto Generation() const noexcept -> std::uint32_t
+    {
+        // Synchronizes with Trip() through the preceding relaxed IsTripped() load
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return generation_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief TSC of the last trip
+     *
+     */
+    [[nodiscard]] auto TripTimestamp() const noexcept -> std::uint64_t
+    {
+        return trip_timestamp_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "KillSwitch must be usable from signal handlers and shared memory.");
+
+    std::atomic<std::uint32_t> tripped_ { 0 };
+    std::atomic<std::uint32_t> reason_ { 0 };
+    std::atomic<std::uint32_t> generation_ { 0 };
+    std::atomic<std::uint64_t> trip_timestamp_ { 0 };
+};
+
+/**
+ * @brief Kill switch placed in POSIX shared memory
+ *
+ * Any process that opens the same name (an operator tool, a risk daemon)
+ * can trip it; stages of this process hold a reference to Get().
+ */
+class SharedKillSwitch {
+public:
+    SharedKillSwitch() = default;
+
+    ~SharedKillSwitch()
+    {
+        if (switch_ != nullptr) {
+            ::munmap(switch_, sizeof(KillSwitch));
+        }
+    }
+
+    SharedKillSwitch(const SharedKillSwitch&) = delete;
+    auto operator=(const SharedKillSwitch&) -> SharedKillSwitch& = delete;
+    SharedKillSwitch(SharedKillSwitch&&) = delete;
+    auto operator=(SharedKillSwitch&&) -> SharedKillSwitch& = delete;
+
+    /**
+     * @brief Open or create the shared memory object name ("/hft_kill")
+     *
+     */
+    [[nodiscard]] auto Open(const char* name) noexcept -> bool
+    {
+        const int fd = ::shm_open(name, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            return false;
+        }
+        // A fresh object is zero filled, which is the untripped state
+        if (::ftruncate(fd, sizeof(KillSwitch)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* memory = ::mmap(nullptr, sizeof(KillSwitch), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            return false;
+        }
+        switch_ = static_cast<KillSwitch*>(memory);
+        return true;
+    }
+
+    /**
+     * @brief Remove the name, existing mappings stay valid
+     *
+     */
+    static void Unlink(const char* name) noexcept
+    {
+        ::shm_unlink(name);
+    }
+
+    [[nodiscard]] auto Get() noexcept -> KillSwitch&
+    {
+        return *std::launder(switch_);
+    }
+
+private:
+    KillSwitch* switch_ = nullptr;
+};
+
+namespace detail {
+
+    inline auto SignalKillSwitch() noexcept -> std::atomic<KillSwitch*>&
+    {
+        static std::atomic<KillSwitch*> target { nullptr };
+        return target;
+    }
+
+    inline void TripFromSignal(int /*signal*/) noexcept
+    {
+        KillSwitch* target = SignalKillSwitch().load(std::memory_order_relaxed);
+        if (target != nullptr) {
+            target->Trip(KillReason::Signal);
+        }
+    }
+
+} // namespace detail
+
+/**
+ * @brief Trip kill_switch when signal (e.g. SIGUSR1) is delivered
+ *
+ * @return true
+ * @return false when the handler could not be installed
+ */
+[[nodiscard]] inline auto TripOnSignal(int signal, KillSwitch& kill_switch) noexcept -> bool
+{
+    detail::SignalKillSwitch().store(&kill_switch, std::memory_order_relaxed);
+    struct sigaction action {};
+    action.sa_handler = detail::TripFromSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    return ::sigaction(signal, &action, nullptr) == 0;
+}
+
+} // namespace hft::core
@@ -0,0 +1,360 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "Affinity.hpp"
+#include "BitOps.hpp"
+#include "MarketData.hpp"
+#include "Tsc.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief SplitMix64, a few cycles per draw and good enough for load shaping
+ *
+ */
+class FastRng {
+public:
+    explicit FastRng(std::uint64_t seed) noexcept
+        : state_(seed)
+    {
+    }
+
+    auto Next() noexcept -> std::uint64_t
+    {
+        std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31U);
+    }
+
+    /**
+     * @brief Uniform in [0, 1)
+     *
+     */
+    auto NextDouble() noexcept -> double
+    {
+        return static_cast<double>(Next() >> 11U) * 0x1.0p-53;
+    }
+
+    /**
+     * @brief Uniform in [0, bound) without a division
+     *
+     */
+    auto NextBelow(std::uint32_t bound) noexcept -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(((Next() >> 32U) * bound) >> 32U);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+namespace detail {
+
+    /**
+     * @brief Unit exponential sampler without a log per draw
+     *
+     * Exp(1) = k * ln2 + X, with k ~ Geometric(1/2) from trailing zeros and X
+     * exponential truncated to [0, ln2) read from an interpolated inverse CDF
+     * table. One RNG draw per sample.
+     */
+    class ExponentialTable {
+    public:
+        static constexpr std::size_t kSize = 1024;
+
+        ExponentialTable() noexcept
+        {
+            // Inverse CDF of Exp(1) truncated to [0, ln2): x = -ln(1 - u / 2)
+            for (std::size_t i = 0; i <= kSize; ++i) {
+                const double u = static_cast<double>(i) / static_cast<double>(kSize);
+                table_[i] = -std::log(1.0 - (u / 2.0));
+            }
+        }
+
+        auto Sample(FastRng& rng) const noexcept -> double
+        {
+            const std::uint64_t bits = rng.Next();
+            // Low half: geometric number of halvings, high half: table position
+            const unsigned halvings = CountTrailingZeros((bits & 0xFFFFFFFFULL) | (std::uint64_t { 1 } << 32U));
+            const auto high = static_cast<std::uint32_t>(bits >> 32U);
+            const std::size_t index = high >> 22U;
+            const double fraction = static_cast<double>(high & 0x3FFFFFU) * 0x1.0p-22;
+            const double truncated = table_[index] + ((table_[index + 1] - table_[index]) * fraction);
+            return (static_cast<double>(halvings) * kLn2) + truncated;
+        }
+
+    private:
+        static constexpr double kLn2 = 0.69314718055994530942;
+        std::array<double, kSize + 1> table_ {};
+    };
+
+    inline auto Exponential() noexcept -> const ExponentialTable&
+    {
+        static const ExponentialTable table;
+        return table;
+    }
+
+} // namespace detail
+
+/**
+ * @brief Memoryless arrivals at a constant rate
+ *
+ */
+class PoissonArrivals {
+public:
+    explicit PoissonArrivals(double events_per_second) noexcept
+        : mean_ns_(1e9 / events_per_second)
+    {
+        assert(events_per_second > 0.0);
+    }
+
+    /**
+     * @brief Next inter-arrival time in nanoseconds
+     *
+     */
+    auto Next(FastRng& rng) noexcept -> double
+    {
+        return exponential_.Sample(rng) * mean_ns_;
+    }
+
+private:
+    double mean_ns_;
+    const detail::ExponentialTable& exponential_ = detail::Exponential();
+};
+
+/**
+ * @brief Self exciting arrivals with an exponential kernel
+ *
+ * Intensity is mu + sum(alpha * exp(-beta * (t - t_i))). Simulated exactly
+ * (Dassios & Zhao) by tracking the excess intensity after the last event.
+ * Parameterized by the long run rate so it can be swapped for Poisson.
+ */
+class HawkesArrivals {
+public:
+    /**
+     * @param events_per_second long run average rate, mu / (1 - n)
+     * @param branching_ratio n = alpha / beta, expected children per event, < 1
+     * @param decay_per_second beta, how fast a burst dies out
+     */
+    HawkesArrivals(double events_per_second, double branching_ratio, double decay_per_second) noexcept
+        : beta_(decay_per_second / 1e9)
+        , alpha_(branching_ratio * beta_)
+        , mu_(events_per_second * (1.0 - branching_ratio) / 1e9)
+    {
+        assert(events_per_second > 0.0);
+        assert(branching_ratio >= 0.0 && branching_ratio < 1.0);
+        assert(decay_per_second > 0.0);
+    }
+
+    auto Next(FastRng& rng) noexcept -> double
+    {
+        // Candidate from the baseline and from the decaying excitation
+        double wait = exponential_.Sample(rng) / mu_;
+        if (excess_ > 0.0) {
+            const double decay = 1.0 - (beta_ * exponential_.Sample(rng) / excess_);
+            if (decay > 0.0) {
+                wait = std::min(wait, -std::log(decay) / beta_);
+            }
+        }
+        excess_ = (excess_ * std::exp(-beta_ * wait)) + alpha_;
+        return wait;
+    }
+
+private:
+    double beta_;
+    double alpha_;
+    double mu_;
+    double excess_ = 0.0; // intensity above mu right after the last event, per ns
+    const detail::ExponentialTable& exponential_ = detail::Exponential();
+};
+
+/**
+ * @brief Replays recorded inter-arrival times, optionally rescaled to a rate
+ *
+ */
+class ReplayArrivals {
+public:
+    /**
+     * @param inter_arrival_ns recorded gaps, must not be empty
+     * @param events_per_second 0 keeps the recorded rate
+     */
+    explicit ReplayArrivals(std::vector<double> inter_arrival_ns, double events_per_second = 0.0)
+        : gaps_(std::move(inter_arrival_ns))
+    {
+        assert(!gaps_.empty());
+        if (events_per_second > 0.0) {
+            double total = 0.0;
+            for (const double gap : gaps_) {
+                total += gap;
+            }
+            const double scale = (1e9 / events_per_second) / (total / static_cast<double>(gaps_.size()));
+            for (double& gap : gaps_) {
+                gap *= scale;
+            }
+        }
+    }
+
+    auto Next(FastRng& /*rng*/) noexcept -> double
+    {
+        const double gap = gaps_[position_];
+        position_ = position_ + 1 == gaps_.size() ? 0 : position_ + 1;
+        return gap;
+    }
+
+private:
+    std::vector<double> gaps_;
+    std::size_t position_ = 0;
+};
+
+/**
+ * @brief Shape of the synthetic book events
+ *
+ */
+struct LoadGeneratorConfig {
+    std::uint32_t instruments = 1024;
+    std::int64_t base_price = 100000;
+    std::uint32_t max_quantity = 1000;
+    std::uint64_t seed = 42;
+    int cpu = -1; /// pin the running thread, -1 leaves it unpinned
+};
+
+struct GeneratorStats {
+    std::uint64_t emitted = 0;
+    std::uint64_t dropped = 0; /// Push returned false, ring was full
+    std::uint64_t max_lateness = 0; /// worst emit time behind schedule, TSC ticks
+};
+
+/**
+ * @brief Paces synthetic MarketEvents into a ring following an arrival model
+ *
+ * Arrival times and events are generated a batch ahead, then emitted by
+ * spinning on the TSC; every event whose deadline passed is pushed in the
+ * same pass so a late thread catches up instead of drifting. Full rings are
+ * counted as drops, never waited on, so the offered load is not distorted.
+ *
+ * @tparam Model PoissonArrivals, HawkesArrivals, ReplayArrivals or any
+ *               type with double Next(FastRng&) returning nanoseconds
+ */
+template <typename Model>
+class LoadGenerator {
+    static constexpr std::size_t kBatch = 256;
+
+public:
+    LoadGenerator(Model model, const LoadGeneratorConfig& config)
+        : model_(std::move(model))
+        , config_(config)
+        , rng_(config.seed)
+        , mids_(config.instruments, config.base_price)
+    {
+        assert(config.instruments != 0 && config.max_quantity != 0);
+    }
+
+    /**
+     * @brief Next synthetic event, timestamp and sequence left for the caller
+     *
+     * Per instrument mid random walk, mostly adds and deletes near the touch.
+     */
+    auto NextEvent() noexcept -> MarketEvent
+    {
+        const std::uint64_t bits = rng_.Next();
+        MarketEvent event;
+        event.instrument = static_cast<std::uint32_t>(((bits & 0xFFFFFFFFULL) * config_.instruments) >> 32U);
+
+        std::int64_t& mid = mids_[event.instrument];
+        const std::uint64_t step = (bits >> 32U) & 3U;
+        if (step == 0) {
+            --mid;
+        } else if (step == 3) {
+            ++mid;
+        }
+        event.side = ((bits >> 34U) & 1U) != 0 ? Side::Sell : Side::Buy;
+        const auto depth = static_cast<std::int64_t>((bits >> 35U) & 7U) + 1;
+        event.price = event.side == Side::Buy ? mid - depth : mid + depth;
+        event.quantity = static_cast<std::uint32_t>((((bits >> 40U) & 0xFFFFU) * config_.max_quantity) >> 16U) + 1;
+
+        const std::uint64_t kind = (bits >> 56U) & 31U;
+        if (kind < 16) {
+            event.action = BookAction::Add;
+        } else if (kind < 22) {
+            event.action = BookAction::Modify;
+        } else if (kind < 30) {
+            event.action = BookAction::Delete;
+        } else {
+            event.action = BookAction::Trade;
+        }
+        return event;
+    }
+
+    /**
+     * @brief Emit count events into ring on the calling thread
+     *
+     * @tparam Ring anything with bool Push(const MarketEvent&)
+     * @param ring
+     * @param count
+     * @param stop optional early stop flag
+     * @return GeneratorStats
+     */
+    template <typename Ring>
+    auto Run(Ring& ring, std::uint64_t count, const std::atomic<bool>* stop = nullptr) noexcept -> GeneratorStats
+    {
+        if (config_.cpu >= 0) {
+            (void)PinThisThread(config_.cpu);
+        }
+        const double ticks_per_ns = TscPerNanosecond();
+
+        GeneratorStats stats;
+        std::array<std::uint64_t, kBatch> deadlines {};
+        std::array<MarketEvent, kBatch> events {};
+        const std::uint64_t start = ReadTsc();
+        double offset_ns = 0.0;
+
+        while (stats.emitted + stats.dropped < count) {
+            if (stop != nullptr && stop->load(std::memory_order_relaxed)) {
+                break;
+            }
+            const auto batch = static_cast<std::size_t>(std::min<std::uint64_t>(kBatch, count - stats.emitted - stats.dropped));
+            for (std::size_t i = 0; i < batch; ++i) {
+                offset_ns += model_.Next(rng_);
+                deadlines[i] = start + static_cast<std::uint64_t>(offset_ns * ticks_per_ns);
+                events[i] = NextEvent();
+            }
+
+            std::size_t next = 0;
+            while (next < batch) {
+                const std::uint64_t now = ReadTsc();
+                if (deadlines[next] > now) {
+                    CpuRelax();
+                    continue;
+                }
+                for (; next < batch && deadlines[next] <= now; ++next) {
+                    MarketEvent& event = events[next];
+                    event.timestamp = now;
+                    event.sequence = sequence_++;
+                    stats.max_lateness = std::max(stats.max_lateness, now - deadlines[next]);
+                    if (ring.Push(event)) [[likely]] {
+                        ++stats.emitted;
+                    } else {
+                        ++stats.dropped;
+                    }
+                }
+            }
+        }
+        return stats;
+    }
+
+private:
+    Model model_;
+    LoadGeneratorConfig config_;
+    FastRng rng_;
+    std::uint64_t sequence_ = 0;
+    std::vector<std::int64_t> mids_;
+};
+
+} // namespace hft::core
@@ -0,0 +1,112 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <type_traits>
+#include <cstddef>
+
+namespace hft::core {
+
+/**
+ * @brief MPSC Ring Buffer
+ *
+ * Bounded queue with a sequence number per slot (Vyukov). Producers claim a
+ * slot with one CAS on the tail, publish it through the slot sequence, the
+ * single consumer never touches shared counters on the fast path.
+ *
+ * @tparam T
+ * @tparam Capacity
+ */
+template <typename T, std::size_t Capacity>
+class MPSCRingBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
+    static_assert((Capacity != 0u) && ((Capacity & (Capacity - 1)) == 0), "Capacity must be power of 2.");
+
+    static constexpr std::size_t Mask = Capacity - 1;
+
+public:
+    MPSCRingBuffer() noexcept
+    {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Any producer thread
+     *
+     * @param value
+     * @return true
+     * @return false when full
+     */
+    [[nodiscard]] auto Push(const T& value) noexcept -> bool
+    {
+        std::size_t pos = tail.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & Mask];
+            const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                // Slot free for this lap, claim it
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) [[unlikely]] {
+                drop_count.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Single consumer thread
+     *
+     * @param out_value
+     * @return true
+     * @return false when empty (or the oldest slot is still being written)
+     */
+    [[nodiscard]] auto Pop(T& out_value) noexcept -> bool
+    {
+        Slot& slot = slots_[head & Mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        out_value = slot.value;
+        // Free the slot for the producers' next lap
+        slot.sequence.store(head + Capacity, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    [[nodiscard]] auto GetDropCount() const noexcept -> std::size_t
+    {
+        return drop_count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Consumer side emptiness check
+     *
+     */
+    [[nodiscard]] auto Empty() const noexcept -> bool
+    {
+        return slots_[head & Mask].sequence.load(std::memory_order_acquire) != head + 1;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence { 0 };
+        T value {};
+    };
+
+    alignas(64) std::array<Slot, Capacity> slots_ {};
+
+    alignas(64) std::atomic<std::size_t> tail { 0 }; // Producers
+    alignas(64) std::size_t head { 0 }; // Consumer only
+
+    alignas(64) std::atomic<std::size_t> drop_count { 0 };
+};
+
+} // namespace hft::core
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+namespace hft::core {
+
+/**
+ * @brief Side of an order or book level
+ *
+ */
+enum class Side : std::uint8_t {
+    Buy,
+    Sell
+};
+
+/**
+ * @brief What happened to the book
+ *
+ */
+enum class BookAction : std::uint8_t {
+    Add,
+    Modify,
+    Delete,
+    Trade
+};
+
+/**
+ * @brief Normalized order book event flowing between pipeline stages
+ *
+ * Prices are fixed point integer ticks, timestamps are TSC ticks.
+ */
+struct MarketEvent {
+    std::uint64_t timestamp = 0;
+    std::uint64_t sequence = 0;
+    std::int64_t price = 0;
+    std::uint32_t instrument = 0;
+    std::uint32_t quantity = 0;
+    BookAction action = BookAction::Add;
+    Side side = Side::Buy;
+};
+
+static_assert(std::is_trivially_copyable_v<MarketEvent>, "MarketEvent must be trivially copyable.");
+
+} // namespace hft::core
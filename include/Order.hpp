@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include "MarketData.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief What the strategy asks the gateway to do
+ *
+ */
+enum class OrderAction : std::uint8_t {
+    New,
+    Cancel,
+    Replace
+};
+
+/**
+ * @brief Order instruction between strategy, risk and gateway stages
+ *
+ */
+struct OrderRequest {
+    std::uint64_t origin_timestamp = 0; /// TSC of the market event that caused it
+    std::uint64_t order_id = 0;
+    std::int64_t price = 0;
+    std::uint32_t instrument = 0;
+    std::uint32_t quantity = 0;
+    OrderAction action = OrderAction::New;
+    Side side = Side::Buy;
+};
+
+static_assert(std::is_trivially_copyable_v<OrderRequest>, "OrderRequest must be trivially copyable.");
+
+} // namespace hft::core
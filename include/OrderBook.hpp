@@ -0,0 +1,213 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "MarketData.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Aggregated quantity at one price
+ *
+ */
+struct PriceLevel {
+    std::int64_t price = 0;
+    std::uint32_t quantity = 0;
+};
+
+/**
+ * @brief Price level book of one instrument, best Depth levels per side
+ *
+ * Levels are kept sorted best first in fixed arrays; levels beyond Depth
+ * are dropped, which is fine for strategies that only look near the touch.
+ *
+ * @tparam Depth levels per side
+ */
+template <std::size_t Depth = 8>
+class OrderBook {
+    static_assert(Depth != 0, "Depth must be positive.");
+
+public:
+    /**
+     * @brief Apply an event
+     *
+     * Add adds quantity, Modify sets it, Delete and Trade remove it.
+     *
+     * @param event
+     * @return true when the best level of the event's side changed
+     */
+    auto Apply(const MarketEvent& event) noexcept -> bool
+    {
+        BookSide& side = event.side == Side::Buy ? bids_ : asks_;
+        const PriceLevel before = side.count == 0 ? PriceLevel {} : side.levels[0];
+        const bool is_bid = event.side == Side::Buy;
+
+        std::size_t index = 0;
+        while (index < side.count && IsBetter(side.levels[index].price, event.price, is_bid)) {
+            ++index;
+        }
+        const bool found = index < side.count && side.levels[index].price == event.price;
+
+        switch (event.action) {
+        case BookAction::Add:
+        case BookAction::Modify:
+            if (!found) {
+                if (index == Depth || event.quantity == 0) {
+                    return false;
+                }
+                Insert(side, index, event.price);
+            }
+            side.levels[index].quantity = event.action == BookAction::Add ? side.levels[index].quantity + event.quantity : event.quantity;
+            if (side.levels[index].quantity == 0) {
+                Erase(side, index);
+            }
+            break;
+        case BookAction::Delete:
+        case BookAction::Trade:
+            if (!found) {
+                return false;
+            }
+            if (side.levels[index].quantity <= event.quantity) {
+                Erase(side, index);
+            } else {
+                side.levels[index].quantity -= event.quantity;
+            }
+            break;
+        }
+
+        const PriceLevel after = side.count == 0 ? PriceLevel {} : side.levels[0];
+        return before.price != after.price || before.quantity != after.quantity;
+    }
+
+    /**
+     * @brief Best bid, quantity 0 when the side is empty
+     *
+     */
+    [[nodiscard]] auto BestBid() const noexcept -> PriceLevel
+    {
+        return bids_.count == 0 ? PriceLevel {} : bids_.levels[0];
+    }
+
+    /**
+     * @brief Best ask, quantity 0 when the side is empty
+     *
+     */
+    [[nodiscard]] auto BestAsk() const noexcept -> PriceLevel
+    {
+        return asks_.count == 0 ? PriceLevel {} : asks_.levels[0];
+    }
+
+    [[nodiscard]] auto Level(Side side, std::size_t index) const noexcept -> PriceLevel
+    {
+        const auto& book_side = side == Side::Buy ? bids_ : asks_;
+        return index < book_side.count ? book_side.levels[index] : PriceLevel {};
+    }
+
+    [[nodiscard]] auto LevelCount(Side side) const noexcept -> std::size_t
+    {
+        return side == Side::Buy ? bids_.count : asks_.count;
+    }
+
+private:
+    struct BookSide {
+        std::array<PriceLevel, Depth> levels {};
+        std::size_t count = 0;
+    };
+
+    static auto IsBetter(std::int64_t level_price, std::int64_t price, bool is_bid) noexcept -> bool
+    {
+        return is_bid ? level_price > price : level_price < price;
+    }
+
+    static void Insert(BookSide& side, std::size_t index, std::int64_t price) noexcept
+    {
+        const std::size_t last = side.count == Depth ? Depth - 1 : side.count;
+        for (std::size_t i = last; i > index; --i) {
+            side.levels[i] = side.levels[i - 1];
+        }
+        side.levels[index] = PriceLevel { price, 0 };
+        side.count = last + 1;
+    }
+
+    static void Erase(BookSide& side, std::size_t index) noexcept
+    {
+        for (std::size_t i = index + 1; i < side.count; ++i) {
+            side.levels[i - 1] = side.levels[i];
+        }
+        --side.count;
+    }
+
+    BookSide bids_;
+    BookSide asks_;
+};
+
+/**
+ * @brief Books of all instruments, indexed by instrument id
+ *
+ * @tparam Depth levels per side
+ */
+template <std::size_t Depth = 8>
+class BookBuilder {
+public:
+    explicit BookBuilder(std::uint32_t instruments)
+        : books_(instruments)
+    {
+    }
+
+    /**
+     * @brief Apply event to its instrument's book
+     *
+     * @param event
+     * @return true when the top of book changed
+     */
+    auto Apply(const MarketEvent& event) noexcept -> bool
+    {
+        if (event.instrument >= books_.size()) [[unlikely]] {
+            return false;
+        }
+        return books_[event.instrument].Apply(event);
+    }
+
+    [[nodiscard]] auto Book(std::uint32_t instrument) const noexcept -> const OrderBook<Depth>&
+    {
+        return books_[instrument];
+    }
+
+    [[nodiscard]] auto InstrumentCount() const noexcept -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(books_.size());
+    }
+
+    /**
+     * @brief Copy all books to out, see SnapshotCoordinator
+     *
+     * @return std::size_t bytes written, 0 when capacity is too small
+     */
+    auto SaveSnapshot(std::uint8_t* out, std::size_t capacity) const noexcept -> std::size_t
+    {
+        const std::size_t size = books_.size() * sizeof(OrderBook<Depth>);
+        if (size > capacity) {
+            return 0;
+        }
+        std::memcpy(out, books_.data(), size);
+        return size;
+    }
+
+    [[nodiscard]] auto LoadSnapshot(const std::uint8_t* data, std::size_t size) noexcept -> bool
+    {
+        if (size != books_.size() * sizeof(OrderBook<Depth>)) {
+            return false;
+        }
+        std::memcpy(static_cast<void*>(books_.data()), data, size);
+        return true;
+    }
+
+private:
+    static_assert(std::is_trivially_copyable_v<OrderBook<Depth>>, "Books are snapshotted with memcpy.");
+
+    std::vector<OrderBook<Depth>> books_;
+};
+
+} // namespace hft::core
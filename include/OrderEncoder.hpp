@@ -0,0 +1,130 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "Order.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Order message ready for the wire plus local metadata
+ *
+ * Only bytes[0, length) is sent; origin_timestamp never leaves the process.
+ */
+struct EncodedOrder {
+    static constexpr std::size_t kMaxSize = 32;
+
+    std::uint64_t origin_timestamp = 0;
+    std::uint16_t length = 0;
+    std::array<std::uint8_t, kMaxSize> bytes {};
+};
+
+static_assert(std::is_trivially_copyable_v<EncodedOrder>, "EncodedOrder must be trivially copyable.");
+
+/**
+ * @brief Encodes OrderRequests into the binary order entry format
+ *
+ * Layout, little endian:
+ *   0 u8 type ('N', 'C', 'R')   1 u8 side ('B', 'S')   2 u16 length
+ *   4 u32 instrument            8 u64 order id
+ *  16 i64 price                24 u32 quantity        28 u32 reserved
+ */
+class OrderEncoder {
+public:
+    static constexpr std::uint16_t kMessageSize = 32;
+
+    static void Encode(const OrderRequest& order, EncodedOrder& out) noexcept
+    {
+        std::uint8_t* data = out.bytes.data();
+        data[0] = Type(order.action);
+        data[1] = order.side == Side::Buy ? 'B' : 'S';
+        Store(data + 2, kMessageSize);
+        Store(data + 4, order.instrument);
+        Store(data + 8, order.order_id);
+        Store(data + 16, order.price);
+        Store(data + 24, order.quantity);
+        Store(data + 28, std::uint32_t { 0 });
+        out.length = kMessageSize;
+        out.origin_timestamp = order.origin_timestamp;
+    }
+
+    /**
+     * @brief Cancel of every resting order on instrument, order id 0 on the wire
+     *
+     * Built ahead of time as kill switch templates.
+     */
+    static void EncodeMassCancel(std::uint32_t instrument, EncodedOrder& out) noexcept
+    {
+        OrderRequest order;
+        order.action = OrderAction::Cancel;
+        order.instrument = instrument;
+        Encode(order, out);
+    }
+
+    /**
+     * @brief Decode a message produced by Encode, used by tests and drop copy
+     *
+     * @param data
+     * @param length
+     * @param out
+     * @return true
+     * @return false
+     */
+    [[nodiscard]] static auto Decode(const std::uint8_t* data, std::size_t length, OrderRequest& out) noexcept -> bool
+    {
+        if (length < kMessageSize || Load<std::uint16_t>(data + 2) != kMessageSize) {
+            return false;
+        }
+        switch (data[0]) {
+        case 'N':
+            out.action = OrderAction::New;
+            break;
+        case 'C':
+            out.action = OrderAction::Cancel;
+            break;
+        case 'R':
+            out.action = OrderAction::Replace;
+            break;
+        default:
+            return false;
+        }
+        out.side = data[1] == 'B' ? Side::Buy : Side::Sell;
+        out.instrument = Load<std::uint32_t>(data + 4);
+        out.order_id = Load<std::uint64_t>(data + 8);
+        out.price = Load<std::int64_t>(data + 16);
+        out.quantity = Load<std::uint32_t>(data + 24);
+        return true;
+    }
+
+private:
+    static constexpr auto Type(OrderAction action) noexcept -> std::uint8_t
+    {
+        switch (action) {
+        case OrderAction::Cancel:
+            return 'C';
+        case OrderAction::Replace:
+            return 'R';
+        case OrderAction::New:
+        default:
+            return 'N';
+        }
+    }
+
+    // Host is assumed little endian (x86/ARM), memcpy keeps unaligned stores legal
+    template <typename V>
+    static void Store(std::uint8_t* data, V value) noexcept
+    {
+        std::memcpy(data, &value, sizeof(V));
+    }
+
+    template <typename V>
+    static auto Load(const std::uint8_t* data) noexcept -> V
+    {
+        V value;
+        std::memcpy(&value, data, sizeof(V));
+        return value;
+    }
+};
+
+} // namespace hft::core
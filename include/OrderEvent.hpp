@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include "MPSC.hpp"
+#include "OrderEncoder.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief What happened to an order, for the audit trail
+ *
+ */
+enum class OrderEventType : std::uint8_t {
+    Sent, /// left through the gateway
+    RiskRejected, /// stopped by pre trade risk
+    Cancelled /// cancel sent by the gateway itself (kill switch)
+};
+
+/**
+ * @brief Audit record, carries the encoded order bytes as they were (or would have been) sent
+ *
+ * Decoding is left to the drop copy stage so producers only copy bytes.
+ */
+struct OrderEvent {
+    std::uint64_t timestamp = 0; /// TSC when the event happened
+    EncodedOrder order;
+    OrderEventType type = OrderEventType::Sent;
+};
+
+static_assert(std::is_trivially_copyable_v<OrderEvent>, "OrderEvent must be trivially copyable.");
+
+/**
+ * @brief Gateway and risk stages push, the drop copy stage pops
+ *
+ */
+using DropCopyQueue = MPSCRingBuffer<OrderEvent, 65536>;
+
+} // namespace hft::core
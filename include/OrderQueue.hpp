@@ -0,0 +1,243 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "Order.hpp"
+#include "OrderEncoder.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Gateway side FIFO of encoded orders that coalesces unsent amends
+ *
+ * New orders and cancels keep their relative order. A Replace for an order
+ * id that still has an unsent Replace overwrites it in place, and one for
+ * an unsent New is folded into the New, so a burst of amends costs one
+ * message and one unit of exchange throttle. A Cancel removes the unsent
+ * Replace of its order id and is queued itself; later amends of that id
+ * are queued behind the cancel rather than folded into anything before it.
+ *
+ * Single threaded, owned by the gateway thread: Absorb() drains the
+ * strategy ring, then Gateway::Poll(queue, budget) sends from the front.
+ *
+ * @tparam Capacity orders, power of two
+ */
+template <std::size_t Capacity = 4096>
+class CoalescingOrderQueue {
+    static_assert((Capacity != 0u) && ((Capacity & (Capacity - 1)) == 0), "Capacity must be power of 2.");
+
+    static constexpr std::size_t Mask = Capacity - 1;
+    static constexpr std::size_t kTableSize = Capacity * 2;
+    static constexpr std::size_t kTableMask = kTableSize - 1;
+    static constexpr std::uint64_t kEmpty = 0; // Order id 0 is the mass cancel, never amended
+
+public:
+    /**
+     * @brief Queue one order, coalescing amends
+     *
+     * @return true
+     * @return false when the queue is full or the bytes are not an order
+     */
+    [[nodiscard]] auto Push(const EncodedOrder& encoded) noexcept -> bool
+    {
+        OrderRequest order;
+        if (!OrderEncoder::Decode(encoded.bytes.data(), encoded.length, order)) [[unlikely]] {
+            return false;
+        }
+
+        Entry* pending = order.order_id == kEmpty ? nullptr : Find(order.order_id);
+        if (order.action == OrderAction::Replace && pending != nullptr) {
+            Slot& slot = slots_[pending->position & Mask];
+            if (slot.action == OrderAction::Replace) {
+                slot.order = encoded;
+            } else {
+                // Unsent New, send it at the amended price and size instead
+                OrderRequest original;
+                (void)OrderEncoder::Decode(slot.order.bytes.data(), slot.order.length, original);
+                original.origin_timestamp = encoded.origin_timestamp;
+                original.price = order.price;
+                original.quantity = order.quantity;
+                OrderEncoder::Encode(original, slot.order);
+            }
+            ++coalesced_;
+            return true;
+        }
+
+        if (tail_ - head_ == Capacity) [[unlikely]] {
+            return false;
+        }
+        if (order.action == OrderAction::Cancel && pending != nullptr) {
+            Slot& slot = slots_[pending->position & Mask];
+            if (slot.action == OrderAction::Replace) {
+                slot.live = false;
+                ++coalesced_;
+                --size_;
+            }
+            slot.mapped = false;
+            Erase(pending);
+        }
+
+        Slot& slot = slots_[tail_ & Mask];
+        slot.order = encoded;
+        slot.order_id = order.order_id;
+        slot.action = order.action;
+        slot.live = true;
+        slot.mapped = order.action != OrderAction::Cancel && order.order_id != kEmpty;
+        if (slot.mapped) {
+            Insert(order.order_id, tail_);
+        }
+        ++tail_;
+        ++size_;
+        return true;
+    }
+
+    /**
+     * @brief Oldest order still to be sent
+     *
+     * @return true
+     * @return false when empty
+     */
+    [[nodiscard]] auto Pop(EncodedOrder& out) noexcept -> bool
+    {
+        while (head_ != tail_) {
+            Slot& slot = slots_[head_ & Mask];
+            ++head_;
+            if (!slot.live) {
+                continue;
+            }
+            if (slot.mapped) {
+                Erase(Find(slot.order_id));
+            }
+            out = slot.order;
+            --size_;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Move orders from a strategy ring into the queue until either runs out
+     *
+     * @tparam InRing ring of EncodedOrder
+     * @return std::size_t orders taken from in
+     */
+    template <typename InRing>
+    auto Absorb(InRing& in, std::size_t max_orders = Capacity) noexcept -> std::size_t
+    {
+        std::size_t taken = 0;
+        EncodedOrder order;
+        // Stop while there is still room for an order that does not coalesce
+        while (taken < max_orders && tail_ - head_ < Capacity && in.Pop(order)) {
+            if (!Push(order)) [[unlikely]] {
+                ++rejected_;
+            }
+            ++taken;
+        }
+        return taken;
+    }
+
+    [[nodiscard]] auto Empty() const noexcept -> bool
+    {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Orders waiting to be sent
+     *
+     */
+    [[nodiscard]] auto Size() const noexcept -> std::size_t
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Messages saved: amends folded into an earlier one or dropped by a cancel
+     *
+     */
+    [[nodiscard]] auto GetCoalescedCount() const noexcept -> std::uint64_t
+    {
+        return coalesced_;
+    }
+
+    /**
+     * @brief Orders Absorb() could not decode
+     *
+     */
+    [[nodiscard]] auto GetRejectCount() const noexcept -> std::uint64_t
+    {
+        return rejected_;
+    }
+
+private:
+    struct Slot {
+        EncodedOrder order;
+        std::uint64_t order_id = 0;
+        OrderAction action = OrderAction::New;
+        bool live = false;
+        bool mapped = false; /// the id table points at this slot
+    };
+
+    // Order id to queue position of its unsent New or Replace, linear probing
+    struct Entry {
+        std::uint64_t order_id = kEmpty;
+        std::uint64_t position = 0;
+    };
+
+    static auto Home(std::uint64_t order_id) noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>((order_id * 0x9E3779B97F4A7C15ULL) >> 32U) & kTableMask;
+    }
+
+    auto Find(std::uint64_t order_id) noexcept -> Entry*
+    {
+        for (std::size_t index = Home(order_id);; index = (index + 1) & kTableMask) {
+            Entry& entry = table_[index];
+            if (entry.order_id == order_id) {
+                return &entry;
+            }
+            if (entry.order_id == kEmpty) {
+                return nullptr;
+            }
+        }
+    }
+
+    void Insert(std::uint64_t order_id, std::uint64_t position) noexcept
+    {
+        std::size_t index = Home(order_id);
+        while (table_[index].order_id != kEmpty && table_[index].order_id != order_id) {
+            index = (index + 1) & kTableMask;
+        }
+        table_[index] = Entry { order_id, position };
+    }
+
+    /**
+     * @brief Backward shift deletion, keeps probe chains intact without tombstones
+     *
+     */
+    void Erase(Entry* entry) noexcept
+    {
+        if (entry == nullptr) {
+            return;
+        }
+        std::size_t hole = static_cast<std::size_t>(entry - table_.data());
+        for (std::size_t index = (hole + 1) & kTableMask; table_[index].order_id != kEmpty; index = (index + 1) & kTableMask) {
+            const std::size_t home = Home(table_[index].order_id);
+            // Move the entry back when the hole lies on its probe path
+            if (((index - home) & kTableMask) >= ((index - hole) & kTableMask)) {
+                table_[hole] = table_[index];
+                hole = index;
+            }
+        }
+        table_[hole] = Entry {};
+    }
+
+    std::array<Slot, Capacity> slots_ {};
+    std::array<Entry, kTableSize> table_ {};
+    std::uint64_t head_ = 0;
+    std::uint64_t tail_ = 0;
+    std::size_t size_ = 0;
+    std::uint64_t coalesced_ = 0;
+    std::uint64_t rejected_ = 0;
+};
+
+} // namespace hft::core
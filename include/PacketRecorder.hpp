@@ -0,0 +1,334 @@
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ByteRing.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief pcapng block layout, little endian
+ *
+ */
+namespace pcapng {
+
+    inline constexpr std::uint32_t kSectionHeader = 0x0A0D0D0A;
+    inline constexpr std::uint32_t kInterfaceDescription = 0x00000001;
+    inline constexpr std::uint32_t kInterfaceStatistics = 0x00000005;
+    inline constexpr std::uint32_t kEnhancedPacket = 0x00000006;
+    inline constexpr std::uint32_t kByteOrderMagic = 0x1A2B3C4D;
+
+    inline constexpr std::uint16_t kOptionEnd = 0;
+    inline constexpr std::uint16_t kOptionTimestampResolution = 9; /// if_tsresol
+    inline constexpr std::uint16_t kOptionDropCount = 5; /// isb_ifdrop
+
+    inline constexpr std::uint16_t kLinkTypeEthernet = 1;
+    inline constexpr std::uint16_t kLinkTypeUser0 = 147; /// application defined, used for bare datagram payloads
+
+    /**
+     * @brief Enhanced Packet Block without data and trailer
+     *
+     */
+    struct EnhancedPacketHeader {
+        std::uint32_t block_type = kEnhancedPacket;
+        std::uint32_t block_length = 0;
+        std::uint32_t interface_id = 0;
+        std::uint32_t timestamp_high = 0;
+        std::uint32_t timestamp_low = 0;
+        std::uint32_t captured_length = 0;
+        std::uint32_t original_length = 0;
+    };
+
+    static_assert(sizeof(EnhancedPacketHeader) == 28, "EPB header layout is part of the file format.");
+
+} // namespace pcapng
+
+struct PacketRecorderConfig {
+    std::uint16_t link_type = pcapng::kLinkTypeUser0;
+    std::uint32_t snap_length = 65535; /// longer packets are truncated in the file, at most 65535
+    std::size_t write_size = 1 << 20; /// bytes per write(), a multiple of 4096
+};
+
+/**
+ * @brief Records raw datagrams to pcapng with nanosecond timestamps
+ *
+ * The capture (feed) thread only calls Capture(), one reservation and copy
+ * into a byte ring. The recorder thread drains the ring in Poll(), frames
+ * every packet as an Enhanced Packet Block into a page aligned buffer and
+ * writes it out in write_size pieces, so the file sees few, large, aligned
+ * writes. The interface declares if_tsresol = 9, timestamps are ns since
+ * the epoch (e.g. SO_TIMESTAMPNS or CLOCK_REALTIME at receive). Close()
+ * appends an Interface Statistics Block with the ring drops.
+ *
+ * Holds the ring inline, allocate it on the heap.
+ *
+ * @tparam RingCapacity bytes of the capture ring
+ */
+template <std::size_t RingCapacity = (1 << 22)>
+class PacketRecorder {
+    struct CaptureHeader {
+        std::uint64_t timestamp;
+        std::uint32_t length;
+        std::uint32_t reserved;
+    };
+
+public:
+    using Ring = ByteRingBuffer<RingCapacity>;
+
+    explicit PacketRecorder(PacketRecorderConfig config = {}) noexcept
+        : config_(config)
+    {
+        config_.write_size = config_.write_size < 4096 ? 4096 : config_.write_size & ~std::size_t { 4095 };
+        config_.snap_length = config_.snap_length == 0 || config_.snap_length > 65535 ? 65535 : config_.snap_length;
+        capacity_ = config_.write_size + kMaxBlock;
+        if (::posix_memalign(reinterpret_cast<void**>(&buffer_), 4096, capacity_) != 0) {
+            buffer_ = nullptr;
+        }
+    }
+
+    ~PacketRecorder()
+    {
+        Close();
+        std::free(buffer_);
+    }
+
+    PacketRecorder(const PacketRecorder&) = delete;
+    auto operator=(const PacketRecorder&) -> PacketRecorder& = delete;
+    PacketRecorder(PacketRecorder&&) = delete;
+    auto operator=(PacketRecorder&&) -> PacketRecorder& = delete;
+
+    /**
+     * @brief Create (truncate) path and write the section and interface headers
+     *
+     */
+    [[nodiscard]] auto Open(const char* path) noexcept -> bool
+    {
+        Close();
+        if (buffer_ == nullptr) {
+            return false;
+        }
+        fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            return false;
+        }
+        used_ = 0;
+        AppendSectionHeader();
+        AppendInterfaceDescription();
+        return true;
+    }
+
+    /**
+     * @brief Capture thread, queue one packet; false when the ring is full
+     *
+     * @param timestamp_ns receive time, ns since the epoch
+     */
+    [[nodiscard]] auto Capture(std::uint64_t timestamp_ns, const void* data, std::size_t length) noexcept -> bool
+    {
+        const std::size_t stored = length < config_.snap_length ? length : config_.snap_length;
+        std::uint8_t* record = ring_.Reserve(sizeof(CaptureHeader) + stored);
+        if (record == nullptr) [[unlikely]] {
+            return false;
+        }
+        const CaptureHeader header { timestamp_ns, static_cast<std::uint32_t>(length), 0 };
+        std::memcpy(record, &header, sizeof(header));
+        std::memcpy(record + sizeof(header), data, stored);
+        ring_.Commit();
+        return true;
+    }
+
+    /**
+     * @brief Recorder thread, frame up to max_packets queued packets and write full chunks
+     *
+     * @return std::size_t packets taken from the ring
+     */
+    auto Poll(std::size_t max_packets = 4096) noexcept -> std::size_t
+    {
+        std::size_t count = 0;
+        const std::uint8_t* record = nullptr;
+        std::size_t size = 0;
+        while (count < max_packets && ring_.Peek(record, size)) {
+            CaptureHeader header;
+            std::memcpy(&header, record, sizeof(header));
+            AppendPacket(header.timestamp, header.length, record + sizeof(header), size - sizeof(header));
+            ring_.Release();
+            ++count;
+            if (used_ >= config_.write_size) {
+                WriteChunk();
+            }
+        }
+        packets_ += count;
+        return count;
+    }
+
+    /**
+     * @brief Drain the ring and write everything buffered, leaves the file open
+     *
+     */
+    void Flush() noexcept
+    {
+        while (Poll() != 0) {
+        }
+        WriteOut(used_);
+    }
+
+    /**
+     * @brief Flush, append interface statistics and close the file
+     *
+     */
+    void Close() noexcept
+    {
+        if (fd_ < 0) {
+            return;
+        }
+        Flush();
+        AppendInterfaceStatistics();
+        WriteOut(used_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    [[nodiscard]] auto GetPacketCount() const noexcept -> std::uint64_t
+    {
+        return packets_;
+    }
+
+    /**
+     * @brief Packets Capture() could not queue
+     *
+     */
+    [[nodiscard]] auto GetDropCount() const noexcept -> std::size_t
+    {
+        return ring_.GetDropCount();
+    }
+
+    [[nodiscard]] auto GetWriteErrorCount() const noexcept -> std::uint64_t
+    {
+        return write_errors_;
+    }
+
+private:
+    // Largest block: EPB header, snap length of data padded to 4 and the trailer
+    static constexpr std::size_t kMaxBlock = sizeof(pcapng::EnhancedPacketHeader) + 65536 + 8;
+
+    static constexpr auto Pad4(std::size_t size) noexcept -> std::size_t
+    {
+        return (size + 3) & ~std::size_t { 3 };
+    }
+
+    template <typename V>
+    void Append(const V& value) noexcept
+    {
+        std::memcpy(buffer_ + used_, &value, sizeof(value));
+        used_ += sizeof(value);
+    }
+
+    void AppendSectionHeader() noexcept
+    {
+        constexpr std::uint32_t kLength = 28;
+        Append(pcapng::kSectionHeader);
+        Append(kLength);
+        Append(pcapng::kByteOrderMagic);
+        Append(std::uint16_t { 1 }); // major
+        Append(std::uint16_t { 0 }); // minor
+        Append(std::int64_t { -1 }); // section length unknown
+        Append(kLength);
+    }
+
+    void AppendInterfaceDescription() noexcept
+    {
+        constexpr std::uint32_t kLength = 32;
+        Append(pcapng::kInterfaceDescription);
+        Append(kLength);
+        Append(config_.link_type);
+        Append(std::uint16_t { 0 });
+        Append(config_.snap_length);
+        Append(pcapng::kOptionTimestampResolution);
+        Append(std::uint16_t { 1 });
+        Append(std::uint32_t { 9 }); // 10^-9, value byte followed by 3 padding bytes
+        Append(pcapng::kOptionEnd);
+        Append(std::uint16_t { 0 });
+        Append(kLength);
+    }
+
+    void AppendInterfaceStatistics() noexcept
+    {
+        constexpr std::uint32_t kLength = 40;
+        const std::uint64_t now = last_timestamp_;
+        Append(pcapng::kInterfaceStatistics);
+        Append(kLength);
+        Append(std::uint32_t { 0 }); // interface id
+        Append(static_cast<std::uint32_t>(now >> 32));
+        Append(static_cast<std::uint32_t>(now));
+        Append(pcapng::kOptionDropCount);
+        Append(std::uint16_t { 8 });
+        Append(static_cast<std::uint64_t>(ring_.GetDropCount()));
+        Append(pcapng::kOptionEnd);
+        Append(std::uint16_t { 0 });
+        Append(kLength);
+    }
+
+    void AppendPacket(std::uint64_t timestamp, std::uint32_t original_length, const std::uint8_t* data, std::size_t length) noexcept
+    {
+        const std::size_t padded = Pad4(length);
+        pcapng::EnhancedPacketHeader header;
+        header.block_length = static_cast<std::uint32_t>(sizeof(header) + padded + 4);
+        header.timestamp_high = static_cast<std::uint32_t>(timestamp >> 32);
+        header.timestamp_low = static_cast<std::uint32_t>(timestamp);
+        header.captured_length = static_cast<std::uint32_t>(length);
+        header.original_length = original_length;
+        Append(header);
+        std::memcpy(buffer_ + used_, data, length);
+        std::memset(buffer_ + used_ + length, 0, padded - length);
+        used_ += padded;
+        Append(header.block_length);
+        last_timestamp_ = timestamp;
+    }
+
+    /**
+     * @brief Write exactly write_size bytes and move the remainder to the front
+     *
+     */
+    void WriteChunk() noexcept
+    {
+        WriteOut(config_.write_size);
+    }
+
+    void WriteOut(std::size_t size) noexcept
+    {
+        if (fd_ < 0 || size == 0) {
+            return;
+        }
+        std::size_t done = 0;
+        while (done < size) {
+            const ssize_t written = ::write(fd_, buffer_ + done, size - done);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ++write_errors_;
+                break;
+            }
+            done += static_cast<std::size_t>(written);
+        }
+        std::memmove(buffer_, buffer_ + size, used_ - size);
+        used_ -= size;
+    }
+
+    PacketRecorderConfig config_;
+    Ring ring_;
+    std::uint8_t* buffer_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t used_ = 0;
+    int fd_ = -1;
+    std::uint64_t packets_ = 0;
+    std::uint64_t last_timestamp_ = 0;
+    std::uint64_t write_errors_ = 0;
+};
+
+} // namespace hft::core
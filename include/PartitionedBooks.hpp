@@ -0,0 +1,305 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "AllocationGuard.hpp"
+#include "MarketData.hpp"
+#include "OrderBook.hpp"
+#include "Profile.hpp"
+#include "SPSC.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Book building spread over N builder threads by instrument
+ *
+ * One partitioner thread (the feed handler output) calls Dispatch(), which
+ * sends each event to the ring of the partition owning its instrument;
+ * initially a hash of the instrument id. Builder thread p calls Poll(p)
+ * and is the only writer of the books it owns.
+ *
+ * Rebalance() moves an instrument at a sequence barrier: a marker in the
+ * new owner's ring holds back that partition until the old owner has
+ * consumed everything dispatched to it before the move, so events of one
+ * instrument are always applied in feed order. Builders never block on a
+ * barrier, Poll() returns early and retries on the next call. Barriers
+ * only ever wait for messages queued before them, so they cannot deadlock.
+ *
+ * @tparam Depth book levels per side
+ * @tparam RingCapacity events per partition ring
+ */
+template <std::size_t Depth = 8, std::size_t RingCapacity = 65536>
+class PartitionedBookBuilder {
+public:
+    using Ring = SPSCRingBuffer<MarketEvent, RingCapacity>;
+
+    /// Instrument id of barrier markers; sequence is the position to wait for, price the partition
+    static constexpr std::uint32_t kBarrierInstrument = ~std::uint32_t { 0 };
+
+    PartitionedBookBuilder(std::uint32_t instruments, std::uint32_t partitions)
+        : books_(instruments)
+        , owner_(instruments)
+        , load_(instruments, 0)
+        , pushed_(partitions == 0 ? 1 : partitions, 0)
+    {
+        partitions = static_cast<std::uint32_t>(pushed_.size());
+        partitions_.reserve(partitions);
+        for (std::uint32_t p = 0; p < partitions; ++p) {
+            partitions_.push_back(std::make_unique<Partition>());
+        }
+        for (std::uint32_t instrument = 0; instrument < instruments; ++instrument) {
+            owner_[instrument] = Hash(instrument) % partitions;
+        }
+    }
+
+    /**
+     * @brief Partitioner thread, queue event for the builder owning its instrument
+     *
+     * @return true
+     * @return false when the instrument is unknown or that builder's ring is full
+     */
+    [[nodiscard]] auto Dispatch(const MarketEvent& event) noexcept -> bool
+    {
+        if (event.instrument >= owner_.size()) [[unlikely]] {
+            return false;
+        }
+        const std::uint32_t partition = owner_[event.instrument];
+        if (!partitions_[partition]->ring.Push(event)) [[unlikely]] {
+            return false;
+        }
+        ++pushed_[partition];
+        ++load_[event.instrument];
+        return true;
+    }
+
+    /**
+     * @brief Partitioner thread, move instrument to partition to
+     *
+     * Events dispatched afterwards go to the new owner, which applies them
+     * only after the old owner has drained the events dispatched before.
+     *
+     * @return true
+     * @return false when the barrier does not fit the new owner's ring
+     */
+    [[nodiscard]] auto Rebalance(std::uint32_t instrument, std::uint32_t to) noexcept -> bool
+    {
+        if (instrument >= owner_.size() || to >= partitions_.size()) [[unlikely]] {
+            return false;
+        }
+        const std::uint32_t from = owner_[instrument];
+        if (from == to) {
+            return true;
+        }
+        MarketEvent barrier;
+        barrier.instrument = kBarrierInstrument;
+        barrier.sequence = pushed_[from];
+        barrier.price = from;
+        if (!partitions_[to]->ring.Push(barrier)) [[unlikely]] {
+            return false;
+        }
+        ++pushed_[to];
+        owner_[instrument] = to;
+        ++moves_;
+        return true;
+    }
+
+    /**
+     * @brief Partitioner thread, move hot instruments from the busiest to the idlest partition
+     *
+     * Load is the events dispatched per instrument since the previous call.
+     * Each move takes the busiest partition's largest instrument that still
+     * narrows the gap, until the gap is within tolerance of the mean
+     * partition load so noise does not move symbols back and forth. Load
+     * counters are halved afterwards so the decision follows the recent flow.
+     *
+     * @return std::size_t instruments moved
+     */
+    auto RebalanceHot(std::size_t max_moves = 4, double tolerance = 0.1) noexcept -> std::size_t
+    {
+        std::vector<std::uint64_t>& partition_load = scratch_;
+        partition_load.assign(partitions_.size(), 0);
+        std::uint64_t total = 0;
+        for (std::size_t instrument = 0; instrument < owner_.size(); ++instrument) {
+            partition_load[owner_[instrument]] += load_[instrument];
+            total += load_[instrument];
+        }
+        const auto allowed_gap = static_cast<std::uint64_t>(tolerance * static_cast<double>(total) / static_cast<double>(partitions_.size()));
+
+        std::size_t moved = 0;
+        while (moved < max_moves) {
+            std::uint32_t busiest = 0;
+            std::uint32_t idlest = 0;
+            for (std::uint32_t p = 1; p < partition_load.size(); ++p) {
+                busiest = partition_load[p] > partition_load[busiest] ? p : busiest;
+                idlest = partition_load[p] < partition_load[idlest] ? p : idlest;
+            }
+            const std::uint64_t gap = partition_load[busiest] - partition_load[idlest];
+            if (gap <= allowed_gap) {
+                break;
+            }
+            // Moving load x changes the gap to |gap - 2x|, only x < gap helps
+            std::uint32_t candidate = kBarrierInstrument;
+            for (std::uint32_t instrument = 0; instrument < owner_.size(); ++instrument) {
+                const std::uint64_t load = load_[instrument];
+                if (owner_[instrument] == busiest && load != 0 && load < gap
+                    && (candidate == kBarrierInstrument || load > load_[candidate])) {
+                    candidate = instrument;
+                }
+            }
+            if (candidate == kBarrierInstrument || !Rebalance(candidate, idlest)) {
+                break;
+            }
+            partition_load[busiest] -= load_[candidate];
+            partition_load[idlest] += load_[candidate];
+            ++moved;
+        }
+
+        for (std::uint64_t& load : load_) {
+            load >>= 1U;
+        }
+        return moved;
+    }
+
+    /**
+     * @brief Builder thread of partition, apply up to max_burst events
+     *
+     * @param on_change called as on_change(event, book) when the top of book changed
+     * @return std::size_t messages consumed, 0 also when waiting at a barrier
+     */
+    template <typename OnChange, typename = std::enable_if_t<std::is_invocable_v<OnChange&, const MarketEvent&, const OrderBook<Depth>&>>>
+    auto Poll(std::uint32_t partition, OnChange&& on_change, std::size_t max_burst = 64) noexcept -> std::size_t
+    {
+        Partition& self = *partitions_[partition];
+        if (self.waiting && !BarrierReached(self.barrier)) {
+            return 0;
+        }
+        self.waiting = false;
+
+        std::size_t consumed = 0;
+        MarketEvent event;
+        while (consumed < max_burst && self.ring.Pop(event)) {
+            ++consumed;
+            if (event.instrument == kBarrierInstrument) [[unlikely]] {
+                self.barrier = event;
+                if (!BarrierReached(event)) {
+                    self.waiting = true;
+                    break;
+                }
+                continue;
+            }
+            HFT_PROFILE_SCOPE("book.apply");
+            HFT_HOT_PATH_SCOPE();
+            OrderBook<Depth>& book = books_[event.instrument].book;
+            if (book.Apply(event)) {
+                on_change(event, static_cast<const OrderBook<Depth>&>(book));
+            }
+        }
+        // Publish progress before anyone can wait on it, barriers reached count too
+        self.consumed.store(self.consumed.load(std::memory_order_relaxed) + consumed, std::memory_order_release);
+        return consumed;
+    }
+
+    auto Poll(std::uint32_t partition, std::size_t max_burst = 64) noexcept -> std::size_t
+    {
+        return Poll(partition, [](const MarketEvent&, const OrderBook<Depth>&) {}, max_burst);
+    }
+
+    /**
+     * @brief Book of instrument, read it from its owner thread or once builders are idle
+     *
+     */
+    [[nodiscard]] auto Book(std::uint32_t instrument) const noexcept -> const OrderBook<Depth>&
+    {
+        return books_[instrument].book;
+    }
+
+    /**
+     * @brief Owning partition as seen by the partitioner
+     *
+     */
+    [[nodiscard]] auto Owner(std::uint32_t instrument) const noexcept -> std::uint32_t
+    {
+        return owner_[instrument];
+    }
+
+    [[nodiscard]] auto PartitionCount() const noexcept -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(partitions_.size());
+    }
+
+    [[nodiscard]] auto InstrumentCount() const noexcept -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(owner_.size());
+    }
+
+    /**
+     * @brief Partitioner thread, true once every dispatched message has been consumed
+     *
+     */
+    [[nodiscard]] auto Drained() const noexcept -> bool
+    {
+        for (std::size_t p = 0; p < partitions_.size(); ++p) {
+            if (partitions_[p]->consumed.load(std::memory_order_acquire) != pushed_[p]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] auto GetMoveCount() const noexcept -> std::uint64_t
+    {
+        return moves_;
+    }
+
+    /**
+     * @brief Events that did not fit a builder ring
+     *
+     */
+    [[nodiscard]] auto GetDropCount() const noexcept -> std::size_t
+    {
+        std::size_t dropped = 0;
+        for (const auto& partition : partitions_) {
+            dropped += partition->ring.GetDropCount();
+        }
+        return dropped;
+    }
+
+private:
+    // Own cache lines, neighbouring instruments may belong to different builders
+    struct alignas(64) PaddedBook {
+        OrderBook<Depth> book;
+    };
+
+    struct Partition {
+        Ring ring;
+        alignas(64) std::atomic<std::uint64_t> consumed { 0 }; // Builder controlled
+        MarketEvent barrier; // Builder only, pending barrier marker
+        bool waiting = false;
+    };
+
+    static auto Hash(std::uint32_t instrument) noexcept -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>((instrument * 0x9E3779B97F4A7C15ULL) >> 32U);
+    }
+
+    auto BarrierReached(const MarketEvent& barrier) const noexcept -> bool
+    {
+        const auto from = static_cast<std::size_t>(barrier.price);
+        return partitions_[from]->consumed.load(std::memory_order_acquire) >= barrier.sequence;
+    }
+
+    std::vector<PaddedBook> books_;
+    std::vector<std::unique_ptr<Partition>> partitions_;
+
+    // Partitioner thread only
+    std::vector<std::uint32_t> owner_;
+    std::vector<std::uint64_t> load_;
+    std::vector<std::uint64_t> pushed_;
+    std::vector<std::uint64_t> scratch_;
+    std::uint64_t moves_ = 0;
+};
+
+} // namespace hft::core
@@ -0,0 +1,311 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+#include "BitOps.hpp"
+#include "Tsc.hpp"
+
+/**
+ * HFT_PROFILE_SCOPE("name") times the enclosing scope with the TSC.
+ *
+ * Compiled in only when HFT_ENABLE_PROFILING is defined (cmake -DENABLE_PROFILING=ON),
+ * otherwise the macro expands to nothing and no code or data is emitted.
+ */
+#if defined(HFT_ENABLE_PROFILING)
+#define HFT_PROFILE_CONCAT_IMPL(a, b) a##b
+#define HFT_PROFILE_CONCAT(a, b) HFT_PROFILE_CONCAT_IMPL(a, b)
+#define HFT_PROFILE_SCOPE(name)                                                     \
+    ::hft::profile::ProfileScope HFT_PROFILE_CONCAT(hft_profile_scope_, __LINE__)( \
+        std::integral_constant<std::uint64_t, ::hft::profile::ScopeId(name)>::value, name)
+#else
+#define HFT_PROFILE_SCOPE(name) static_cast<void>(0)
+#endif
+
+namespace hft::profile {
+
+/**
+ * @brief FNV-1a of the scope name, evaluated at compile time by the macro
+ *
+ * @param name
+ * @return std::uint64_t
+ */
+constexpr auto ScopeId(const char* name) noexcept -> std::uint64_t
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (; *name != '\0'; ++name) {
+        hash ^= static_cast<unsigned char>(*name);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Aggregated statistics of one scope path (scope nested in its parents)
+ *
+ */
+struct ScopeReport {
+    const char* name = nullptr;
+    std::uint64_t path = 0;
+    std::uint64_t parent = 0;
+    std::uint32_t depth = 0;
+    std::uint64_t count = 0;
+    std::uint64_t total_cycles = 0;
+    std::uint64_t max_cycles = 0;
+    /// buckets[i] counts samples with bit_width(cycles) == i
+    std::array<std::uint64_t, 64> buckets {};
+};
+
+namespace detail {
+
+    /**
+     * @brief Per thread table of scope paths, written only by the owning thread
+     *
+     * Counters are relaxed atomics updated with load + store (no RMW) so that
+     * Collect() may read them from another thread.
+     */
+    class ThreadProfile {
+    public:
+        static constexpr std::size_t kSlots = 512;
+        static constexpr std::size_t kMask = kSlots - 1;
+
+        struct Slot {
+            std::atomic<std::uint64_t> path { 0 };
+            const char* name = nullptr;
+            std::uint64_t parent = 0;
+            std::uint32_t depth = 0;
+            std::atomic<std::uint64_t> count { 0 };
+            std::atomic<std::uint64_t> total_cycles { 0 };
+            std::atomic<std::uint64_t> max_cycles { 0 };
+            std::array<std::atomic<std::uint64_t>, 64> buckets {};
+        };
+
+        /**
+         * @brief Find or create the slot of path, nullptr when the table is full
+         *
+         */
+        auto Lookup(std::uint64_t path, std::uint64_t parent, std::uint32_t depth, const char* name) noexcept -> Slot*
+        {
+            for (std::size_t probe = 0; probe < kSlots; ++probe) {
+                Slot& slot = slots_[(path + probe) & kMask];
+                const std::uint64_t key = slot.path.load(std::memory_order_relaxed);
+                if (key == path) {
+                    return &slot;
+                }
+                if (key == 0) {
+                    slot.name = name;
+                    slot.parent = parent;
+                    slot.depth = depth;
+                    // Publish the metadata before the key
+                    slot.path.store(path, std::memory_order_release);
+                    return &slot;
+                }
+            }
+            return nullptr;
+        }
+
+        static void Record(Slot& slot, std::uint64_t cycles) noexcept
+        {
+            Bump(slot.count, 1);
+            Bump(slot.total_cycles, cycles);
+            if (cycles > slot.max_cycles.load(std::memory_order_relaxed)) {
+                slot.max_cycles.store(cycles, std::memory_order_relaxed);
+            }
+            const unsigned bucket = core::BitWidth(cycles);
+            Bump(slot.buckets[bucket > 63 ? 63 : bucket], 1);
+        }
+
+        [[nodiscard]] auto Slots() const noexcept -> const std::array<Slot, kSlots>&
+        {
+            return slots_;
+        }
+
+        std::uint64_t current_path = 0;
+        std::uint32_t current_depth = 0;
+
+    private:
+        static void Bump(std::atomic<std::uint64_t>& counter, std::uint64_t delta) noexcept
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        std::array<Slot, kSlots> slots_ {};
+    };
+
+    /**
+     * @brief Owns every thread's table so reports survive thread exit
+     *
+     */
+    class Registry {
+    public:
+        static auto Instance() -> Registry&
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        auto Create() -> ThreadProfile*
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            profiles_.push_back(std::make_unique<ThreadProfile>());
+            return profiles_.back().get();
+        }
+
+        template <typename Fn>
+        void ForEach(Fn&& fn)
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& profile : profiles_) {
+                fn(*profile);
+            }
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<ThreadProfile>> profiles_;
+    };
+
+    /**
+     * @brief Table of the calling thread, registered on first use (cold path)
+     *
+     */
+    inline auto CurrentThread() -> ThreadProfile&
+    {
+        thread_local ThreadProfile* profile = Registry::Instance().Create();
+        return *profile;
+    }
+
+    constexpr auto CombinePath(std::uint64_t parent, std::uint64_t id) noexcept -> std::uint64_t
+    {
+        const std::uint64_t path = (parent * 0x9E3779B97F4A7C15ULL) ^ id;
+        return path == 0 ? 1 : path;
+    }
+
+} // namespace detail
+
+/**
+ * @brief RAII scope, use through HFT_PROFILE_SCOPE
+ *
+ */
+class ProfileScope {
+public:
+    ProfileScope(std::uint64_t id, const char* name) noexcept
+        : profile_(detail::CurrentThread())
+        , parent_path_(profile_.current_path)
+    {
+        const std::uint64_t path = detail::CombinePath(parent_path_, id);
+        slot_ = profile_.Lookup(path, parent_path_, profile_.current_depth, name);
+        profile_.current_path = path;
+        ++profile_.current_depth;
+        start_ = core::ReadTsc();
+    }
+
+    ~ProfileScope()
+    {
+        const std::uint64_t cycles = core::ReadTsc() - start_;
+        if (slot_ != nullptr) [[likely]] {
+            detail::ThreadProfile::Record(*slot_, cycles);
+        }
+        profile_.current_path = parent_path_;
+        --profile_.current_depth;
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope(ProfileScope&&) = delete;
+    auto operator=(const ProfileScope&) -> ProfileScope& = delete;
+    auto operator=(ProfileScope&&) -> ProfileScope& = delete;
+
+private:
+    detail::ThreadProfile& profile_;
+    std::uint64_t parent_path_;
+    detail::ThreadProfile::Slot* slot_ = nullptr;
+    std::uint64_t start_ = 0;
+};
+
+/**
+ * @brief Merge all threads' tables by scope path, parents before children
+ *
+ * Cold path, allocates. Safe to call while other threads are profiling.
+ *
+ * @return std::vector<ScopeReport>
+ */
+inline auto Collect() -> std::vector<ScopeReport>
+{
+    std::vector<ScopeReport> reports;
+    detail::Registry::Instance().ForEach([&](const detail::ThreadProfile& profile) {
+        for (const auto& slot : profile.Slots()) {
+            const std::uint64_t path = slot.path.load(std::memory_order_acquire);
+            if (path == 0) {
+                continue;
+            }
+            ScopeReport* report = nullptr;
+            for (auto& existing : reports) {
+                if (existing.path == path) {
+                    report = &existing;
+                    break;
+                }
+            }
+            if (report == nullptr) {
+                report = &reports.emplace_back();
+                report->name = slot.name;
+                report->path = path;
+                report->parent = slot.parent;
+                report->depth = slot.depth;
+            }
+            report->count += slot.count.load(std::memory_order_relaxed);
+            report->total_cycles += slot.total_cycles.load(std::memory_order_relaxed);
+            const std::uint64_t max_cycles = slot.max_cycles.load(std::memory_order_relaxed);
+            report->max_cycles = max_cycles > report->max_cycles ? max_cycles : report->max_cycles;
+            for (std::size_t i = 0; i < report->buckets.size(); ++i) {
+                report->buckets[i] += slot.buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+    });
+
+    // Depth first order so Print can indent children under their parent
+    std::vector<ScopeReport> ordered;
+    ordered.reserve(reports.size());
+    auto append_children = [&](auto& self, std::uint64_t parent) -> void {
+        for (const auto& report : reports) {
+            if (report.parent == parent) {
+                ordered.push_back(report);
+                self(self, report.path);
+            }
+        }
+    };
+    append_children(append_children, 0);
+    return ordered;
+}
+
+/**
+ * @brief Print the scope tree: calls, mean, approximate p99 and max in cycles
+ *
+ * @param out
+ */
+inline void Print(std::ostream& out)
+{
+    for (const auto& report : Collect()) {
+        std::uint64_t p99_bucket = 0;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < report.buckets.size(); ++i) {
+            seen += report.buckets[i];
+            if (seen * 100 >= report.count * 99) {
+                p99_bucket = i;
+                break;
+            }
+        }
+        const std::uint64_t mean = report.count == 0 ? 0 : report.total_cycles / report.count;
+        for (std::uint32_t i = 0; i < report.depth; ++i) {
+            out << "  ";
+        }
+        out << report.name << " calls=" << report.count << " mean=" << mean
+            << " p99<" << (std::uint64_t { 1 } << p99_bucket)
+            << " max=" << report.max_cycles << " cycles\n";
+    }
+}
+
+} // namespace hft::profile
@@ -0,0 +1,310 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Order.hpp"
+#include "OrderBook.hpp"
+#include "OrderEncoder.hpp"
+#include "Profile.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Per instrument quoting parameters of QuoteEngine
+ *
+ */
+struct QuoteParams {
+    std::int64_t half_spread = 1; /// distance of each quote from fair value, price units
+    std::int64_t tick_size = 1;
+    std::int64_t requote_threshold = 1; /// smallest move of a target price worth a replace
+    std::uint32_t quantity = 0; /// per side, 0 disables quoting
+};
+
+/**
+ * @brief One side of an instrument's two-sided quote
+ *
+ */
+struct LiveQuote {
+    std::uint64_t order_id = 0;
+    std::int64_t price = 0;
+    std::uint32_t quantity = 0; /// 0 when no order is resting
+};
+
+/**
+ * @brief Maintains two-sided quotes around an incrementally updated fair value
+ *
+ * OnBook() runs per top of book change and only touches that instrument:
+ * the size weighted mid is folded into an exponentially smoothed fair
+ * value, target prices are derived and compared with the resting quotes.
+ * Instruments whose target moved by at least requote_threshold are queued
+ * once, however many updates arrive before the next Flush(). Flush() turns
+ * the queue into New, Replace or Cancel orders and publishes them to the
+ * gateway ring in one batch, so a burst of book updates costs the gateway
+ * one wake up rather than one per instrument.
+ *
+ * Replace keeps the resting order id. A side is cancelled when its book
+ * side empties or quoting is disabled. A New that did not fit the ring keeps
+ * its id when it is staged again, so published ids have no gaps.
+ */
+class QuoteEngine {
+public:
+    /**
+     * @param instruments
+     * @param smoothing weight of the newest mid in the fair value, 1 tracks the mid exactly
+     */
+    explicit QuoteEngine(std::uint32_t instruments, double smoothing = 1.0)
+        : states_(instruments)
+        , smoothing_(smoothing)
+    {
+        queue_.reserve(instruments);
+        batch_.reserve(static_cast<std::size_t>(instruments) * 2);
+        changes_.reserve(static_cast<std::size_t>(instruments) * 2);
+    }
+
+    void SetParams(std::uint32_t instrument, const QuoteParams& params) noexcept
+    {
+        if (instrument < states_.size()) {
+            states_[instrument].params = params;
+        }
+    }
+
+    /**
+     * @brief React to a top of book change of event.instrument
+     *
+     * @tparam Depth
+     * @param event the event that changed the book
+     * @param book book of event.instrument after the event
+     * @return true when the instrument is queued for requoting
+     */
+    template <std::size_t Depth>
+    auto OnBook(const MarketEvent& event, const OrderBook<Depth>& book) noexcept -> bool
+    {
+        HFT_PROFILE_SCOPE("quote.on_book");
+        if (event.instrument >= states_.size()) [[unlikely]] {
+            return false;
+        }
+        State& state = states_[event.instrument];
+        state.timestamp = event.timestamp;
+        const PriceLevel bid = book.BestBid();
+        const PriceLevel ask = book.BestAsk();
+
+        if (bid.quantity == 0 || ask.quantity == 0 || state.params.quantity == 0) {
+            state.has_fair = false;
+            state.target_bid = 0;
+            state.target_ask = 0;
+        } else {
+            // Size weighted mid leans towards the side about to be depleted
+            const double bid_weight = static_cast<double>(ask.quantity);
+            const double ask_weight = static_cast<double>(bid.quantity);
+            const double mid = (static_cast<double>(bid.price) * bid_weight + static_cast<double>(ask.price) * ask_weight) / (bid_weight + ask_weight);
+            state.fair = state.has_fair ? state.fair + smoothing_ * (mid - state.fair) : mid;
+            state.has_fair = true;
+
+            const QuoteParams& params = state.params;
+            const double tick = static_cast<double>(params.tick_size);
+            std::int64_t target_bid = static_cast<std::int64_t>(std::floor((state.fair - static_cast<double>(params.half_spread)) / tick)) * params.tick_size;
+            std::int64_t target_ask = static_cast<std::int64_t>(std::ceil((state.fair + static_cast<double>(params.half_spread)) / tick)) * params.tick_size;
+            // Stay passive, never cross the opposite touch
+            target_bid = target_bid < ask.price - params.tick_size ? target_bid : ask.price - params.tick_size;
+            target_ask = target_ask > bid.price + params.tick_size ? target_ask : bid.price + params.tick_size;
+            state.target_bid = target_bid;
+            state.target_ask = target_ask;
+        }
+
+        if (state.queued) {
+            return true;
+        }
+        if (!NeedsUpdate(state, state.bid, state.target_bid) && !NeedsUpdate(state, state.ask, state.target_ask)) {
+            ++suppressed_;
+            return false;
+        }
+        state.queued = true;
+        queue_.push_back(event.instrument);
+        return true;
+    }
+
+    /**
+     * @brief Publish the queued quote updates to out in one batch
+     *
+     * Orders that do not fit stay queued for the next call.
+     *
+     * @tparam OutRing ring of EncodedOrder with PushBatch, e.g. SPSCRingBuffer
+     * @return std::size_t orders published
+     */
+    template <typename OutRing>
+    auto Flush(OutRing& out) noexcept -> std::size_t
+    {
+        HFT_PROFILE_SCOPE("quote.flush");
+        batch_.clear();
+        changes_.clear();
+        for (const std::uint32_t instrument : queue_) {
+            State& state = states_[instrument];
+            Stage(instrument, state, Side::Buy, state.bid, state.target_bid);
+            Stage(instrument, state, Side::Sell, state.ask, state.target_ask);
+        }
+
+        const std::size_t published = batch_.empty() ? 0 : out.PushBatch(batch_.data(), batch_.size());
+        for (std::size_t i = 0; i < published; ++i) {
+            const Change& change = changes_[i];
+            State& state = states_[change.instrument];
+            (change.side == Side::Buy ? state.bid : state.ask) = change.after;
+            (change.side == Side::Buy ? state.staged_bid_id : state.staged_ask_id) = 0;
+        }
+        dropped_ += batch_.size() - published;
+
+        // Keep instruments with unpublished orders queued, in order
+        std::size_t kept = 0;
+        std::size_t next_unpublished = published;
+        for (const std::uint32_t instrument : queue_) {
+            const bool pending = next_unpublished < changes_.size() && changes_[next_unpublished].instrument == instrument;
+            if (pending) {
+                while (next_unpublished < changes_.size() && changes_[next_unpublished].instrument == instrument) {
+                    ++next_unpublished;
+                }
+                queue_[kept++] = instrument;
+            } else {
+                states_[instrument].queued = false;
+            }
+        }
+        queue_.resize(kept);
+        sent_ += published;
+        return published;
+    }
+
+    [[nodiscard]] auto Quote(std::uint32_t instrument, Side side) const noexcept -> const LiveQuote&
+    {
+        return side == Side::Buy ? states_[instrument].bid : states_[instrument].ask;
+    }
+
+    /**
+     * @brief Smoothed fair value, NaN until both sides of the book are known
+     *
+     */
+    [[nodiscard]] auto FairValue(std::uint32_t instrument) const noexcept -> double
+    {
+        return states_[instrument].has_fair ? states_[instrument].fair : std::nan("");
+    }
+
+    [[nodiscard]] auto QueuedCount() const noexcept -> std::size_t
+    {
+        return queue_.size();
+    }
+
+    [[nodiscard]] auto GetSentCount() const noexcept -> std::uint64_t
+    {
+        return sent_;
+    }
+
+    /**
+     * @brief Book updates that left every quote within its threshold
+     *
+     */
+    [[nodiscard]] auto GetSuppressedCount() const noexcept -> std::uint64_t
+    {
+        return suppressed_;
+    }
+
+    /**
+     * @brief Orders that did not fit the gateway ring, retried on the next Flush
+     *
+     */
+    [[nodiscard]] auto GetDropCount() const noexcept -> std::uint64_t
+    {
+        return dropped_;
+    }
+
+    [[nodiscard]] auto NextOrderId() const noexcept -> std::uint64_t
+    {
+        return next_order_id_;
+    }
+
+    /**
+     * @brief Order ids must not repeat after a restart
+     *
+     */
+    void SetNextOrderId(std::uint64_t order_id) noexcept
+    {
+        next_order_id_ = order_id;
+    }
+
+private:
+    struct State {
+        QuoteParams params;
+        LiveQuote bid;
+        LiveQuote ask;
+        double fair = 0.0;
+        std::int64_t target_bid = 0; /// 0 when the side should not quote
+        std::int64_t target_ask = 0;
+        std::uint64_t timestamp = 0; /// of the last book update, carried as origin_timestamp
+        std::uint64_t staged_bid_id = 0; /// id of an unpublished New, reused by the next Flush
+        std::uint64_t staged_ask_id = 0;
+        bool has_fair = false;
+        bool queued = false;
+    };
+
+    struct Change {
+        std::uint32_t instrument;
+        Side side;
+        LiveQuote after;
+    };
+
+    static auto NeedsUpdate(const State& state, const LiveQuote& live, std::int64_t target) noexcept -> bool
+    {
+        if (target == 0 || live.quantity == 0) {
+            return (target == 0) != (live.quantity == 0);
+        }
+        const std::int64_t move = target > live.price ? target - live.price : live.price - target;
+        return move >= state.params.requote_threshold || live.quantity != state.params.quantity;
+    }
+
+    void Stage(std::uint32_t instrument, State& state, Side side, const LiveQuote& live, std::int64_t target) noexcept
+    {
+        // Updates after queueing may have brought the target back within the threshold
+        if (!NeedsUpdate(state, live, target)) {
+            return;
+        }
+        OrderRequest order;
+        order.origin_timestamp = state.timestamp;
+        order.instrument = instrument;
+        order.side = side;
+        LiveQuote after;
+        if (target == 0) {
+            order.action = OrderAction::Cancel;
+            order.order_id = live.order_id;
+            order.price = live.price;
+            order.quantity = live.quantity;
+        } else {
+            if (live.quantity == 0) {
+                std::uint64_t& staged_id = side == Side::Buy ? state.staged_bid_id : state.staged_ask_id;
+                if (staged_id == 0) {
+                    staged_id = next_order_id_++;
+                }
+                order.action = OrderAction::New;
+                order.order_id = staged_id;
+            } else {
+                order.action = OrderAction::Replace;
+                order.order_id = live.order_id;
+            }
+            order.price = target;
+            order.quantity = state.params.quantity;
+            after = LiveQuote { order.order_id, order.price, order.quantity };
+        }
+        EncodedOrder encoded;
+        OrderEncoder::Encode(order, encoded);
+        batch_.push_back(encoded);
+        changes_.push_back(Change { instrument, side, after });
+    }
+
+    std::vector<State> states_;
+    std::vector<std::uint32_t> queue_;
+    std::vector<EncodedOrder> batch_;
+    std::vector<Change> changes_;
+    double smoothing_;
+    std::uint64_t next_order_id_ = 1;
+    std::uint64_t sent_ = 0;
+    std::uint64_t suppressed_ = 0;
+    std::uint64_t dropped_ = 0;
+};
+
+} // namespace hft::core
@@ -0,0 +1,112 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include "BitOps.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Doorbell bitmap for a consumer that owns many rings
+ *
+ * Two levels: one bit per ring in the leaf words and one bit per leaf word in
+ * the summary words. The consumer only visits leaves whose summary bit is
+ * set, so a poll costs O(active rings) instead of O(total rings).
+ *
+ * Edge triggered: a producer rings the bell only when its push takes the
+ * ring from empty to non-empty (SPSCRingBuffer::PushEdge reports it), so a
+ * busy ring does not bounce the shared bitmap line on every push. Bits are
+ * only hints, data visibility still comes from the ring itself. A bell is
+ * never lost as long as the consumer clears the bit, then pops until Pop
+ * fails and IsDrained confirms it. A consumer that stops draining early
+ * must Notify the ring again.
+ *
+ * @tparam Bits  number of rings, multiple of 64
+ */
+template <std::size_t Bits>
+class ReadyBitmap {
+    static_assert((Bits != 0U) && (Bits % 64 == 0), "Bits must be a non zero multiple of 64.");
+
+    static constexpr std::size_t kLeafWords = Bits / 64;
+    static constexpr std::size_t kSummaryWords = (kLeafWords + 63) / 64;
+
+public:
+    /**
+     * @brief Producer side, mark ring index as ready
+     *
+     * One fetch_or on the leaf word; the summary is only touched when the leaf
+     * word goes from empty to non-empty. On x86 release RMW is the same
+     * lock or as relaxed, it orders the ring's data before the bell.
+     *
+     * @param index ring index
+     */
+    void Notify(std::size_t index) noexcept
+    {
+        assert(index < Bits);
+        const std::size_t word = index / 64;
+        const std::uint64_t previous = leaves_[word].value.fetch_or(std::uint64_t { 1 } << (index % 64), std::memory_order_release);
+        if (previous == 0) {
+            summary_[word / 64].value.fetch_or(std::uint64_t { 1 } << (word % 64), std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Consumer side, visit and clear every ready index
+     *
+     * @tparam Fn void(std::size_t index)
+     * @param fn called once per ready ring, lowest index first
+     * @return std::size_t number of visited rings
+     */
+    template <typename Fn>
+    auto Drain(Fn&& fn) noexcept(noexcept(fn(std::size_t {}))) -> std::size_t
+    {
+        std::size_t visited = 0;
+        for (std::size_t s = 0; s < kSummaryWords; ++s) {
+            if (summary_[s].value.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            // Clear the summary before the leaves, a racing Notify re-sets it
+            std::uint64_t summary = summary_[s].value.exchange(0, std::memory_order_acquire);
+            while (summary != 0) {
+                const std::size_t word = (s * 64) + CountTrailingZeros(summary);
+                summary &= summary - 1;
+
+                std::uint64_t leaf = leaves_[word].value.exchange(0, std::memory_order_acquire);
+                while (leaf != 0) {
+                    fn((word * 64) + CountTrailingZeros(leaf));
+                    leaf &= leaf - 1;
+                    ++visited;
+                }
+            }
+        }
+        return visited;
+    }
+
+    /**
+     * @brief Is any ring marked
+     *
+     * @return true
+     * @return false
+     */
+    [[nodiscard]] auto Any() const noexcept -> bool
+    {
+        for (const auto& word : summary_) {
+            if (word.value.load(std::memory_order_relaxed) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    // Producers of different leaves should not fight over one line
+    struct alignas(64) Word {
+        std::atomic<std::uint64_t> value { 0 };
+    };
+
+    std::array<Word, kSummaryWords> summary_ {};
+    std::array<Word, kLeafWords> leaves_ {};
+};
+
+} // namespace hft::core
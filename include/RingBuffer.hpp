@@ -3,6 +3,8 @@
 #include <atomic>
 #include <type_traits>
 #include <cassert>
+#include "RingSegments.hpp"
+#include "ThreadModel.hpp"
 
 namespace hft::core {
 
@@ -21,14 +23,19 @@ enum class OverflowPolicy {
  * @tparam T  parameter type
  * @tparam Capacity  of the buffer
  * @tparam Policy  overflow pollicy
+ * @tparam Model  threading model, SingleThread compiles the atomics out
  */
-template <typename T, std::size_t Capacity, OverflowPolicy Policy = OverflowPolicy::Reject>
+template <typename T, std::size_t Capacity, OverflowPolicy Policy = OverflowPolicy::Reject, ThreadModel Model = ThreadModel::MPMC>
 class RingBuffer {
     static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable for HFT efficiency.");
     static_assert((Capacity != 0U) && ((Capacity & (Capacity - 1)) == 0), "Capacity must be a power of 2.");
 
     static constexpr std::size_t Mask = Capacity - 1;
 
+    using Traits = detail::ModelTraits<Model>;
+    using Index = typename Traits::Index;
+    static constexpr std::size_t kAlign = Traits::kAlign;
+
 public:
     /**
      * @brief Push New element
@@ -71,18 +78,29 @@ public:
      */
     [[nodiscard]] auto Pop(T& out_value) noexcept -> bool
     {
-        std::size_t current_head = head.load(std::memory_order_acquire);
-
-        while (true) {
+        // Only the consumer moves head unless the producer may overwrite
+        if constexpr (Model == ThreadModel::SingleThread || (Model == ThreadModel::SPSC && Policy == OverflowPolicy::Reject)) {
+            const std::size_t current_head = head.load(std::memory_order_relaxed);
             if (current_head == tail.load(std::memory_order_acquire)) {
                 return false;
             }
-            T potential_value = buffer_[current_head];
-            std::size_t next_head = (current_head + 1) & Mask;
-            // inm case off success its going to release, in case of fail its going to read.
-            if (head.compare_exchange_strong(current_head, next_head, std::memory_order_release, std::memory_order_acquire)) {
-                out_value = potential_value;
-                return true;
+            out_value = buffer_[current_head];
+            head.store((current_head + 1) & Mask, std::memory_order_release);
+            return true;
+        } else {
+            std::size_t current_head = head.load(std::memory_order_acquire);
+
+            while (true) {
+                if (current_head == tail.load(std::memory_order_acquire)) {
+                    return false;
+                }
+                T potential_value = buffer_[current_head];
+                std::size_t next_head = (current_head + 1) & Mask;
+                // inm case off success its going to release, in case of fail its going to read.
+                if (head.compare_exchange_strong(current_head, next_head, std::memory_order_release, std::memory_order_acquire)) {
+                    out_value = potential_value;
+                    return true;
+                }
             }
         }
     }
@@ -120,13 +138,28 @@ public:
         return (tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed)) & Mask;
     }
 
+    /**
+     * @brief Occupied slots, oldest first, for scans such as FindAll
+     *
+     * Meant for the consumer thread: stable while nobody else moves head,
+     * i.e. not with racing MPMC consumers or an Overwrite producer that
+     * laps the reader.
+     */
+    [[nodiscard]] auto Segments() const noexcept -> RingSegments<T>
+    {
+        const std::size_t current_head = head.load(std::memory_order_acquire);
+        const std::size_t current_tail = tail.load(std::memory_order_acquire);
+        return MakeRingSegments<T, Capacity>(buffer_.data(), current_head, current_tail);
+    }
+
 private:
     // Aligning to 64 bytes (typical Cache Line size) prevents "False Sharing"
     // This ensures the Producer and Consumer don't invalidate each other's caches.
-    alignas(64) std::array<T, Capacity> buffer_ {};
+    // SingleThread has nobody to share with and falls back to natural alignment.
+    alignas(kAlign) alignas(std::array<T, Capacity>) std::array<T, Capacity> buffer_ {};
 
-    alignas(64) std::atomic<std::size_t> tail { 0 };
-    alignas(64) std::atomic<std::size_t> head { 0 };
+    alignas(kAlign) Index tail { 0 };
+    alignas(kAlign) Index head { 0 };
 };
 
 } // namespace hft::core
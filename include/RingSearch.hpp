@@ -0,0 +1,165 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "BitOps.hpp"
+#include "RingSegments.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HFT_RING_SEARCH_AVX2 1
+#endif
+
+namespace hft::core {
+
+namespace detail {
+
+    template <auto Member>
+    struct SearchMember;
+
+    template <typename C, typename M, M C::*Member>
+    struct SearchMember<Member> {
+        using Class = C;
+        using Key = M;
+        // Gathered as 32 or 64 bit lanes and compared bitwise
+        static constexpr bool kVectorizable = (std::is_integral_v<M> || std::is_enum_v<M>) && (sizeof(M) == 4 || sizeof(M) == 8);
+    };
+
+    template <auto Member, typename T>
+    auto FindAllScalarRange(const T* data, std::size_t count, typename SearchMember<Member>::Key key, std::size_t position,
+        std::size_t* out_positions, std::size_t max_out, std::size_t found) noexcept -> std::size_t
+    {
+        for (std::size_t i = 0; i < count && found < max_out; ++i) {
+            if (data[i].*Member == key) {
+                out_positions[found++] = position + i;
+            }
+        }
+        return found;
+    }
+
+#if defined(HFT_RING_SEARCH_AVX2)
+    inline auto HasAvx2() noexcept -> bool
+    {
+        static const bool has_avx2 = __builtin_cpu_supports("avx2") != 0;
+        return has_avx2;
+    }
+
+    /**
+     * @brief Emit positions of the set bits of an 8 slot match mask
+     *
+     */
+    inline auto EmitMatches(unsigned mask, std::size_t position, std::size_t* out_positions, std::size_t max_out, std::size_t found) noexcept -> std::size_t
+    {
+        while (mask != 0 && found < max_out) {
+            out_positions[found++] = position + CountTrailingZeros(mask);
+            mask &= mask - 1;
+        }
+        return found;
+    }
+
+    /**
+     * @brief 8 slots per iteration: one 32 bit gather or two 64 bit gathers
+     *
+     * The key is read at a fixed stride of sizeof(T) from the first slot's
+     * field, so the gather never touches memory outside the range.
+     */
+    template <auto Member, typename T>
+    __attribute__((target("avx2"))) auto FindAllAvx2Range(const T* data, std::size_t count, typename SearchMember<Member>::Key key,
+        std::size_t position, std::size_t* out_positions, std::size_t max_out, std::size_t found) noexcept -> std::size_t
+    {
+        using Key = typename SearchMember<Member>::Key;
+        constexpr long long kStride = static_cast<long long>(sizeof(T));
+        static_assert(kStride * 8 < (1LL << 31), "Element too large for 32 bit gather offsets.");
+
+        std::size_t i = 0;
+        if (count >= 8) {
+            const char* field = reinterpret_cast<const char*>(&(data->*Member));
+            if constexpr (sizeof(Key) == 4) {
+                std::int32_t raw_key = 0;
+                std::memcpy(&raw_key, &key, sizeof(raw_key));
+                const __m256i needle = _mm256_set1_epi32(raw_key);
+                const auto s = static_cast<int>(kStride);
+                const __m256i offsets = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+                for (; i + 8 <= count && found < max_out; i += 8) {
+                    const auto* base = reinterpret_cast<const int*>(field + i * sizeof(T));
+                    const __m256i values = _mm256_i32gather_epi32(base, offsets, 1);
+                    const auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(values, needle))));
+                    found = EmitMatches(mask, position + i, out_positions, max_out, found);
+                }
+            } else {
+                long long raw_key = 0;
+                std::memcpy(&raw_key, &key, sizeof(raw_key));
+                const __m256i needle = _mm256_set1_epi64x(raw_key);
+                const __m256i offsets = _mm256_setr_epi64x(0, kStride, 2 * kStride, 3 * kStride);
+                for (; i + 8 <= count && found < max_out; i += 8) {
+                    const auto* low = reinterpret_cast<const long long*>(field + i * sizeof(T));
+                    const auto* high = reinterpret_cast<const long long*>(field + (i + 4) * sizeof(T));
+                    const __m256i low_values = _mm256_i64gather_epi64(low, offsets, 1);
+                    const __m256i high_values = _mm256_i64gather_epi64(high, offsets, 1);
+                    const auto low_mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(low_values, needle))));
+                    const auto high_mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(high_values, needle))));
+                    found = EmitMatches(low_mask | (high_mask << 4), position + i, out_positions, max_out, found);
+                }
+            }
+        }
+        return FindAllScalarRange<Member>(data + i, count - i, key, position + i, out_positions, max_out, found);
+    }
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Positions of all slots whose Member equals key, scalar reference scan
+ *
+ */
+template <auto Member, typename T>
+auto FindAllScalar(const RingSegments<T>& segments, typename detail::SearchMember<Member>::Key key,
+    std::size_t* out_positions, std::size_t max_out) noexcept -> std::size_t
+{
+    std::size_t found = detail::FindAllScalarRange<Member>(segments.first, segments.first_size, key, 0, out_positions, max_out, 0);
+    return detail::FindAllScalarRange<Member>(segments.second, segments.second_size, key, segments.first_size, out_positions, max_out, found);
+}
+
+/**
+ * @brief Positions of all slots whose Member equals key
+ *
+ * Searches the occupied region returned by Segments() of RingBuffer or
+ * SPSCRingBuffer. Positions are logical, 0 is the oldest element (the one
+ * Pop would return next), so the wraparound is invisible to the caller.
+ * 32 and 64 bit integral keys are compared 8 slots per step with AVX2
+ * gathers when the CPU supports it; other keys fall back to a scalar scan.
+ *
+ *   std::size_t hits[16];
+ *   auto count = FindAll<&OrderRequest::order_id>(ring.Segments(), id, hits, 16);
+ *
+ * @return std::size_t number of positions written, at most max_out
+ */
+template <auto Member, typename T>
+auto FindAll(const RingSegments<T>& segments, typename detail::SearchMember<Member>::Key key,
+    std::size_t* out_positions, std::size_t max_out) noexcept -> std::size_t
+{
+    static_assert(std::is_same_v<typename detail::SearchMember<Member>::Class, T>, "Member must be a data member of the ring element.");
+#if defined(HFT_RING_SEARCH_AVX2)
+    if constexpr (detail::SearchMember<Member>::kVectorizable) {
+        if (detail::HasAvx2()) [[likely]] {
+            std::size_t found = detail::FindAllAvx2Range<Member>(segments.first, segments.first_size, key, 0, out_positions, max_out, 0);
+            return detail::FindAllAvx2Range<Member>(segments.second, segments.second_size, key, segments.first_size, out_positions, max_out, found);
+        }
+    }
+#endif
+    return FindAllScalar<Member>(segments, key, out_positions, max_out);
+}
+
+/**
+ * @brief Logical position of the oldest slot whose Member equals key, kNotFound otherwise
+ *
+ */
+template <auto Member, typename T>
+auto FindFirst(const RingSegments<T>& segments, typename detail::SearchMember<Member>::Key key) noexcept -> std::size_t
+{
+    std::size_t position = kNotFound;
+    return FindAll<Member>(segments, key, &position, 1) == 1 ? position : kNotFound;
+}
+
+} // namespace hft::core
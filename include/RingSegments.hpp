@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+
+namespace hft::core {
+
+/**
+ * @brief Position returned by ring lookups that have no answer
+ *
+ */
+inline constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+
+/**
+ * @brief Occupied region of a ring as at most two contiguous pieces
+ *
+ * first holds the oldest elements up to the physical end of the buffer,
+ * second the elements that wrapped around to its start. Kernels loop over
+ * both pieces and never see the masking.
+ *
+ * @tparam T element (or field) type
+ */
+template <typename T>
+struct RingSegments {
+    const T* first = nullptr;
+    std::size_t first_size = 0;
+    const T* second = nullptr;
+    std::size_t second_size = 0;
+
+    [[nodiscard]] auto Size() const noexcept -> std::size_t
+    {
+        return first_size + second_size;
+    }
+
+    /**
+     * @brief Element at logical position index, 0 is the oldest
+     *
+     */
+    [[nodiscard]] auto operator[](std::size_t index) const noexcept -> const T&
+    {
+        return index < first_size ? first[index] : second[index - first_size];
+    }
+};
+
+/**
+ * @brief Split [head, tail) of a ring of Capacity slots starting at data
+ *
+ */
+template <typename T, std::size_t Capacity>
+[[nodiscard]] inline auto MakeRingSegments(const T* data, std::size_t head, std::size_t tail) noexcept -> RingSegments<T>
+{
+    RingSegments<T> segments;
+    segments.first = data + head;
+    if (head <= tail) {
+        segments.first_size = tail - head;
+    } else {
+        segments.first_size = Capacity - head;
+        segments.second = data;
+        segments.second_size = tail;
+    }
+    return segments;
+}
+
+} // namespace hft::core
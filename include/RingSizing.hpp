@@ -0,0 +1,276 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include "SPSC.hpp"
+#include "Tsc.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Worst backlog of a recorded ring and the capacity that would have absorbed it
+ *
+ */
+struct CapacityReport {
+    std::size_t capacity = 0; /// template Capacity of the recorded ring, Capacity - 1 usable
+    std::size_t slot_bytes = 0;
+    std::uint64_t arrivals = 0; /// accepted pushes
+    std::uint64_t departures = 0;
+    std::uint64_t dropped = 0;
+    std::uint64_t peak_backlog = 0; /// most messages queued at once, seen by the producer
+    std::uint64_t demand_backlog = 0; /// backlog had no push been dropped, upper bound from the buckets
+    double peak_time_ns = 0.0; /// start of the bucket holding the worst demand backlog
+    std::size_t recommended_capacity = 0; /// smallest power of two holding the worst backlog plus margin
+    bool truncated = false; /// session outlived the buckets, the tail went to the last one
+
+    /**
+     * @brief Footprint of the recorded ring's slots, what the cache pays for
+     *
+     */
+    [[nodiscard]] auto Bytes() const noexcept -> std::size_t
+    {
+        return capacity * slot_bytes;
+    }
+
+    [[nodiscard]] auto RecommendedBytes() const noexcept -> std::size_t
+    {
+        return recommended_capacity * slot_bytes;
+    }
+};
+
+/**
+ * @brief Per ring arrival and departure counts in fixed time buckets
+ *
+ * The producer calls OnPush() after each push attempt, the consumer OnPop()
+ * after each successful pop; each side writes only its own arrays, so it is
+ * safe with the ring's single producer and single consumer. Counters are
+ * relaxed atomics updated with load + store so Analyze() may run from a
+ * third thread during a live session.
+ *
+ * Besides the buckets the producer tracks the exact peak backlog: pushed
+ * minus the consumer's published pop count, read after each push, so a
+ * stale read only ever overestimates.
+ *
+ * Analysis mode, costs a TSC read and a division per message. Do not leave
+ * it on in production.
+ */
+class RingOccupancyRecorder {
+public:
+    /**
+     * @param capacity template Capacity of the ring being recorded
+     * @param slot_bytes sizeof one slot
+     * @param bucket_ns time granularity of the arrival and departure counts
+     * @param buckets session length is bucket_ns * buckets, later events land in the last bucket
+     */
+    RingOccupancyRecorder(std::size_t capacity, std::size_t slot_bytes, double bucket_ns = 1000.0, std::size_t buckets = 1U << 20U)
+        : capacity_(capacity)
+        , slot_bytes_(slot_bytes)
+        , bucket_ns_(bucket_ns)
+        , ticks_per_bucket_(std::max<std::uint64_t>(1, static_cast<std::uint64_t>(bucket_ns * TscPerNanosecond())))
+        , buckets_(buckets == 0 ? 1 : buckets)
+        , arrivals_(new std::atomic<std::uint32_t>[buckets_]())
+        , drops_(new std::atomic<std::uint32_t>[buckets_]())
+        , departures_(new std::atomic<std::uint32_t>[buckets_]())
+        , start_(ReadTsc())
+    {
+    }
+
+    /**
+     * @brief Producer thread, pushed messages accepted and dropped ones refused
+     *
+     */
+    void OnPush(std::size_t pushed, std::size_t dropped = 0) noexcept
+    {
+        const std::size_t bucket = Bucket();
+        if (pushed != 0) {
+            Add(arrivals_[bucket], pushed);
+            const std::uint64_t total = pushed_.load(std::memory_order_relaxed) + pushed;
+            pushed_.store(total, std::memory_order_relaxed);
+            const std::uint64_t backlog = total - popped_.load(std::memory_order_relaxed);
+            if (backlog > peak_.load(std::memory_order_relaxed)) {
+                peak_.store(backlog, std::memory_order_relaxed);
+            }
+        }
+        if (dropped != 0) [[unlikely]] {
+            Add(drops_[bucket], dropped);
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + dropped, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Consumer thread, popped messages
+     *
+     */
+    void OnPop(std::size_t popped = 1) noexcept
+    {
+        Add(departures_[Bucket()], popped);
+        popped_.store(popped_.load(std::memory_order_relaxed) + popped, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Worst backlog so far and the smallest capacity absorbing it
+     *
+     * The demand backlog replays the buckets as if dropped pushes had been
+     * queued and the consumer had kept its recorded pace; it can only
+     * overstate, since a consumer with more queued work would have popped
+     * more. Without drops it matches the peak up to bucket granularity.
+     *
+     * @param margin headroom over the worst backlog, 0.25 is 25%
+     */
+    [[nodiscard]] auto Analyze(double margin = 0.25) const noexcept -> CapacityReport
+    {
+        CapacityReport report;
+        report.capacity = capacity_;
+        report.slot_bytes = slot_bytes_;
+        report.arrivals = pushed_.load(std::memory_order_relaxed);
+        report.departures = popped_.load(std::memory_order_relaxed);
+        report.dropped = dropped_.load(std::memory_order_relaxed);
+        report.peak_backlog = peak_.load(std::memory_order_relaxed);
+        report.truncated = truncated_.load(std::memory_order_relaxed);
+
+        std::int64_t demand = 0;
+        for (std::size_t bucket = 0; bucket < buckets_; ++bucket) {
+            const auto in = static_cast<std::int64_t>(arrivals_[bucket].load(std::memory_order_relaxed))
+                + static_cast<std::int64_t>(drops_[bucket].load(std::memory_order_relaxed));
+            const auto out = static_cast<std::int64_t>(departures_[bucket].load(std::memory_order_relaxed));
+            demand = std::max<std::int64_t>(0, demand + in - out);
+            if (static_cast<std::uint64_t>(demand) > report.demand_backlog) {
+                report.demand_backlog = static_cast<std::uint64_t>(demand);
+                report.peak_time_ns = static_cast<double>(bucket) * bucket_ns_;
+            }
+        }
+
+        // Bucket counts lose intra bucket order, only trust them beyond the exact peak when pushes were dropped
+        const std::uint64_t worst = report.dropped == 0 ? report.peak_backlog : std::max(report.peak_backlog, report.demand_backlog);
+        const auto needed = static_cast<std::uint64_t>(std::ceil(static_cast<double>(worst) * (1.0 + margin)));
+        std::size_t capacity = 2;
+        while (capacity - 1 < needed) {
+            capacity <<= 1U;
+        }
+        report.recommended_capacity = capacity;
+        return report;
+    }
+
+    [[nodiscard]] auto BucketNanoseconds() const noexcept -> double
+    {
+        return bucket_ns_;
+    }
+
+private:
+    static void Add(std::atomic<std::uint32_t>& counter, std::size_t count) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + static_cast<std::uint32_t>(count), std::memory_order_relaxed);
+    }
+
+    auto Bucket() noexcept -> std::size_t
+    {
+        const std::uint64_t bucket = (ReadTsc() - start_) / ticks_per_bucket_;
+        if (bucket >= buckets_) [[unlikely]] {
+            truncated_.store(true, std::memory_order_relaxed);
+            return buckets_ - 1;
+        }
+        return static_cast<std::size_t>(bucket);
+    }
+
+    std::size_t capacity_;
+    std::size_t slot_bytes_;
+    double bucket_ns_;
+    std::uint64_t ticks_per_bucket_;
+    std::size_t buckets_;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> arrivals_; // Producer controlled
+    std::unique_ptr<std::atomic<std::uint32_t>[]> drops_; // Producer controlled
+    std::unique_ptr<std::atomic<std::uint32_t>[]> departures_; // Consumer controlled
+    std::uint64_t start_;
+
+    alignas(64) std::atomic<std::uint64_t> pushed_ { 0 }; // Producer controlled
+    std::atomic<std::uint64_t> dropped_ { 0 };
+    std::atomic<std::uint64_t> peak_ { 0 };
+    alignas(64) std::atomic<std::uint64_t> popped_ { 0 }; // Consumer controlled
+    std::atomic<bool> truncated_ { false }; // Either side, only ever set
+};
+
+/**
+ * @brief SPSCRingBuffer that records its occupancy, a drop-in for capacity sizing runs
+ *
+ * Works wherever the pipeline takes a ring type (LoadGenerator::Run,
+ * Gateway::Poll, FeedHandler stages), swap it in for a replay or a live
+ * session and read Analyze() at the end.
+ */
+template <typename T, std::size_t Capacity>
+class RecordedRing {
+public:
+    explicit RecordedRing(double bucket_ns = 1000.0, std::size_t buckets = 1U << 20U)
+        : recorder_(Capacity, sizeof(T), bucket_ns, buckets)
+    {
+    }
+
+    [[nodiscard]] auto Push(const T& value) noexcept -> bool
+    {
+        const bool pushed = ring_.Push(value);
+        recorder_.OnPush(pushed ? 1 : 0, pushed ? 0 : 1);
+        return pushed;
+    }
+
+    auto PushBatch(const T* values, std::size_t count) noexcept -> std::size_t
+    {
+        const std::size_t pushed = ring_.PushBatch(values, count);
+        recorder_.OnPush(pushed, count - pushed);
+        return pushed;
+    }
+
+    [[nodiscard]] auto Pop(T& out_value) noexcept -> bool
+    {
+        if (!ring_.Pop(out_value)) {
+            return false;
+        }
+        recorder_.OnPop();
+        return true;
+    }
+
+    [[nodiscard]] auto Empty() const noexcept -> bool
+    {
+        return ring_.Empty();
+    }
+
+    [[nodiscard]] auto GetDropCount() const noexcept -> std::size_t
+    {
+        return ring_.GetDropCount();
+    }
+
+    [[nodiscard]] auto Analyze(double margin = 0.25) const noexcept -> CapacityReport
+    {
+        return recorder_.Analyze(margin);
+    }
+
+private:
+    SPSCRingBuffer<T, Capacity> ring_;
+    RingOccupancyRecorder recorder_;
+};
+
+/**
+ * @brief One line summary of a report, with the recommendation
+ *
+ */
+inline void Print(std::ostream& out, const char* name, const CapacityReport& report)
+{
+    out << name << " capacity=" << report.capacity << " (" << report.Bytes() << " B)"
+        << " arrivals=" << report.arrivals << " dropped=" << report.dropped
+        << " peak=" << report.peak_backlog << " demand=" << report.demand_backlog
+        << " at " << static_cast<std::uint64_t>(report.peak_time_ns / 1000.0) << " us"
+        << " recommended=" << report.recommended_capacity << " (" << report.RecommendedBytes() << " B)";
+    if (report.dropped != 0) {
+        out << " undersized, rerun with the recommended capacity to confirm";
+    } else if (report.recommended_capacity < report.capacity) {
+        out << " oversized";
+    }
+    if (report.truncated) {
+        out << " truncated, use wider buckets";
+    }
+    out << '\n';
+}
+
+} // namespace hft::core
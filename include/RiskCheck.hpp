@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "Order.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Pre trade limits, applied to every instrument
+ *
+ */
+struct RiskLimits {
+    std::uint32_t max_order_quantity = 1000;
+    std::int64_t max_position = 10000; /// absolute, per instrument
+    std::int64_t max_order_notional = 100000000; /// price * quantity
+};
+
+/**
+ * @brief Pre trade risk stage
+ *
+ * Positions are updated optimistically when a new order passes, as if it
+ * filled completely, so in flight orders count against the limit. A
+ * Replace only passes the per order limits: its order was reserved by its
+ * New, and amends are not counted again. An amend that grows an order is
+ * not checked against max_position.
+ */
+class RiskCheck {
+public:
+    RiskCheck(std::uint32_t instruments, const RiskLimits& limits)
+        : limits_(limits)
+        , positions_(instruments, 0)
+    {
+    }
+
+    /**
+     * @brief Check order, and reserve its position when it passes
+     *
+     * Cancels always pass, Replaces reserve nothing.
+     *
+     * @param order
+     * @return true
+     * @return false
+     */
+    [[nodiscard]] auto Check(const OrderRequest& order) noexcept -> bool
+    {
+        if (order.action == OrderAction::Cancel) {
+            return true;
+        }
+        // |price| * quantity can overflow, compare |price| against the notional per unit instead
+        const std::uint64_t magnitude = order.price < 0 ? 0 - static_cast<std::uint64_t>(order.price) : static_cast<std::uint64_t>(order.price);
+        if (order.instrument >= positions_.size() || order.quantity == 0 || order.quantity > limits_.max_order_quantity
+            || limits_.max_order_notional < 0
+            || magnitude > static_cast<std::uint64_t>(limits_.max_order_notional) / order.quantity) [[unlikely]] {
+            ++rejected_;
+            return false;
+        }
+        if (order.action == OrderAction::Replace) {
+            return true;
+        }
+        const std::int64_t signed_quantity = order.side == Side::Buy ? order.quantity : -static_cast<std::int64_t>(order.quantity);
+        const std::int64_t position = positions_[order.instrument] + signed_quantity;
+        if (std::llabs(position) > limits_.max_position) [[unlikely]] {
+            ++rejected_;
+            return false;
+        }
+        positions_[order.instrument] = position;
+        return true;
+    }
+
+    /**
+     * @brief Undo the reservation of an order that passed Check() but was never sent
+     *
+     */
+    void Release(const OrderRequest& order) noexcept
+    {
+        if (order.action != OrderAction::New || order.instrument >= positions_.size()) {
+            return;
+        }
+        positions_[order.instrument] -= order.side == Side::Buy ? order.quantity : -static_cast<std::int64_t>(order.quantity);
+    }
+
+    [[nodiscard]] auto Position(std::uint32_t instrument) const noexcept -> std::int64_t
+    {
+        return positions_[instrument];
+    }
+
+    [[nodiscard]] auto GetRejectCount() const noexcept -> std::uint64_t
+    {
+        return rejected_;
+    }
+
+    /**
+     * @brief Copy positions to out, see SnapshotCoordinator
+     *
+     * @return std::size_t bytes written, 0 when capacity is too small
+     */
+    auto SaveSnapshot(std::uint8_t* out, std::size_t capacity) const noexcept -> std::size_t
+    {
+        const std::size_t size = positions_.size() * sizeof(std::int64_t);
+        if (size > capacity) {
+            return 0;
+        }
+        std::memcpy(out, positions_.data(), size);
+        return size;
+    }
+
+    [[nodiscard]] auto LoadSnapshot(const std::uint8_t* data, std::size_t size) noexcept -> bool
+    {
+        if (size != positions_.size() * sizeof(std::int64_t)) {
+            return false;
+        }
+        std::memcpy(positions_.data(), data, size);
+        return true;
+    }
+
+private:
+    RiskLimits limits_;
+    std::vector<std::int64_t> positions_;
+    std::uint64_t rejected_ = 0;
+};
+
+} // namespace hft::core
@@ -3,6 +3,7 @@
 #include <atomic>
 #include <type_traits>
 #include <cassert>
+#include "RingSegments.hpp"
 
 namespace hft::core {
 
@@ -44,6 +45,60 @@ public:
         return true;
     }
 
+    /**
+     * @brief Producer side, Push for edge triggered doorbells (ReadyBitmap)
+     *
+     * was_empty is set when the consumer had drained everything before this
+     * value, only then does the producer need to ring the bell. The tail is
+     * published seq_cst (xchg on x86, on the ring's own line) so it pairs
+     * with the consumer's IsDrained: either the consumer sees this value or
+     * the producer sees it drained.
+     *
+     * @param value
+     * @param was_empty out, valid when true is returned
+     * @return true
+     * @return false
+     */
+    [[nodiscard]] auto PushEdge(const T& value, bool& was_empty) noexcept -> bool
+    {
+        const std::size_t curr_tail = tail.load(std::memory_order_relaxed);
+        const std::size_t next_tail = (curr_tail + 1) & Mask;
+
+        if (next_tail == head.load(std::memory_order_acquire)) [[unlikely]] {
+            drop_count.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        buffer_[curr_tail] = value;
+        tail.store(next_tail, std::memory_order_seq_cst);
+        was_empty = head.load(std::memory_order_seq_cst) == curr_tail;
+        return true;
+    }
+
+    /**
+     * @brief Producer side, push as many of values as fit with one publish of tail
+     *
+     * @param values
+     * @param count
+     * @return std::size_t values pushed, the rest are counted as drops
+     */
+    auto PushBatch(const T* values, std::size_t count) noexcept -> std::size_t
+    {
+        const std::size_t curr_tail = tail.load(std::memory_order_relaxed);
+        const std::size_t free = (head.load(std::memory_order_acquire) - curr_tail - 1) & Mask;
+        const std::size_t pushed = count < free ? count : free;
+
+        for (std::size_t i = 0; i < pushed; ++i) {
+            buffer_[(curr_tail + i) & Mask] = values[i];
+        }
+        tail.store((curr_tail + pushed) & Mask, std::memory_order_release);
+
+        if (pushed != count) [[unlikely]] {
+            drop_count.fetch_add(count - pushed, std::memory_order_relaxed);
+        }
+        return pushed;
+    }
+
     /**
      * @brief Consumer size responsible from pop
      *
@@ -66,6 +121,22 @@ public:
         return true;
     }
 
+    /**
+     * @brief Consumer side, confirm the ring is empty after Pop failed
+     *
+     * Pairs with PushEdge: a false return means a value arrived whose
+     * producer saw the ring non-empty and will not ring the bell, keep
+     * popping.
+     *
+     * @return true
+     * @return false
+     */
+    [[nodiscard]] auto IsDrained() const noexcept -> bool
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+
     /**
      * @brief Get the Drop Count object
      *
@@ -87,6 +158,17 @@ public:
         return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_relaxed);
     }
 
+    /**
+     * @brief Consumer side, occupied slots oldest first, valid until the next Pop
+     *
+     * @return RingSegments<T>
+     */
+    [[nodiscard]] auto Segments() const noexcept -> RingSegments<T>
+    {
+        const std::size_t curr_head = head.load(std::memory_order_relaxed);
+        return MakeRingSegments<T, Capacity>(buffer_.data(), curr_head, tail.load(std::memory_order_acquire));
+    }
+
 private:
     // Aligning the buffer and indices to separate cache lines (64 bytes)
     // prevents "False Sharing" which would destroy HFT performance.
@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "Tsc.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Single writer, many reader snapshot of a small value
+ *
+ * The writer never waits; readers retry while a write is in progress. The
+ * payload is copied word by word through relaxed atomics so a torn read is
+ * only ever discarded, never undefined behaviour.
+ *
+ * @tparam T trivially copyable, a few cache lines at most
+ */
+template <typename T>
+class alignas(64) Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
+
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+public:
+    Seqlock() noexcept
+    {
+        Store(T {});
+    }
+
+    /**
+     * @brief Writer side
+     *
+     */
+    void Store(const T& value) noexcept
+    {
+        std::array<std::uint64_t, kWords> words {};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        const std::uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < kWords; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Reader side, one attempt
+     *
+     * @return true
+     * @return false when a write overlapped, out_value is unspecified
+     */
+    [[nodiscard]] auto TryLoad(T& out_value) const noexcept -> bool
+    {
+        const std::uint32_t before = sequence_.load(std::memory_order_acquire);
+        if ((before & 1U) != 0) {
+            return false;
+        }
+        std::array<std::uint64_t, kWords> words;
+        for (std::size_t i = 0; i < kWords; ++i) {
+            words[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(static_cast<void*>(&out_value), words.data(), sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Reader side, retries until a consistent copy is read
+     *
+     */
+    [[nodiscard]] auto Load() const noexcept -> T
+    {
+        T value;
+        while (!TryLoad(value)) {
+            CpuRelax();
+        }
+        return value;
+    }
+
+    /**
+     * @brief Number of completed writes, the initial T {} included
+     *
+     */
+    [[nodiscard]] auto Version() const noexcept -> std::uint32_t
+    {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    std::atomic<std::uint32_t> sequence_ { 0 };
+    std::array<std::atomic<std::uint64_t>, kWords> words_ {};
+};
+
+} // namespace hft::core
@@ -0,0 +1,492 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace hft::core {
+
+/**
+ * @brief Neumaier compensated sum, stays exact enough under long add/remove streams
+ *
+ */
+class CompensatedSum {
+public:
+    void Add(double value) noexcept
+    {
+        const double total = sum_ + value;
+        if (std::fabs(sum_) >= std::fabs(value)) {
+            compensation_ += (sum_ - total) + value;
+        } else {
+            compensation_ += (value - total) + sum_;
+        }
+        sum_ = total;
+    }
+
+    [[nodiscard]] auto Value() const noexcept -> double
+    {
+        return sum_ + compensation_;
+    }
+
+    void Reset() noexcept
+    {
+        sum_ = 0.0;
+        compensation_ = 0.0;
+    }
+
+private:
+    double sum_ = 0.0;
+    double compensation_ = 0.0;
+};
+
+/**
+ * @brief Count, mean and sum of squared deviations of a multiset
+ *
+ * Welford updates for single samples, Chan et al. for whole slices, both
+ * in the adding and the removing direction.
+ */
+struct RollingMoments {
+    double count = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void Add(double value) noexcept
+    {
+        count += 1.0;
+        const double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+    }
+
+    void Remove(double value) noexcept
+    {
+        if (count <= 1.0) {
+            *this = RollingMoments {};
+            return;
+        }
+        count -= 1.0;
+        const double delta = value - mean;
+        mean -= delta / count;
+        m2 -= delta * (value - mean);
+    }
+
+    void Merge(const RollingMoments& other) noexcept
+    {
+        if (other.count == 0.0) {
+            return;
+        }
+        const double total = count + other.count;
+        const double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * count * other.count / total;
+        count = total;
+    }
+
+    /**
+     * @brief Inverse of Merge, other must be a subset of this
+     *
+     */
+    void Unmerge(const RollingMoments& other) noexcept
+    {
+        if (other.count == 0.0) {
+            return;
+        }
+        const double rest = count - other.count;
+        if (rest <= 0.0) {
+            *this = RollingMoments {};
+            return;
+        }
+        const double rest_mean = (count * mean - other.count * other.mean) / rest;
+        const double delta = other.mean - rest_mean;
+        m2 -= other.m2 + delta * delta * rest * other.count / count;
+        mean = rest_mean;
+        count = rest;
+    }
+};
+
+/**
+ * @brief Limits of a sliding window, whichever is hit first evicts
+ *
+ */
+struct WindowConfig {
+    std::size_t max_count = 0; /// last N samples, 0 means the window capacity
+    std::uint64_t max_age = 0; /// samples younger than this (same unit as timestamps), 0 means no time limit
+};
+
+namespace detail {
+
+    /**
+     * @brief Min or max over a window as a monotonic deque of (position, value)
+     *
+     * Holds only positions still inside the window, so Capacity entries are
+     * enough and nothing is allocated.
+     */
+    template <std::size_t Capacity, bool kMin>
+    class MonotonicQueue {
+        static constexpr std::size_t Mask = Capacity - 1;
+
+    public:
+        void Push(std::uint64_t position, double value) noexcept
+        {
+            // Equal values are dropped from the back, the newer one lives longer
+            while (end_ != begin_ && !Keeps(values_[(end_ - 1) & Mask], value)) {
+                --end_;
+            }
+            positions_[end_ & Mask] = position;
+            values_[end_ & Mask] = value;
+            ++end_;
+        }
+
+        void Expire(std::uint64_t first_live) noexcept
+        {
+            while (begin_ != end_ && positions_[begin_ & Mask] < first_live) {
+                ++begin_;
+            }
+        }
+
+        [[nodiscard]] auto Front() const noexcept -> double
+        {
+            return begin_ == end_ ? std::numeric_limits<double>::quiet_NaN() : values_[begin_ & Mask];
+        }
+
+    private:
+        static auto Keeps(double back, double incoming) noexcept -> bool
+        {
+            return kMin ? back < incoming : back > incoming;
+        }
+
+        std::array<std::uint64_t, Capacity> positions_ {};
+        std::array<double, Capacity> values_ {};
+        std::uint64_t begin_ = 0;
+        std::uint64_t end_ = 0;
+    };
+
+    /**
+     * @brief Sums and moments of a contiguous slice
+     *
+     * Independent lane accumulators keep the loops free of a serial
+     * floating point dependency so the compiler can vectorize them.
+     */
+    struct SliceSums {
+        double sum = 0.0;
+        double weight = 0.0;
+        double weighted = 0.0;
+        RollingMoments moments;
+    };
+
+    inline auto SumSlice(const double* values, const double* weights, std::size_t count) noexcept -> SliceSums
+    {
+        constexpr std::size_t kLanes = 4;
+        SliceSums result;
+        if (count == 0) {
+            return result;
+        }
+        double sum[kLanes] = {};
+        double weight[kLanes] = {};
+        double weighted[kLanes] = {};
+        std::size_t i = 0;
+        for (; i + kLanes <= count; i += kLanes) {
+            for (std::size_t lane = 0; lane < kLanes; ++lane) {
+                sum[lane] += values[i + lane];
+                weight[lane] += weights[i + lane];
+                weighted[lane] += values[i + lane] * weights[i + lane];
+            }
+        }
+        for (; i < count; ++i) {
+            sum[0] += values[i];
+            weight[0] += weights[i];
+            weighted[0] += values[i] * weights[i];
+        }
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            result.sum += sum[lane];
+            result.weight += weight[lane];
+            result.weighted += weighted[lane];
+        }
+
+        // Second pass around the slice mean, avoids the cancellation of sum of squares
+        const double mean = result.sum / static_cast<double>(count);
+        double m2[kLanes] = {};
+        for (i = 0; i + kLanes <= count; i += kLanes) {
+            for (std::size_t lane = 0; lane < kLanes; ++lane) {
+                const double delta = values[i + lane] - mean;
+                m2[lane] += delta * delta;
+            }
+        }
+        for (; i < count; ++i) {
+            const double delta = values[i] - mean;
+            m2[0] += delta * delta;
+        }
+        result.moments.count = static_cast<double>(count);
+        result.moments.mean = mean;
+        result.moments.m2 = m2[0] + m2[1] + m2[2] + m2[3];
+        return result;
+    }
+
+} // namespace detail
+
+/**
+ * @brief Rolling min/max/sum/mean/variance/VWAP over the last N samples or last T time units
+ *
+ * Samples live in a struct-of-arrays ring of Capacity slots. Every Add is
+ * O(1) amortized: monotonic deques for min and max, compensated sums for
+ * sum and VWAP, Welford for the variance; nothing allocates. AddBatch
+ * evicts and inserts whole slices and aggregates them with vectorizable
+ * loops, only the min/max deques are still fed one sample at a time.
+ *
+ * Timestamps must be non-decreasing. For VWAP pass price as value and
+ * quantity as weight.
+ *
+ * @tparam Capacity power of two, upper bound of samples in the window
+ */
+template <std::size_t Capacity>
+class SlidingWindow {
+    static_assert((Capacity != 0U) && ((Capacity & (Capacity - 1)) == 0), "Capacity must be a power of 2.");
+
+    static constexpr std::size_t Mask = Capacity - 1;
+
+public:
+    explicit SlidingWindow(WindowConfig config = {}) noexcept
+        : max_count_(config.max_count == 0 || config.max_count > Capacity ? Capacity : config.max_count)
+        , max_age_(config.max_age)
+    {
+    }
+
+    void Add(std::uint64_t timestamp, double value, double weight = 1.0) noexcept
+    {
+        if (end_ - begin_ == max_count_) {
+            EvictOldest();
+        }
+        EvictOlderThan(timestamp);
+
+        const std::size_t slot = end_ & Mask;
+        timestamps_[slot] = timestamp;
+        values_[slot] = value;
+        weights_[slot] = weight;
+
+        sum_.Add(value);
+        weight_sum_.Add(weight);
+        weighted_sum_.Add(value * weight);
+        moments_.Add(value);
+        min_.Push(end_, value);
+        max_.Push(end_, value);
+        ++end_;
+    }
+
+    /**
+     * @brief Same result as calling Add for each sample, weights may be nullptr (all 1)
+     *
+     */
+    void AddBatch(const std::uint64_t* timestamps, const double* values, const double* weights, std::size_t count) noexcept
+    {
+        std::array<double, kUnitBlock> units;
+        if (weights == nullptr) {
+            units.fill(1.0);
+        }
+        while (count > 0) {
+            std::size_t chunk = count < max_count_ ? count : max_count_;
+            if (weights == nullptr && chunk > kUnitBlock) {
+                chunk = kUnitBlock;
+            }
+            AddChunk(timestamps, values, weights == nullptr ? units.data() : weights, chunk);
+            timestamps += chunk;
+            values += chunk;
+            if (weights != nullptr) {
+                weights += chunk;
+            }
+            count -= chunk;
+        }
+    }
+
+    /**
+     * @brief Drop samples that aged out at now, for time windows without new ticks
+     *
+     */
+    void Expire(std::uint64_t now) noexcept
+    {
+        EvictOlderThan(now);
+    }
+
+    [[nodiscard]] auto Count() const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(end_ - begin_);
+    }
+
+    [[nodiscard]] auto Empty() const noexcept -> bool
+    {
+        return end_ == begin_;
+    }
+
+    /**
+     * @brief NaN when empty
+     *
+     */
+    [[nodiscard]] auto Min() const noexcept -> double
+    {
+        return min_.Front();
+    }
+
+    /**
+     * @brief NaN when empty
+     *
+     */
+    [[nodiscard]] auto Max() const noexcept -> double
+    {
+        return max_.Front();
+    }
+
+    [[nodiscard]] auto Sum() const noexcept -> double
+    {
+        return sum_.Value();
+    }
+
+    [[nodiscard]] auto Mean() const noexcept -> double
+    {
+        return Empty() ? std::numeric_limits<double>::quiet_NaN() : sum_.Value() / static_cast<double>(Count());
+    }
+
+    /**
+     * @brief Population variance, NaN when empty
+     *
+     */
+    [[nodiscard]] auto Variance() const noexcept -> double
+    {
+        if (Empty()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return moments_.m2 > 0.0 ? moments_.m2 / moments_.count : 0.0;
+    }
+
+    /**
+     * @brief Sum(value * weight) / Sum(weight), NaN when the weights sum to 0
+     *
+     */
+    [[nodiscard]] auto Vwap() const noexcept -> double
+    {
+        const double weight = weight_sum_.Value();
+        return weight == 0.0 ? std::numeric_limits<double>::quiet_NaN() : weighted_sum_.Value() / weight;
+    }
+
+private:
+    static constexpr std::size_t kUnitBlock = 256;
+
+    void EvictOldest() noexcept
+    {
+        const std::size_t slot = begin_ & Mask;
+        sum_.Add(-values_[slot]);
+        weight_sum_.Add(-weights_[slot]);
+        weighted_sum_.Add(-values_[slot] * weights_[slot]);
+        moments_.Remove(values_[slot]);
+        ++begin_;
+        if (begin_ == end_) {
+            ResetSums();
+        }
+        min_.Expire(begin_);
+        max_.Expire(begin_);
+    }
+
+    void EvictOlderThan(std::uint64_t now) noexcept
+    {
+        if (max_age_ == 0) {
+            return;
+        }
+        while (begin_ != end_ && Expired(timestamps_[begin_ & Mask], now)) {
+            EvictOldest();
+        }
+    }
+
+    [[nodiscard]] auto Expired(std::uint64_t timestamp, std::uint64_t now) const noexcept -> bool
+    {
+        return max_age_ != 0 && now >= timestamp && now - timestamp >= max_age_;
+    }
+
+    void AddChunk(const std::uint64_t* timestamps, const double* values, const double* weights, std::size_t count) noexcept
+    {
+        const std::uint64_t new_end = end_ + count;
+        std::uint64_t new_begin = new_end - begin_ > max_count_ ? new_end - max_count_ : begin_;
+        const std::uint64_t now = timestamps[count - 1];
+        while (new_begin < end_ && Expired(timestamps_[new_begin & Mask], now)) {
+            ++new_begin;
+        }
+        while (new_begin >= end_ && new_begin < new_end && Expired(timestamps[new_begin - end_], now)) {
+            ++new_begin;
+        }
+
+        // Retained samples never share a slot with the incoming ones, evict before overwriting
+        const std::uint64_t evict_end = new_begin < end_ ? new_begin : end_;
+        if (evict_end == end_) {
+            ResetSums();
+        } else {
+            RemoveRange(begin_, evict_end);
+        }
+
+        const std::uint64_t first_new = new_begin > end_ ? new_begin : end_;
+        const std::size_t skip = static_cast<std::size_t>(first_new - end_);
+        for (std::uint64_t position = first_new; position < new_end; ++position) {
+            const std::size_t slot = position & Mask;
+            const std::size_t input = static_cast<std::size_t>(position - end_);
+            timestamps_[slot] = timestamps[input];
+            values_[slot] = values[input];
+            weights_[slot] = weights[input];
+        }
+        Merge(detail::SumSlice(values + skip, weights + skip, count - skip));
+
+        begin_ = new_begin;
+        end_ = new_end;
+        min_.Expire(begin_);
+        max_.Expire(begin_);
+        for (std::uint64_t position = first_new; position < new_end; ++position) {
+            const double value = values[position - (new_end - count)];
+            min_.Push(position, value);
+            max_.Push(position, value);
+        }
+    }
+
+    void RemoveRange(std::uint64_t from, std::uint64_t to) noexcept
+    {
+        while (from < to) {
+            const std::size_t slot = from & Mask;
+            const std::size_t run = static_cast<std::size_t>(to - from) < Capacity - slot ? static_cast<std::size_t>(to - from) : Capacity - slot;
+            const detail::SliceSums removed = detail::SumSlice(values_.data() + slot, weights_.data() + slot, run);
+            sum_.Add(-removed.sum);
+            weight_sum_.Add(-removed.weight);
+            weighted_sum_.Add(-removed.weighted);
+            moments_.Unmerge(removed.moments);
+            from += run;
+        }
+    }
+
+    void Merge(const detail::SliceSums& added) noexcept
+    {
+        sum_.Add(added.sum);
+        weight_sum_.Add(added.weight);
+        weighted_sum_.Add(added.weighted);
+        moments_.Merge(added.moments);
+    }
+
+    void ResetSums() noexcept
+    {
+        // An empty window restarts exactly, rounding residue does not carry over
+        sum_.Reset();
+        weight_sum_.Reset();
+        weighted_sum_.Reset();
+        moments_ = RollingMoments {};
+    }
+
+    alignas(64) std::array<std::uint64_t, Capacity> timestamps_ {};
+    alignas(64) std::array<double, Capacity> values_ {};
+    alignas(64) std::array<double, Capacity> weights_ {};
+    detail::MonotonicQueue<Capacity, true> min_;
+    detail::MonotonicQueue<Capacity, false> max_;
+
+    std::size_t max_count_;
+    std::uint64_t max_age_;
+    std::uint64_t begin_ = 0;
+    std::uint64_t end_ = 0;
+    CompensatedSum sum_;
+    CompensatedSum weight_sum_;
+    CompensatedSum weighted_sum_;
+    RollingMoments moments_;
+};
+
+} // namespace hft::core
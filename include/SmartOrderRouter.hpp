@@ -0,0 +1,317 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Order.hpp"
+#include "OrderEncoder.hpp"
+#include "Profile.hpp"
+#include "SPSC.hpp"
+#include "Seqlock.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Top of book of one instrument on one venue
+ *
+ */
+struct VenueQuote {
+    std::int64_t bid_price = 0;
+    std::int64_t ask_price = 0;
+    std::uint32_t bid_quantity = 0;
+    std::uint32_t ask_quantity = 0;
+    std::uint64_t timestamp = 0;
+};
+
+/**
+ * @brief Consolidated per-venue top of book, one seqlock per (instrument, venue)
+ *
+ * Each venue's market data thread writes its own quotes; routers on any
+ * thread read consistent snapshots without locking the writers out. The
+ * venues of an instrument are adjacent in memory so a routing decision
+ * walks one contiguous block.
+ *
+ * @tparam MaxVenues
+ */
+template <std::size_t MaxVenues = 16>
+class ConsolidatedBook {
+public:
+    explicit ConsolidatedBook(std::uint32_t instruments)
+        : quotes_(static_cast<std::size_t>(instruments) * MaxVenues)
+        , instruments_(instruments)
+    {
+    }
+
+    /**
+     * @brief Venue feed side, one writer per (venue, instrument)
+     *
+     * @return false for a venue or instrument out of range, nothing is stored
+     */
+    auto Update(std::uint32_t venue, std::uint32_t instrument, const VenueQuote& quote) noexcept -> bool
+    {
+        if (venue >= MaxVenues || instrument >= instruments_) [[unlikely]] {
+            return false;
+        }
+        quotes_[Index(venue, instrument)].Store(quote);
+        return true;
+    }
+
+    /**
+     * @brief Consistent snapshot, an empty quote for a venue or instrument out of range
+     *
+     */
+    [[nodiscard]] auto Quote(std::uint32_t venue, std::uint32_t instrument) const noexcept -> VenueQuote
+    {
+        if (venue >= MaxVenues || instrument >= instruments_) [[unlikely]] {
+            return VenueQuote {};
+        }
+        return quotes_[Index(venue, instrument)].Load();
+    }
+
+    [[nodiscard]] auto InstrumentCount() const noexcept -> std::uint32_t
+    {
+        return instruments_;
+    }
+
+private:
+    static auto Index(std::uint32_t venue, std::uint32_t instrument) noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(instrument) * MaxVenues + venue;
+    }
+
+    std::vector<Seqlock<VenueQuote>> quotes_;
+    std::uint32_t instruments_;
+};
+
+/**
+ * @brief Static cost model of a venue
+ *
+ */
+struct VenueProfile {
+    std::int64_t fee_per_unit = 0; /// price units per unit of quantity, negative for a rebate
+    std::uint64_t latency_ns = 0; /// order to exchange estimate, refined by RecordLatency
+    bool enabled = true;
+};
+
+struct RouterConfig {
+    std::int64_t latency_cost_per_us = 0; /// price units per unit of quantity per microsecond of venue latency
+    double latency_smoothing = 0.125; /// EWMA weight of a new latency sample
+};
+
+struct ChildOrder {
+    std::uint64_t order_id = 0;
+    std::int64_t price = 0;
+    std::uint32_t venue = 0;
+    std::uint32_t quantity = 0;
+};
+
+template <std::size_t MaxVenues>
+struct RouteResult {
+    std::array<ChildOrder, MaxVenues> children {};
+    std::uint32_t child_count = 0;
+    std::uint32_t routed = 0; /// quantity handed to venue gateways
+    std::uint32_t unrouted = 0; /// quantity no venue displays within the limit
+};
+
+/**
+ * @brief Splits parent orders across venues by all-in price
+ *
+ * For a New parent order every venue displaying liquidity within the
+ * limit price is ranked by price plus fee plus a latency penalty, and the
+ * displayed quantity is taken greedily. Each child is encoded into that
+ * venue's own SPSC ring, which the venue's Gateway polls.
+ *
+ * Child order ids are kChildIdFlag | (parent_id * MaxVenues + venue), so
+ * acks map back to the parent (ParentId) and never collide with ids of
+ * orders sent directly. Parent ids must be below kMaxParentId, Route
+ * refuses others.
+ *
+ * A decision is one branch free scan over at most MaxVenues quotes and a
+ * selection per child order, no allocation.
+ *
+ * @tparam MaxVenues
+ * @tparam RingCapacity per venue gateway ring
+ */
+template <std::size_t MaxVenues = 16, std::size_t RingCapacity = 4096>
+class SmartOrderRouter {
+public:
+    using VenueRing = SPSCRingBuffer<EncodedOrder, RingCapacity>;
+    using Result = RouteResult<MaxVenues>;
+
+    static constexpr std::uint64_t kChildIdFlag = std::uint64_t { 1 } << 63U;
+    static constexpr std::uint64_t kMaxParentId = kChildIdFlag / MaxVenues;
+
+    [[nodiscard]] static constexpr auto ChildId(std::uint64_t parent_id, std::uint32_t venue) noexcept -> std::uint64_t
+    {
+        return kChildIdFlag | (parent_id * MaxVenues + venue);
+    }
+
+    [[nodiscard]] static constexpr auto IsChildId(std::uint64_t order_id) noexcept -> bool
+    {
+        return (order_id & kChildIdFlag) != 0;
+    }
+
+    [[nodiscard]] static constexpr auto ParentId(std::uint64_t child_id) noexcept -> std::uint64_t
+    {
+        return (child_id & ~kChildIdFlag) / MaxVenues;
+    }
+
+    SmartOrderRouter(const ConsolidatedBook<MaxVenues>& book, std::uint32_t venue_count, RouterConfig config = {})
+        : book_(book)
+        , venue_count_(venue_count < MaxVenues ? venue_count : static_cast<std::uint32_t>(MaxVenues))
+        , config_(config)
+    {
+        for (std::uint32_t venue = 0; venue < venue_count_; ++venue) {
+            rings_[venue] = std::make_unique<VenueRing>();
+        }
+    }
+
+    void SetVenue(std::uint32_t venue, const VenueProfile& profile) noexcept
+    {
+        if (venue < venue_count_) {
+            profiles_[venue] = profile;
+            UpdatePenalty(venue);
+        }
+    }
+
+    [[nodiscard]] auto Venue(std::uint32_t venue) const noexcept -> const VenueProfile&
+    {
+        return profiles_[venue];
+    }
+
+    /**
+     * @brief Feed an observed order to ack round trip into the venue latency estimate
+     *
+     */
+    void RecordLatency(std::uint32_t venue, std::uint64_t latency_ns) noexcept
+    {
+        if (venue >= venue_count_) {
+            return;
+        }
+        const double current = static_cast<double>(profiles_[venue].latency_ns);
+        const double updated = current + config_.latency_smoothing * (static_cast<double>(latency_ns) - current);
+        profiles_[venue].latency_ns = static_cast<std::uint64_t>(updated);
+        UpdatePenalty(venue);
+    }
+
+    /**
+     * @brief Ring the gateway of venue polls
+     *
+     */
+    [[nodiscard]] auto Ring(std::uint32_t venue) noexcept -> VenueRing&
+    {
+        return *rings_[venue];
+    }
+
+    /**
+     * @brief Route a New parent order, children go straight into the venue rings
+     *
+     * @return std::uint32_t routed quantity, the same as out.routed
+     */
+    auto Route(const OrderRequest& parent, Result& out) noexcept -> std::uint32_t
+    {
+        HFT_PROFILE_SCOPE("router.route");
+        out.child_count = 0;
+        out.routed = 0;
+        out.unrouted = parent.quantity;
+        if (parent.action != OrderAction::New || parent.instrument >= book_.InstrumentCount() || parent.order_id >= kMaxParentId) [[unlikely]] {
+            return 0;
+        }
+
+        const bool buy = parent.side == Side::Buy;
+        std::array<Candidate, MaxVenues> candidates;
+        std::size_t count = 0;
+        for (std::uint32_t venue = 0; venue < venue_count_; ++venue) {
+            const VenueProfile& profile = profiles_[venue];
+            const VenueQuote quote = book_.Quote(venue, parent.instrument);
+            const std::int64_t price = buy ? quote.ask_price : quote.bid_price;
+            const std::uint32_t quantity = buy ? quote.ask_quantity : quote.bid_quantity;
+            const std::int64_t penalty = penalties_[venue];
+            // Lower is better for both sides: all-in cost of buying, negated all-in proceeds of selling
+            const std::int64_t score = buy ? price + profile.fee_per_unit + penalty : penalty + profile.fee_per_unit - price;
+            const bool eligible = profile.enabled & (quantity != 0) & (buy ? price <= parent.price : price >= parent.price);
+
+            // Branch free append, the slot is overwritten by the next venue when not eligible
+            candidates[count] = Candidate { score, price, profile.latency_ns, venue, quantity };
+            count += eligible ? 1 : 0;
+        }
+
+        // Selection instead of a full sort: only as many venues as it takes
+        // to fill the parent are ranked, and each pick is a predictable scan.
+        std::uint32_t remaining = parent.quantity;
+        while (count != 0 && remaining != 0) {
+            std::size_t best = 0;
+            for (std::size_t i = 1; i < count; ++i) {
+                best = Better(candidates[i], candidates[best]) ? i : best;
+            }
+            const Candidate candidate = candidates[best];
+            candidates[best] = candidates[--count];
+            const std::uint32_t quantity = candidate.quantity < remaining ? candidate.quantity : remaining;
+
+            OrderRequest child;
+            child.origin_timestamp = parent.origin_timestamp;
+            child.order_id = ChildId(parent.order_id, candidate.venue);
+            child.price = candidate.price;
+            child.instrument = parent.instrument;
+            child.quantity = quantity;
+            child.side = parent.side;
+            EncodedOrder encoded;
+            OrderEncoder::Encode(child, encoded);
+            if (!rings_[candidate.venue]->Push(encoded)) [[unlikely]] {
+                ++dropped_;
+                continue;
+            }
+            out.children[out.child_count++] = ChildOrder { child.order_id, child.price, candidate.venue, quantity };
+            remaining -= quantity;
+        }
+        out.routed = parent.quantity - remaining;
+        out.unrouted = remaining;
+        return out.routed;
+    }
+
+    [[nodiscard]] auto VenueCount() const noexcept -> std::uint32_t
+    {
+        return venue_count_;
+    }
+
+    /**
+     * @brief Child orders lost to a full venue ring
+     *
+     */
+    [[nodiscard]] auto GetDropCount() const noexcept -> std::uint64_t
+    {
+        return dropped_;
+    }
+
+private:
+    struct Candidate {
+        std::int64_t score;
+        std::int64_t price;
+        std::uint64_t latency_ns;
+        std::uint32_t venue;
+        std::uint32_t quantity;
+    };
+
+    // Latency cost per unit, kept out of Route() to avoid a division per venue
+    void UpdatePenalty(std::uint32_t venue) noexcept
+    {
+        penalties_[venue] = static_cast<std::int64_t>(profiles_[venue].latency_ns) * config_.latency_cost_per_us / 1000;
+    }
+
+    // Ties go to the faster venue
+    static auto Better(const Candidate& lhs, const Candidate& rhs) noexcept -> bool
+    {
+        return (lhs.score < rhs.score) | ((lhs.score == rhs.score) & (lhs.latency_ns < rhs.latency_ns));
+    }
+
+    const ConsolidatedBook<MaxVenues>& book_;
+    std::uint32_t venue_count_;
+    RouterConfig config_;
+    std::array<VenueProfile, MaxVenues> profiles_ {};
+    std::array<std::int64_t, MaxVenues> penalties_ {};
+    std::array<std::unique_ptr<VenueRing>, MaxVenues> rings_ {};
+    std::uint64_t dropped_ = 0;
+};
+
+} // namespace hft::core
@@ -0,0 +1,459 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hft::core {
+
+/**
+ * @brief Where one stage's state lives inside a snapshot slot
+ *
+ */
+struct SnapshotSection {
+    std::uint32_t id = 0;
+    std::uint32_t reserved = 0;
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+};
+
+/**
+ * @brief A committed snapshot, pointers into the mapping
+ *
+ */
+struct SnapshotView {
+    std::uint64_t barrier_sequence = 0;
+    const std::uint8_t* data = nullptr;
+    const SnapshotSection* sections = nullptr;
+    std::uint32_t section_count = 0;
+
+    /**
+     * @brief Section of stage id, nullptr when absent
+     *
+     */
+    [[nodiscard]] auto Find(std::uint32_t id) const noexcept -> const SnapshotSection*
+    {
+        for (std::uint32_t i = 0; i < section_count; ++i) {
+            if (sections[i].id == id) {
+                return &sections[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Memory mapped file with two snapshot slots, A/B
+ *
+ * A new snapshot is written into the inactive slot and becomes visible only
+ * when the header's active index flips after the slot was synced, so a crash
+ * mid-snapshot leaves the previous one intact.
+ */
+class SnapshotStore {
+public:
+    static constexpr std::uint32_t kMaxSections = 16;
+    static constexpr std::size_t kHeaderSize = 4096;
+
+    SnapshotStore() = default;
+
+    ~SnapshotStore()
+    {
+        Close();
+    }
+
+    SnapshotStore(const SnapshotStore&) = delete;
+    auto operator=(const SnapshotStore&) -> SnapshotStore& = delete;
+    SnapshotStore(SnapshotStore&&) = delete;
+    auto operator=(SnapshotStore&&) -> SnapshotStore& = delete;
+
+    /**
+     * @brief Create path, or open it when it already has the same slot size
+     *
+     * @param path
+     * @param slot_size bytes available for all sections of one snapshot
+     * @return true
+     * @return false on I/O error or slot size mismatch
+     */
+    [[nodiscard]] auto Open(const char* path, std::size_t slot_size) noexcept -> bool
+    {
+        Close();
+        const int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat status {};
+        const std::size_t size = kHeaderSize + (2 * slot_size);
+        const bool fresh = ::fstat(fd, &status) == 0 && status.st_size == 0;
+        if ((fresh && ::ftruncate(fd, static_cast<off_t>(size)) != 0) || (!fresh && static_cast<std::size_t>(status.st_size) != size)) {
+            ::close(fd);
+            return false;
+        }
+        void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            return false;
+        }
+        base_ = static_cast<std::uint8_t*>(base);
+        size_ = size;
+        slot_size_ = slot_size;
+
+        Header& header = GetHeader();
+        if (fresh) {
+            header.magic = Header::kMagic;
+            header.version = Header::kVersion;
+            header.active = kNoSlot;
+            header.slot_size = slot_size;
+        } else if (header.magic != Header::kMagic || header.version != Header::kVersion || header.slot_size != slot_size) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Close() noexcept
+    {
+        if (base_ != nullptr) {
+            ::munmap(base_, size_);
+        }
+        base_ = nullptr;
+        size_ = 0;
+    }
+
+    /**
+     * @brief Slot the next snapshot must be written to
+     *
+     */
+    [[nodiscard]] auto InactiveSlot() const noexcept -> std::uint32_t
+    {
+        return GetHeader().active == 0 ? 1 : 0;
+    }
+
+    [[nodiscard]] auto SlotData(std::uint32_t slot) noexcept -> std::uint8_t*
+    {
+        return base_ + kHeaderSize + (slot * slot_size_);
+    }
+
+    [[nodiscard]] auto SlotSize() const noexcept -> std::size_t
+    {
+        return slot_size_;
+    }
+
+    /**
+     * @brief Seal slot: checksum, sync data, then flip the active index
+     *
+     * Cold path, blocks on msync.
+     */
+    [[nodiscard]] auto Commit(std::uint32_t slot, std::uint64_t barrier_sequence, const SnapshotSection* sections, std::uint32_t count) noexcept -> bool
+    {
+        if (base_ == nullptr || slot > 1 || count > kMaxSections) {
+            return false;
+        }
+        SlotHeader& slot_header = GetHeader().slots[slot];
+        slot_header.barrier_sequence = barrier_sequence;
+        slot_header.section_count = count;
+        std::copy(sections, sections + count, slot_header.sections.begin());
+        slot_header.checksum = Checksum(slot, slot_header);
+        if (::msync(base_, size_, MS_SYNC) != 0) {
+            return false;
+        }
+        GetHeader().active = slot;
+        return ::msync(base_, kHeaderSize, MS_SYNC) == 0;
+    }
+
+    /**
+     * @brief Latest committed snapshot whose checksum still matches
+     *
+     * @param out
+     * @return true
+     * @return false when nothing valid was committed yet
+     */
+    [[nodiscard]] auto Latest(SnapshotView& out) const noexcept -> bool
+    {
+        if (base_ == nullptr) {
+            return false;
+        }
+        const Header& header = GetHeader();
+        if (header.active > 1) {
+            return false;
+        }
+        const SlotHeader& slot_header = header.slots[header.active];
+        if (slot_header.section_count > kMaxSections || Checksum(header.active, slot_header) != slot_header.checksum) {
+            return false;
+        }
+        out.barrier_sequence = slot_header.barrier_sequence;
+        out.data = base_ + kHeaderSize + (header.active * slot_size_);
+        out.sections = slot_header.sections.data();
+        out.section_count = slot_header.section_count;
+        return true;
+    }
+
+private:
+    static constexpr std::uint32_t kNoSlot = std::numeric_limits<std::uint32_t>::max();
+
+    struct SlotHeader {
+        std::uint64_t barrier_sequence;
+        std::uint64_t checksum;
+        std::uint32_t section_count;
+        std::uint32_t reserved;
+        std::array<SnapshotSection, kMaxSections> sections;
+    };
+
+    struct Header {
+        static constexpr std::uint64_t kMagic = 0x50414E5354464848ULL; // "HHFTSNAP"
+        static constexpr std::uint32_t kVersion = 1;
+
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t active;
+        std::uint64_t slot_size;
+        std::array<SlotHeader, 2> slots;
+    };
+
+    static_assert(sizeof(Header) <= kHeaderSize, "Snapshot header must fit its page.");
+
+    auto GetHeader() noexcept -> Header&
+    {
+        return *reinterpret_cast<Header*>(base_);
+    }
+
+    auto GetHeader() const noexcept -> const Header&
+    {
+        return *reinterpret_cast<const Header*>(base_);
+    }
+
+    auto Checksum(std::uint32_t slot, const SlotHeader& slot_header) const noexcept -> std::uint64_t
+    {
+        // FNV-1a over the sequence, section table and section payloads
+        std::uint64_t hash = 14695981039346656037ULL;
+        auto mix = [&hash](const std::uint8_t* data, std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i) {
+                hash ^= data[i];
+                hash *= 1099511628211ULL;
+            }
+        };
+        mix(reinterpret_cast<const std::uint8_t*>(&slot_header.barrier_sequence), sizeof(slot_header.barrier_sequence));
+        mix(reinterpret_cast<const std::uint8_t*>(slot_header.sections.data()), sizeof(SnapshotSection) * slot_header.section_count);
+        const std::uint8_t* data = base_ + kHeaderSize + (slot * slot_size_);
+        for (std::uint32_t i = 0; i < slot_header.section_count; ++i) {
+            const SnapshotSection& section = slot_header.sections[i];
+            if (section.offset + section.size > slot_size_) {
+                return ~slot_header.checksum;
+            }
+            mix(data + section.offset, section.size);
+        }
+        return hash;
+    }
+
+    std::uint8_t* base_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t slot_size_ = 0;
+};
+
+/**
+ * @brief Takes consistent snapshots without stopping the pipeline
+ *
+ * Every stage owns one section and quiesces for itself at the barrier
+ * sequence: right before processing the first event past the barrier (or
+ * when idle exactly at it) it copies its state into the inactive slot.
+ * The control thread commits once every stage captured. A stage that had
+ * already moved past the barrier when the request reached it cannot
+ * produce that state any more; it abandons the snapshot instead of saving
+ * a later state under the barrier's label, and TryCommit() drops it. The
+ * only hot path cost is one acquire load of the pending barrier per event.
+ *
+ * Stage state types provide:
+ *   std::size_t SaveSnapshot(std::uint8_t* out, std::size_t capacity) const
+ *   bool LoadSnapshot(const std::uint8_t* data, std::size_t size)
+ * SaveSnapshot returns the bytes written, 0 when capacity is too small.
+ */
+class SnapshotCoordinator {
+public:
+    explicit SnapshotCoordinator(SnapshotStore& store) noexcept
+        : store_(store)
+    {
+    }
+
+    /**
+     * @brief Reserve a section for a stage, before the pipeline starts
+     *
+     * @param id stable section id, used to find it again on restart
+     * @param max_size upper bound of the stage's SaveSnapshot output
+     * @return std::uint32_t stage index, or kInvalidStage when the slot is full
+     */
+    auto AddStage(std::uint32_t id, std::size_t max_size) -> std::uint32_t
+    {
+        const std::uint64_t offset = stage_count_ == 0 ? 0 : AlignUp(stages_[stage_count_ - 1].section.offset + stages_[stage_count_ - 1].section.size);
+        if (stage_count_ == SnapshotStore::kMaxSections || offset + max_size > store_.SlotSize()) {
+            return kInvalidStage;
+        }
+        stages_[stage_count_].section = SnapshotSection { id, 0, offset, max_size };
+        return stage_count_++;
+    }
+
+    /**
+     * @brief Ask every stage to capture its state as of barrier_sequence
+     *
+     * @return false when a snapshot is in progress or the barrier does not move forward
+     */
+    [[nodiscard]] auto Request(std::uint64_t barrier_sequence) noexcept -> bool
+    {
+        if (pending_.load(std::memory_order_relaxed) != kNone || barrier_sequence == kNone
+            || (last_barrier_ != kNone && barrier_sequence <= last_barrier_)) {
+            return false;
+        }
+        last_barrier_ = barrier_sequence;
+        slot_ = store_.InactiveSlot();
+        pending_.store(barrier_sequence, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Stage hook, call before processing the event with sequence
+     *
+     */
+    template <typename State>
+    void BeforeEvent(std::uint32_t stage, std::uint64_t sequence, const State& state) noexcept
+    {
+        const std::uint64_t barrier = pending_.load(std::memory_order_acquire);
+        if (barrier != kNone && sequence > barrier) [[unlikely]] {
+            Capture(stage, barrier, state);
+        }
+        stages_[stage].processed = sequence;
+    }
+
+    /**
+     * @brief Stage hook, call when idle with the last processed sequence
+     *
+     */
+    template <typename State>
+    void OnIdle(std::uint32_t stage, std::uint64_t processed_sequence, const State& state) noexcept
+    {
+        stages_[stage].processed = processed_sequence;
+        const std::uint64_t barrier = pending_.load(std::memory_order_acquire);
+        if (barrier != kNone && processed_sequence >= barrier) [[unlikely]] {
+            Capture(stage, barrier, state);
+        }
+    }
+
+    /**
+     * @brief Control thread, commit once all stages captured
+     *
+     * @return true when a snapshot was committed by this call
+     */
+    [[nodiscard]] auto TryCommit() noexcept -> bool
+    {
+        const std::uint64_t barrier = pending_.load(std::memory_order_acquire);
+        if (barrier == kNone) {
+            return false;
+        }
+        bool complete = true;
+        for (std::uint32_t i = 0; i < stage_count_; ++i) {
+            Stage& stage = stages_[i];
+            if (stage.captured.load(std::memory_order_acquire) != barrier) {
+                complete = false;
+            } else if (stage.written == 0) {
+                // A stage abandoned or did not fit its section, drop this snapshot
+                ++abandoned_;
+                pending_.store(kNone, std::memory_order_release);
+                return false;
+            }
+        }
+        if (!complete) {
+            return false;
+        }
+        std::array<SnapshotSection, SnapshotStore::kMaxSections> sections {};
+        for (std::uint32_t i = 0; i < stage_count_; ++i) {
+            sections[i] = stages_[i].section;
+            sections[i].size = stages_[i].written;
+        }
+        const bool committed = store_.Commit(slot_, barrier, sections.data(), stage_count_);
+        pending_.store(kNone, std::memory_order_release);
+        return committed;
+    }
+
+    [[nodiscard]] auto Pending() const noexcept -> bool
+    {
+        return pending_.load(std::memory_order_relaxed) != kNone;
+    }
+
+    /**
+     * @brief Snapshots dropped because a stage was past the barrier or did not fit its section
+     *
+     */
+    [[nodiscard]] auto GetAbandonedCount() const noexcept -> std::uint64_t
+    {
+        return abandoned_;
+    }
+
+    static constexpr std::uint32_t kInvalidStage = std::numeric_limits<std::uint32_t>::max();
+
+private:
+    static constexpr std::uint64_t kNone = std::numeric_limits<std::uint64_t>::max();
+
+    // Each stage writes its own line, the control thread only reads them
+    struct alignas(64) Stage {
+        SnapshotSection section;
+        std::size_t written = 0;
+        std::uint64_t processed = kNone; // Stage thread only, last sequence seen by a hook
+        std::atomic<std::uint64_t> captured { kNone };
+    };
+
+    static auto AlignUp(std::uint64_t offset) noexcept -> std::uint64_t
+    {
+        return (offset + 63) & ~std::uint64_t { 63 };
+    }
+
+    template <typename State>
+    void Capture(std::uint32_t index, std::uint64_t barrier, const State& state) noexcept
+    {
+        Stage& stage = stages_[index];
+        if (stage.captured.load(std::memory_order_relaxed) == barrier) {
+            return;
+        }
+        // Only the state right at the barrier may carry its label, a stage already past it abandons
+        const bool past = stage.processed != kNone && stage.processed > barrier;
+        stage.written = past ? 0 : state.SaveSnapshot(store_.SlotData(slot_) + stage.section.offset, stage.section.size);
+        stage.captured.store(barrier, std::memory_order_release);
+    }
+
+    SnapshotStore& store_;
+    std::array<Stage, SnapshotStore::kMaxSections> stages_ {};
+    std::uint32_t stage_count_ = 0;
+    std::uint32_t slot_ = 0;
+    std::uint64_t last_barrier_ = kNone;
+    std::uint64_t abandoned_ = 0;
+    alignas(64) std::atomic<std::uint64_t> pending_ { kNone };
+};
+
+/**
+ * @brief Restore one stage from the latest snapshot of store
+ *
+ * @param store
+ * @param id section id given to AddStage
+ * @param state stage to restore
+ * @param out_barrier sequence the state corresponds to, replay from the next one
+ * @return true
+ * @return false when there is no valid snapshot or section
+ */
+template <typename State>
+[[nodiscard]] auto RestoreStage(const SnapshotStore& store, std::uint32_t id, State& state, std::uint64_t& out_barrier) noexcept -> bool
+{
+    SnapshotView view;
+    if (!store.Latest(view)) {
+        return false;
+    }
+    const SnapshotSection* section = view.Find(id);
+    if (section == nullptr || !state.LoadSnapshot(view.data + section->offset, section->size)) {
+        return false;
+    }
+    out_barrier = view.barrier_sequence;
+    return true;
+}
+
+} // namespace hft::core
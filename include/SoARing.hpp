@@ -0,0 +1,186 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include "RingSegments.hpp"
+#include "ThreadModel.hpp"
+
+namespace hft::core {
+
+namespace detail {
+
+    template <auto Member>
+    struct MemberTraits;
+
+    template <typename C, typename M, M C::*Member>
+    struct MemberTraits<Member> {
+        using Class = C;
+        using Type = M;
+    };
+
+    template <auto A, auto B>
+    constexpr auto SameMember() noexcept -> bool
+    {
+        if constexpr (std::is_same_v<decltype(A), decltype(B)>) {
+            return A == B;
+        } else {
+            return false;
+        }
+    }
+
+} // namespace detail
+
+/**
+ * @brief Ring buffer in struct-of-arrays layout
+ *
+ * Each listed field of T lives in its own contiguous, cache line aligned
+ * array, so a consumer scanning prices touches only price cache lines.
+ * Push/Pop move whole elements field by field; Field<&T::m>() exposes the
+ * occupied slots of one field for vectorized kernels, and Consume(n)
+ * releases slots after such a scan.
+ *
+ *   SoARingBuffer<MarketEvent, 4096, ThreadModel::SPSC, &MarketEvent::price, &MarketEvent::quantity> ring;
+ *
+ * Fields not in the list are not stored; Pop leaves them untouched in the
+ * output.
+ *
+ * @tparam T element type
+ * @tparam Capacity power of two, Capacity - 1 usable slots
+ * @tparam Model SingleThread or SPSC, field views need a single consumer
+ * @tparam Fields pointers to the data members of T to store
+ */
+template <typename T, std::size_t Capacity, ThreadModel Model, auto... Fields>
+class SoARingBuffer {
+    static_assert(sizeof...(Fields) != 0, "SoARingBuffer needs at least one field.");
+    static_assert((std::is_same_v<typename detail::MemberTraits<Fields>::Class, T> && ...), "Fields must be data members of T.");
+    static_assert((std::is_trivially_copyable_v<typename detail::MemberTraits<Fields>::Type> && ...), "Fields must be trivially copyable.");
+    static_assert((Capacity != 0U) && ((Capacity & (Capacity - 1)) == 0), "Capacity must be a power of 2.");
+    static_assert(Model != ThreadModel::MPMC, "Field views require a single consumer.");
+
+    static constexpr std::size_t Mask = Capacity - 1;
+
+    using Traits = detail::ModelTraits<Model>;
+    using Index = typename Traits::Index;
+    static constexpr std::size_t kAlign = Traits::kAlign;
+
+    template <typename F>
+    struct alignas(64) FieldArray {
+        std::array<F, Capacity> values {};
+    };
+
+    template <auto Member>
+    static constexpr auto IndexOf() noexcept -> std::size_t
+    {
+        std::size_t index = 0;
+        std::size_t found = sizeof...(Fields);
+        ((detail::SameMember<Member, Fields>() ? (found = index++) : index++), ...);
+        return found;
+    }
+
+    template <auto Member>
+    using FieldType = typename detail::MemberTraits<Member>::Type;
+
+public:
+    /**
+     * @brief Producer side, scatter value into the field arrays
+     *
+     * @param value
+     * @return true
+     * @return false when full
+     */
+    [[nodiscard]] auto Push(const T& value) noexcept -> bool
+    {
+        const std::size_t current_tail = tail.load(std::memory_order_relaxed);
+        const std::size_t next_tail = (current_tail + 1) & Mask;
+        if (next_tail == head.load(std::memory_order_acquire)) [[unlikely]] {
+            drop_count.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        ((Array<Fields>()[current_tail] = value.*Fields), ...);
+        tail.store(next_tail, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side, gather the stored fields into out_value
+     *
+     * @param out_value
+     * @return true
+     * @return false when empty
+     */
+    [[nodiscard]] auto Pop(T& out_value) noexcept -> bool
+    {
+        const std::size_t current_head = head.load(std::memory_order_relaxed);
+        if (current_head == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        ((out_value.*Fields = Array<Fields>()[current_head]), ...);
+        head.store((current_head + 1) & Mask, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side, occupied slots of one field, oldest first
+     *
+     * Valid until the consumer calls Pop or Consume; slots pushed after the
+     * call are not included.
+     */
+    template <auto Member>
+    [[nodiscard]] auto Field() const noexcept -> RingSegments<FieldType<Member>>
+    {
+        const std::size_t current_head = head.load(std::memory_order_relaxed);
+        const std::size_t current_tail = tail.load(std::memory_order_acquire);
+        return MakeRingSegments<FieldType<Member>, Capacity>(Array<Member>().data(), current_head, current_tail);
+    }
+
+    /**
+     * @brief Consumer side, release the count oldest slots after a Field scan
+     *
+     */
+    void Consume(std::size_t count) noexcept
+    {
+        const std::size_t current_head = head.load(std::memory_order_relaxed);
+        const std::size_t available = (tail.load(std::memory_order_acquire) - current_head) & Mask;
+        head.store((current_head + (count < available ? count : available)) & Mask, std::memory_order_release);
+    }
+
+    [[nodiscard]] auto Empty() const noexcept -> bool
+    {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto Size() const noexcept -> std::size_t
+    {
+        return (tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed)) & Mask;
+    }
+
+    [[nodiscard]] auto GetDropCount() const noexcept -> std::size_t
+    {
+        return drop_count.load(std::memory_order_relaxed);
+    }
+
+private:
+    template <auto Member>
+    auto Array() noexcept -> std::array<FieldType<Member>, Capacity>&
+    {
+        static_assert(IndexOf<Member>() < sizeof...(Fields), "Member is not stored in this ring.");
+        return std::get<IndexOf<Member>()>(fields_).values;
+    }
+
+    template <auto Member>
+    auto Array() const noexcept -> const std::array<FieldType<Member>, Capacity>&
+    {
+        static_assert(IndexOf<Member>() < sizeof...(Fields), "Member is not stored in this ring.");
+        return std::get<IndexOf<Member>()>(fields_).values;
+    }
+
+    std::tuple<FieldArray<FieldType<Fields>>...> fields_;
+
+    alignas(kAlign) Index tail { 0 };
+    alignas(kAlign) Index head { 0 };
+    alignas(kAlign) std::atomic<std::size_t> drop_count { 0 };
+};
+
+} // namespace hft::core
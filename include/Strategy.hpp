@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "Order.hpp"
+#include "OrderBook.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Per instrument trigger prices of ThresholdTaker
+ *
+ */
+struct TakerThreshold {
+    std::int64_t buy_at_or_below = std::numeric_limits<std::int64_t>::min();
+    std::int64_t sell_at_or_above = std::numeric_limits<std::int64_t>::max();
+    std::uint32_t quantity = 1;
+};
+
+/**
+ * @brief Takes liquidity when the touch crosses a configured price
+ *
+ * Buys the best ask when it is at or below buy_at_or_below, sells the best
+ * bid when it is at or above sell_at_or_above. Instruments without a
+ * threshold never trade.
+ */
+class ThresholdTaker {
+public:
+    explicit ThresholdTaker(std::uint32_t instruments)
+        : thresholds_(instruments)
+    {
+    }
+
+    void SetThreshold(std::uint32_t instrument, const TakerThreshold& threshold) noexcept
+    {
+        thresholds_[instrument] = threshold;
+    }
+
+    /**
+     * @brief React to a top of book change
+     *
+     * @tparam Depth
+     * @param event the event that changed the book
+     * @param book book of event.instrument after the event
+     * @param out_order filled when an order should be sent
+     * @return true when out_order is valid
+     */
+    template <std::size_t Depth>
+    auto OnBook(const MarketEvent& event, const OrderBook<Depth>& book, OrderRequest& out_order) noexcept -> bool
+    {
+        if (event.instrument >= thresholds_.size()) [[unlikely]] {
+            return false;
+        }
+        const TakerThreshold& threshold = thresholds_[event.instrument];
+        const PriceLevel ask = book.BestAsk();
+        const PriceLevel bid = book.BestBid();
+
+        if (ask.quantity != 0 && ask.price <= threshold.buy_at_or_below) {
+            Fill(event, Side::Buy, ask, threshold.quantity, out_order);
+            return true;
+        }
+        if (bid.quantity != 0 && bid.price >= threshold.sell_at_or_above) {
+            Fill(event, Side::Sell, bid, threshold.quantity, out_order);
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] auto NextOrderId() const noexcept -> std::uint64_t
+    {
+        return next_order_id_;
+    }
+
+    /**
+     * @brief Order ids must not repeat after a restart
+     *
+     */
+    void SetNextOrderId(std::uint64_t order_id) noexcept
+    {
+        next_order_id_ = order_id;
+    }
+
+private:
+    void Fill(const MarketEvent& event, Side side, const PriceLevel& level, std::uint32_t quantity, OrderRequest& out_order) noexcept
+    {
+        out_order.origin_timestamp = event.timestamp;
+        out_order.order_id = next_order_id_++;
+        out_order.price = level.price;
+        out_order.instrument = event.instrument;
+        out_order.quantity = quantity < level.quantity ? quantity : level.quantity;
+        out_order.action = OrderAction::New;
+        out_order.side = side;
+    }
+
+    std::vector<TakerThreshold> thresholds_;
+    std::uint64_t next_order_id_ = 1;
+};
+
+} // namespace hft::core
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+namespace hft::core {
+
+/**
+ * @brief Threading model of a queue, selects how indices are stored
+ *
+ */
+enum class ThreadModel {
+    SingleThread, /// Producer and consumer on the same thread, plain integers and no fences
+    SPSC, /// One producer thread, one consumer thread
+    MPMC /// Consumers race on the head with CAS (previous RingBuffer behaviour)
+};
+
+namespace detail {
+
+    /**
+     * @brief Plain integer with the std::atomic interface used by the queues
+     *
+     * Lets the same Push/Pop bodies compile for every model; the memory orders
+     * are accepted and ignored so the single threaded case has no fences.
+     *
+     * @tparam I index type
+     */
+    template <typename I>
+    struct PlainIndex {
+        I value {};
+
+        constexpr PlainIndex() noexcept = default;
+        constexpr PlainIndex(I initial) noexcept
+            : value(initial)
+        {
+        }
+
+        [[nodiscard]] auto load(std::memory_order /*order*/ = std::memory_order_seq_cst) const noexcept -> I
+        {
+            return value;
+        }
+
+        void store(I desired, std::memory_order /*order*/ = std::memory_order_seq_cst) noexcept
+        {
+            value = desired;
+        }
+
+        auto fetch_add(I arg, std::memory_order /*order*/ = std::memory_order_seq_cst) noexcept -> I
+        {
+            const I previous = value;
+            value += arg;
+            return previous;
+        }
+
+        auto compare_exchange_strong(I& expected, I desired, std::memory_order /*success*/, std::memory_order /*failure*/) noexcept -> bool
+        {
+            if (value == expected) {
+                value = desired;
+                return true;
+            }
+            expected = value;
+            return false;
+        }
+    };
+
+    /**
+     * @brief Index storage for a threading model
+     *
+     * @tparam Model threading model
+     * @tparam I index type
+     */
+    template <ThreadModel Model, typename I = std::size_t>
+    struct ModelTraits {
+        using Index = std::atomic<I>;
+        // Separate cache lines for producer and consumer owned indices
+        static constexpr std::size_t kAlign = 64;
+    };
+
+    template <typename I>
+    struct ModelTraits<ThreadModel::SingleThread, I> {
+        using Index = PlainIndex<I>;
+        // Nothing is shared, keep the object compact
+        static constexpr std::size_t kAlign = alignof(I);
+    };
+
+} // namespace detail
+
+} // namespace hft::core
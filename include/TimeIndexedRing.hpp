@@ -0,0 +1,169 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "RingSegments.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief History ring of timestamped elements with O(log n) time lookup
+ *
+ * Keeps the newest Capacity elements, overwriting the oldest. Positions
+ * are free running and masked, so every slot is usable and the logical
+ * position of an element (0 = oldest retained) is independent of where
+ * the ring wrapped. Push only accepts non-decreasing timestamps, which is
+ * what makes the binary search valid.
+ *
+ * Not thread safe: the writer thread also answers the queries (e.g. a
+ * strategy asking for the book state at T - 5ms).
+ *
+ * @tparam T trivially copyable element
+ * @tparam Capacity power of two
+ * @tparam Timestamp pointer to the integral timestamp member of T
+ */
+template <typename T, std::size_t Capacity, auto Timestamp>
+class TimeIndexedRing {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
+    static_assert((Capacity != 0U) && ((Capacity & (Capacity - 1)) == 0), "Capacity must be a power of 2.");
+
+    static constexpr std::size_t Mask = Capacity - 1;
+
+public:
+    /**
+     * @brief Append value, overwriting the oldest element when full
+     *
+     * @return true
+     * @return false when value is older than the newest element, nothing is stored
+     */
+    [[nodiscard]] auto Push(const T& value) noexcept -> bool
+    {
+        if (end_ != begin_ && value.*Timestamp < buffer_[(end_ - 1) & Mask].*Timestamp) [[unlikely]] {
+            ++rejected_;
+            return false;
+        }
+        buffer_[end_ & Mask] = value;
+        ++end_;
+        if (end_ - begin_ > Capacity) {
+            ++begin_;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Logical position of the first element with timestamp >= ts
+     *
+     * Validation follows the retained window [OldestTimestamp, newest]:
+     * - ts after the newest element: Size(), like std::lower_bound
+     * - ts at or before the oldest element once anything has been
+     *   overwritten: kNotFound, the answer may have been evicted
+     * - otherwise the exact position
+     */
+    [[nodiscard]] auto LowerBound(std::uint64_t ts) const noexcept -> std::size_t
+    {
+        std::size_t low = 0;
+        std::size_t count = Size();
+        while (count > 0) {
+            const std::size_t half = count / 2;
+            if (static_cast<std::uint64_t>(At(low + half).*Timestamp) < ts) {
+                low += half + 1;
+                count -= half + 1;
+            } else {
+                count = half;
+            }
+        }
+        if (low == 0 && begin_ != 0) {
+            return kNotFound;
+        }
+        return low;
+    }
+
+    /**
+     * @brief Logical position of the newest element with timestamp <= ts, the state "as of" ts
+     *
+     * @return kNotFound when ts predates the retained history
+     */
+    [[nodiscard]] auto AsOf(std::uint64_t ts) const noexcept -> std::size_t
+    {
+        if (Empty() || ts < static_cast<std::uint64_t>(At(0).*Timestamp)) {
+            return kNotFound;
+        }
+        // First element strictly newer than ts, minus one
+        std::size_t low = 0;
+        std::size_t count = Size();
+        while (count > 0) {
+            const std::size_t half = count / 2;
+            if (static_cast<std::uint64_t>(At(low + half).*Timestamp) <= ts) {
+                low += half + 1;
+                count -= half + 1;
+            } else {
+                count = half;
+            }
+        }
+        return low - 1;
+    }
+
+    /**
+     * @brief Element at logical position, 0 is the oldest retained
+     *
+     */
+    [[nodiscard]] auto At(std::size_t position) const noexcept -> const T&
+    {
+        return buffer_[(begin_ + position) & Mask];
+    }
+
+    /**
+     * @brief Retained elements, oldest first
+     *
+     */
+    [[nodiscard]] auto Segments() const noexcept -> RingSegments<T>
+    {
+        if (Empty()) {
+            return RingSegments<T> {};
+        }
+        RingSegments<T> segments;
+        const std::size_t head = begin_ & Mask;
+        segments.first = buffer_.data() + head;
+        segments.first_size = Size() < Capacity - head ? Size() : Capacity - head;
+        segments.second = buffer_.data();
+        segments.second_size = Size() - segments.first_size;
+        return segments;
+    }
+
+    [[nodiscard]] auto Size() const noexcept -> std::size_t
+    {
+        return end_ - begin_;
+    }
+
+    [[nodiscard]] auto Empty() const noexcept -> bool
+    {
+        return end_ == begin_;
+    }
+
+    /**
+     * @brief Total elements ever pushed, At(Size() - 1) is number TotalPushed() - 1
+     *
+     */
+    [[nodiscard]] auto TotalPushed() const noexcept -> std::uint64_t
+    {
+        return end_;
+    }
+
+    /**
+     * @brief Pushes refused for going back in time
+     *
+     */
+    [[nodiscard]] auto GetRejectCount() const noexcept -> std::uint64_t
+    {
+        return rejected_;
+    }
+
+private:
+    alignas(64) std::array<T, Capacity> buffer_ {};
+    std::uint64_t begin_ = 0; // first retained element, free running
+    std::uint64_t end_ = 0; // one past the newest, free running
+    std::uint64_t rejected_ = 0;
+};
+
+} // namespace hft::core
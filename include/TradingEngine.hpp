@@ -0,0 +1,203 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "AllocationGuard.hpp"
+#include "KillSwitch.hpp"
+#include "OrderBook.hpp"
+#include "OrderEncoder.hpp"
+#include "OrderEvent.hpp"
+#include "Profile.hpp"
+#include "RiskCheck.hpp"
+#include "Strategy.hpp"
+#include "Tsc.hpp"
+
+namespace hft::core {
+
+/**
+ * @brief Book, strategy, risk and order encoding fused on one thread
+ *
+ * Consumes MarketEvents from the feed handler and produces EncodedOrders
+ * for the gateway.
+ *
+ * @tparam Depth book levels per side
+ */
+template <std::size_t Depth = 8>
+class TradingEngine {
+public:
+    TradingEngine(std::uint32_t instruments, const RiskLimits& limits)
+        : books_(instruments)
+        , strategy_(instruments)
+        , risk_(instruments, limits)
+    {
+    }
+
+    /**
+     * @brief Process one event, pushing at most one order to out
+     *
+     * @tparam OutRing ring of EncodedOrder
+     * @return true when an order was pushed
+     */
+    template <typename OutRing>
+    auto OnEvent(const MarketEvent& event, OutRing& out) noexcept -> bool
+    {
+        HFT_HOT_PATH_SCOPE();
+        last_sequence_ = event.sequence;
+        {
+            HFT_PROFILE_SCOPE("book.apply");
+            if (!books_.Apply(event)) {
+                return false;
+            }
+        }
+
+        // Books stay current after a trip, strategies just stop emitting
+        if (kill_switch_ != nullptr && kill_switch_->IsTripped()) [[unlikely]] {
+            return false;
+        }
+
+        OrderRequest order;
+        {
+            HFT_PROFILE_SCOPE("strategy.on_book");
+            if (!strategy_.OnBook(event, books_.Book(event.instrument), order)) {
+                return false;
+            }
+        }
+
+        EncodedOrder encoded;
+        if (!risk_.Check(order)) [[unlikely]] {
+            if (drop_copy_ != nullptr) {
+                OrderEncoder::Encode(order, encoded);
+                (void)drop_copy_->Push(OrderEvent { ReadTsc(), encoded, OrderEventType::RiskRejected });
+            }
+            return false;
+        }
+
+        OrderEncoder::Encode(order, encoded);
+        if (!out.Push(encoded)) [[unlikely]] {
+            // Never sent, give its position back or full rings would ratchet the limits shut
+            risk_.Release(order);
+            ++dropped_;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Drain up to max_burst events from in
+     *
+     * @return std::size_t processed events
+     */
+    template <typename InRing, typename OutRing>
+    auto Poll(InRing& in, OutRing& out, std::size_t max_burst = 32) noexcept -> std::size_t
+    {
+        std::size_t processed = 0;
+        MarketEvent event;
+        while (processed < max_burst && in.Pop(event)) {
+            (void)OnEvent(event, out);
+            ++processed;
+        }
+        return processed;
+    }
+
+    [[nodiscard]] auto Books() noexcept -> BookBuilder<Depth>&
+    {
+        return books_;
+    }
+
+    [[nodiscard]] auto Strategy() noexcept -> ThresholdTaker&
+    {
+        return strategy_;
+    }
+
+    [[nodiscard]] auto Risk() noexcept -> RiskCheck&
+    {
+        return risk_;
+    }
+
+    [[nodiscard]] auto GetDropCount() const noexcept -> std::uint64_t
+    {
+        return dropped_;
+    }
+
+    /**
+     * @brief Report risk rejects to the drop copy stage, nullptr detaches
+     *
+     */
+    void AttachDropCopy(DropCopyQueue* queue) noexcept
+    {
+        drop_copy_ = queue;
+    }
+
+    /**
+     * @brief Stop emitting orders while kill_switch is tripped, nullptr detaches
+     *
+     */
+    void ArmKillSwitch(const KillSwitch* kill_switch) noexcept
+    {
+        kill_switch_ = kill_switch;
+    }
+
+    /**
+     * @brief Sequence of the last processed event, the engine's input cursor
+     *
+     */
+    [[nodiscard]] auto LastSequence() const noexcept -> std::uint64_t
+    {
+        return last_sequence_;
+    }
+
+    /**
+     * @brief Upper bound of SaveSnapshot output
+     *
+     */
+    [[nodiscard]] auto SnapshotSize() const noexcept -> std::size_t
+    {
+        return kFixedSize + (books_.InstrumentCount() * (sizeof(OrderBook<Depth>) + sizeof(std::int64_t)));
+    }
+
+    /**
+     * @brief Cursor, order id, books and positions, see SnapshotCoordinator
+     *
+     * @return std::size_t bytes written, 0 when capacity is too small
+     */
+    auto SaveSnapshot(std::uint8_t* out, std::size_t capacity) const noexcept -> std::size_t
+    {
+        if (capacity < SnapshotSize()) {
+            return 0;
+        }
+        const std::uint64_t next_order_id = strategy_.NextOrderId();
+        std::memcpy(out, &last_sequence_, sizeof(std::uint64_t));
+        std::memcpy(out + sizeof(std::uint64_t), &next_order_id, sizeof(std::uint64_t));
+        std::size_t written = kFixedSize;
+        written += books_.SaveSnapshot(out + written, capacity - written);
+        written += risk_.SaveSnapshot(out + written, capacity - written);
+        return written;
+    }
+
+    [[nodiscard]] auto LoadSnapshot(const std::uint8_t* data, std::size_t size) noexcept -> bool
+    {
+        const std::size_t books_size = books_.InstrumentCount() * sizeof(OrderBook<Depth>);
+        if (size != SnapshotSize() || !books_.LoadSnapshot(data + kFixedSize, books_size)
+            || !risk_.LoadSnapshot(data + kFixedSize + books_size, size - kFixedSize - books_size)) {
+            return false;
+        }
+        std::uint64_t next_order_id = 0;
+        std::memcpy(&last_sequence_, data, sizeof(std::uint64_t));
+        std::memcpy(&next_order_id, data + sizeof(std::uint64_t), sizeof(std::uint64_t));
+        strategy_.SetNextOrderId(next_order_id);
+        return true;
+    }
+
+private:
+    static constexpr std::size_t kFixedSize = 2 * sizeof(std::uint64_t);
+
+    BookBuilder<Depth> books_;
+    ThresholdTaker strategy_;
+    RiskCheck risk_;
+    DropCopyQueue* drop_copy_ = nullptr;
+    const KillSwitch* kill_switch_ = nullptr;
+    std::uint64_t dropped_ = 0;
+    std::uint64_t last_sequence_ = 0;
+};
+
+} // namespace hft::core
@@ -0,0 +1,57 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace hft::core {
+
+/**
+ * @brief Read the time stamp counter, steady_clock nanoseconds on other targets
+ *
+ * @return std::uint64_t
+ */
+[[nodiscard]] inline auto ReadTsc() noexcept -> std::uint64_t
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+ * @brief Spin loop hint, pause on x86
+ *
+ */
+inline void CpuRelax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+/**
+ * @brief TSC ticks per nanosecond, calibrated once against steady_clock
+ *
+ * First call blocks for ~20ms, call it before the hot path starts.
+ *
+ * @return double
+ */
+[[nodiscard]] inline auto TscPerNanosecond() noexcept -> double
+{
+    static const double ticks_per_ns = [] {
+        const auto wall_start = std::chrono::steady_clock::now();
+        const std::uint64_t tsc_start = ReadTsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const std::uint64_t tsc_end = ReadTsc();
+        const auto wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wall_start).count();
+        return static_cast<double>(tsc_end - tsc_start) / static_cast<double>(wall_ns);
+    }();
+    return ticks_per_ns;
+}
+
+} // namespace hft::core
@@ -0,0 +1,217 @@
+// Allocation hooks of the hot path allocation detector, see AllocationGuard.hpp.
+//
+// Replaces the global operator new family and, on glibc, malloc, calloc,
+// realloc and the aligned allocators. Every hook checks the thread's hot
+// path depth and forwards to the glibc allocator (__libc_*), so the
+// default operator delete and free release the memory as usual. Sanitizer
+// builds bring their own allocator, the hooks are compiled out there.
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "AllocationGuard.hpp"
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+#define HFT_ALLOC_GUARD_SANITIZED
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define HFT_ALLOC_GUARD_SANITIZED
+#endif
+
+#if defined(__GLIBC__) && !defined(HFT_ALLOC_GUARD_SANITIZED)
+
+#include <execinfo.h>
+#include <unistd.h>
+
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pointer, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+}
+
+namespace {
+
+// Allocations made while recording one (backtrace loading libgcc) are not hot path allocations
+thread_local bool in_hook = false;
+
+void Write(const char* text) noexcept
+{
+    (void)!::write(STDERR_FILENO, text, std::strlen(text));
+}
+
+void OnAllocation(std::size_t bytes) noexcept
+{
+    using namespace hft::alloc;
+    if (detail::hot_path_depth == 0 || in_hook) [[likely]] {
+        return;
+    }
+    in_hook = true;
+    ++detail::thread_allocations;
+    detail::allocations.fetch_add(1, std::memory_order_relaxed);
+
+    AllocationRecord record;
+    record.bytes = bytes;
+    record.frame_count = ::backtrace(record.frames.data(), static_cast<int>(record.frames.size()));
+    const std::size_t index = detail::record_count.fetch_add(1, std::memory_order_acq_rel);
+    if (index < detail::kMaxRecords) {
+        detail::records[index] = record;
+    }
+
+    if (detail::policy.load(std::memory_order_relaxed) == Policy::Abort) {
+        Write("hot path allocation\n");
+        ::backtrace_symbols_fd(record.frames.data(), record.frame_count, STDERR_FILENO);
+        std::abort();
+    }
+    in_hook = false;
+}
+
+auto AlignedAllocate(std::size_t alignment, std::size_t size) noexcept -> void*
+{
+    OnAllocation(size);
+    return __libc_memalign(alignment, size == 0 ? 1 : size);
+}
+
+auto NewOrThrow(std::size_t size) -> void*
+{
+    OnAllocation(size);
+    void* pointer = __libc_malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) [[unlikely]] {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+auto AlignedNewOrThrow(std::size_t size, std::align_val_t alignment) -> void*
+{
+    void* pointer = AlignedAllocate(static_cast<std::size_t>(alignment), size);
+    if (pointer == nullptr) [[unlikely]] {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+// Prime backtrace (its first call allocates) and report the hooks as active
+[[maybe_unused]] const bool kInstalled = [] {
+    void* frame = nullptr;
+    (void)::backtrace(&frame, 1);
+    hft::alloc::detail::installed.store(true, std::memory_order_relaxed);
+    return true;
+}();
+
+} // namespace
+
+extern "C" {
+
+void* malloc(std::size_t size) noexcept
+{
+    OnAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept
+{
+    OnAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size) noexcept
+{
+    OnAllocation(size);
+    return __libc_realloc(pointer, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    return AlignedAllocate(alignment, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size) noexcept
+{
+    return AlignedAllocate(alignment, size);
+}
+
+int posix_memalign(void** out, std::size_t alignment, std::size_t size) noexcept
+{
+    void* pointer = AlignedAllocate(alignment, size);
+    if (pointer == nullptr) {
+        return ENOMEM;
+    }
+    *out = pointer;
+    return 0;
+}
+
+} // extern "C"
+
+void* operator new(std::size_t size)
+{
+    return NewOrThrow(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return NewOrThrow(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    OnAllocation(size);
+    return __libc_malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    OnAllocation(size);
+    return __libc_malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return AlignedNewOrThrow(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return AlignedNewOrThrow(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AlignedAllocate(static_cast<std::size_t>(alignment), size);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AlignedAllocate(static_cast<std::size_t>(alignment), size);
+}
+
+namespace hft::alloc {
+
+void PrintRecords(int fd)
+{
+    const std::vector<AllocationRecord> records = Records();
+    for (const AllocationRecord& record : records) {
+        char line[64];
+        const int length = std::snprintf(line, sizeof(line), "allocation of %zu bytes\n", record.bytes);
+        (void)!::write(fd, line, static_cast<std::size_t>(length));
+        ::backtrace_symbols_fd(record.frames.data(), record.frame_count, fd);
+    }
+}
+
+} // namespace hft::alloc
+
+#else
+
+namespace hft::alloc {
+
+void PrintRecords(int /*fd*/)
+{
+}
+
+} // namespace hft::alloc
+
+#endif
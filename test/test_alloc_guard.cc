@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "AllocationGuard.hpp"
+
+using namespace hft::alloc;
+
+namespace {
+
+// Keeps the compiler from eliding allocate / free pairs
+void* volatile sink = nullptr;
+
+class AllocationGuardTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        if (!HooksInstalled()) {
+            GTEST_SKIP() << "allocation hooks compiled out (sanitizer build or not glibc)";
+        }
+        SetPolicy(Policy::Count);
+        Reset();
+    }
+};
+
+} // namespace
+
+TEST_F(AllocationGuardTest, IgnoresAllocationsOutsideHotPath)
+{
+    auto value = std::make_unique<int>(1);
+    sink = value.get();
+    std::vector<int> values(100);
+    sink = values.data();
+    EXPECT_EQ(HotPathAllocations(), 0u);
+    EXPECT_TRUE(Records().empty());
+}
+
+TEST_F(AllocationGuardTest, CountsNewWithCallStack)
+{
+    std::unique_ptr<int> value;
+    std::uint64_t allocations = 0;
+    {
+        HotPathScope scope;
+        value = std::make_unique<int>(7);
+        sink = value.get();
+        allocations = scope.Allocations();
+    }
+    EXPECT_EQ(allocations, 1u);
+    EXPECT_EQ(HotPathAllocations(), 1u);
+
+    const std::vector<AllocationRecord> records = Records();
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].bytes, sizeof(int));
+    EXPECT_GT(records[0].frame_count, 0);
+}
+
+TEST_F(AllocationGuardTest, CountsMalloc)
+{
+    std::uint64_t allocations = 0;
+    {
+        HotPathScope scope;
+        sink = std::malloc(32);
+        std::free(sink);
+        sink = std::calloc(4, 8);
+        std::free(sink);
+        allocations = scope.Allocations();
+    }
+    EXPECT_EQ(allocations, 2u);
+}
+
+TEST_F(AllocationGuardTest, NestedScopesShareCounts)
+{
+    HotPathScope outer;
+    std::uint64_t inner_allocations = 0;
+    {
+        HotPathScope inner;
+        auto value = std::make_unique<long>(1);
+        sink = value.get();
+        inner_allocations = inner.Allocations();
+    }
+    EXPECT_EQ(inner_allocations, 1u);
+    EXPECT_EQ(outer.Allocations(), 1u);
+}
+
+TEST_F(AllocationGuardTest, OnlyMarkedThreadsCount)
+{
+    HotPathScope scope;
+    std::thread other([] {
+        auto values = std::make_unique<std::vector<int>>(64);
+        sink = values->data();
+    });
+    other.join();
+    // Thread creation allocates on this thread, what matters is the other thread's work is not seen
+    const std::uint64_t own = scope.Allocations();
+    EXPECT_EQ(HotPathAllocations(), own);
+}
+
+TEST_F(AllocationGuardTest, AbortPolicyStopsOnFirstAllocation)
+{
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_DEATH(
+        {
+            SetPolicy(Policy::Abort);
+            HotPathScope scope;
+            sink = new int(3);
+        },
+        "hot path allocation");
+}
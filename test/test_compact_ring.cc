@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "CompactRing.hpp"
+
+using namespace hft::core;
+
+TEST(CompactRingTest, RingsAreIndependent)
+{
+    CompactRingPool<int, 4> pool(3);
+
+    EXPECT_TRUE(pool.Push(0, 10));
+    EXPECT_TRUE(pool.Push(2, 30));
+    EXPECT_TRUE(pool.Empty(1));
+
+    int val;
+    EXPECT_FALSE(pool.Pop(1, val));
+    EXPECT_TRUE(pool.Pop(2, val));
+    EXPECT_EQ(val, 30);
+    EXPECT_TRUE(pool.Pop(0, val));
+    EXPECT_EQ(val, 10);
+}
+
+TEST(CompactRingTest, FullCapacityUsable)
+{
+    CompactRingPool<int, 4, ThreadModel::SingleThread> pool(1);
+    auto ring = pool.Get(0);
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(ring.Push(i));
+    EXPECT_FALSE(ring.Push(4));
+    EXPECT_EQ(ring.Size(), 4U);
+    EXPECT_EQ(ring.Front(), 0);
+
+    // Wrap the free running indices a few times
+    int val;
+    for (int i = 4; i < 100; ++i) {
+        EXPECT_TRUE(ring.Pop(val));
+        EXPECT_EQ(val, i - 4);
+        EXPECT_TRUE(ring.Push(i));
+    }
+}
+
+TEST(CompactRingTest, SmallPerRingOverhead)
+{
+    using Pool = CompactRingPool<int, 16>;
+    // Two packed 32 bit indices instead of three padded cache lines
+    EXPECT_EQ(Pool::BytesPerRing(), 8 + (16 * sizeof(int)));
+}
+
+TEST(CompactRingTest, SPSCStress)
+{
+    const int kCount = 200000;
+    CompactRingPool<int, 64> pool(8);
+
+    std::thread producer([&]() {
+        for (int i = 0; i < kCount; ++i) {
+            while (!pool.Push(static_cast<std::uint32_t>(i) % 8, i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    int received = 0;
+    int val;
+    while (received < kCount) {
+        for (std::uint32_t id = 0; id < 8; ++id) {
+            if (pool.Pop(id, val)) {
+                ASSERT_EQ(val, expected[id]);
+                expected[id] += 8;
+                ++received;
+            }
+        }
+    }
+    producer.join();
+}
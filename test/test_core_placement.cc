@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+#include <set>
+#include <vector>
+#include "CorePlacement.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+// Two sockets of two CCX of two cores: 40 ns within a CCX, 100 within a socket, 300 across
+auto TwoSocketMatrix() -> CoreLatencyMatrix
+{
+    CoreLatencyMatrix matrix;
+    matrix.cpus = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    matrix.round_trip_ns.assign(64, 0.0);
+    for (std::size_t a = 0; a < 8; ++a) {
+        for (std::size_t b = 0; b < 8; ++b) {
+            if (a == b) {
+                continue;
+            }
+            const double noise = static_cast<double>((a * 7 + b * 3) % 5);
+            const double base = a / 2 == b / 2 ? 40.0 : a / 4 == b / 4 ? 100.0 : 300.0;
+            matrix.round_trip_ns[a * 8 + b] = base + noise;
+        }
+    }
+    return matrix;
+}
+
+} // namespace
+
+TEST(CorePlacementTest, DetectsCcxAndSocketTiers)
+{
+    const CoreClusters clusters = DetectClusters(TwoSocketMatrix());
+    ASSERT_EQ(clusters.levels.size(), 2u);
+
+    const auto& ccx = clusters.levels[0];
+    ASSERT_EQ(ccx.clusters.size(), 4u);
+    EXPECT_GT(ccx.threshold_ns, 45.0);
+    EXPECT_LT(ccx.threshold_ns, 100.0);
+    EXPECT_EQ(ccx.clusters[0], (std::vector<std::size_t> { 0, 1 }));
+    EXPECT_EQ(ccx.clusters[3], (std::vector<std::size_t> { 6, 7 }));
+
+    const auto& socket = clusters.levels[1];
+    ASSERT_EQ(socket.clusters.size(), 2u);
+    EXPECT_EQ(socket.clusters[0], (std::vector<std::size_t> { 0, 1, 2, 3 }));
+    EXPECT_EQ(socket.clusters[1], (std::vector<std::size_t> { 4, 5, 6, 7 }));
+}
+
+TEST(CorePlacementTest, UniformMatrixHasNoTiers)
+{
+    CoreLatencyMatrix matrix;
+    matrix.cpus = { 0, 1, 2 };
+    matrix.round_trip_ns = { 0, 50, 52, 51, 0, 49, 50, 53, 0 };
+    EXPECT_TRUE(DetectClusters(matrix).levels.empty());
+}
+
+TEST(CorePlacementTest, ParsesTopologyConfig)
+{
+    StageGraph graph;
+    ASSERT_TRUE(graph.Parse("# pipeline\n"
+                            "stage feed\n"
+                            "stage engine   # strategy\n"
+                            "\n"
+                            "link feed engine 2.5\n"
+                            "link engine feed\n"));
+    ASSERT_EQ(graph.stages.size(), 2u);
+    ASSERT_EQ(graph.links.size(), 2u);
+    EXPECT_EQ(graph.links[0].from, 0u);
+    EXPECT_EQ(graph.links[0].to, 1u);
+    EXPECT_DOUBLE_EQ(graph.links[0].weight, 2.5);
+    EXPECT_DOUBLE_EQ(graph.links[1].weight, 1.0);
+
+    StageGraph unknown;
+    EXPECT_FALSE(unknown.Parse("stage feed\nlink feed engine\n"));
+    StageGraph duplicate;
+    EXPECT_FALSE(duplicate.Parse("stage feed\nstage feed\n"));
+    StageGraph keyword;
+    EXPECT_FALSE(keyword.Parse("thread feed\n"));
+}
+
+TEST(CorePlacementTest, PlacesPipelineOnOneSocket)
+{
+    const CoreLatencyMatrix matrix = TwoSocketMatrix();
+    const StageGraph graph = StageGraph::Default();
+    const std::vector<std::size_t> placement = SuggestPlacement(graph, matrix);
+    ASSERT_EQ(placement.size(), 4u);
+
+    std::set<std::size_t> distinct(placement.begin(), placement.end());
+    EXPECT_EQ(distinct.size(), 4u);
+    for (const std::size_t cpu : placement) {
+        EXPECT_EQ(cpu / 4, placement[0] / 4);
+    }
+    // Best possible: one heavy hand-off inside a CCX, the other across CCX, drop copy next to the gateway
+    const std::size_t feed = graph.Find("feed");
+    const std::size_t engine = graph.Find("engine");
+    const std::size_t gateway = graph.Find("gateway");
+    EXPECT_LE(PlacementCost(graph, matrix, placement), 40.0 + 100.0 + 0.2 * 40.0 + 4.0 * 2.2);
+    EXPECT_TRUE(placement[feed] / 2 == placement[engine] / 2 || placement[engine] / 2 == placement[gateway] / 2);
+}
+
+TEST(CorePlacementTest, MoreStagesThanCpusHasNoPlacement)
+{
+    CoreLatencyMatrix matrix;
+    matrix.cpus = { 0, 1 };
+    matrix.round_trip_ns = { 0, 50, 50, 0 };
+    EXPECT_TRUE(SuggestPlacement(StageGraph::Default(), matrix).empty());
+}
+
+TEST(CorePlacementTest, MeasuresRoundTrip)
+{
+    // Floating threads, works on any machine including a single cpu
+    const double round_trip = MeasureRoundTrip(-1, -1, 50);
+    EXPECT_FALSE(std::isnan(round_trip));
+    EXPECT_GT(round_trip, 0.0);
+
+    EXPECT_TRUE(std::isnan(MeasureRoundTrip(-1, 1 << 20, 50)));
+}
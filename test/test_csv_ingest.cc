@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "CsvIngest.hpp"
+#include "SPSC.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+auto TempPath(const char* name) -> std::string
+{
+    return "/tmp/hft_" + std::string(name) + "_" + std::to_string(::getpid()) + ".csv";
+}
+
+void WriteFile(const std::string& path, const std::string& content)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fwrite(content.data(), 1, content.size(), file);
+    std::fclose(file);
+}
+
+struct CollectingSink {
+    std::vector<MarketEvent>* records;
+    void operator()(const MarketEvent* batch, std::size_t count) { records->insert(records->end(), batch, batch + count); }
+};
+
+} // namespace
+
+TEST(CsvIngestTest, ParsesFixedPoint)
+{
+    std::int64_t value = 0;
+    ASSERT_TRUE(detail::ParseFixedPoint("101.25", 6, 4, value));
+    EXPECT_EQ(value, 1012500);
+    ASSERT_TRUE(detail::ParseFixedPoint("-0.123456", 9, 4, value));
+    EXPECT_EQ(value, -1234);
+    ASSERT_TRUE(detail::ParseFixedPoint("42", 2, 2, value));
+    EXPECT_EQ(value, 4200);
+    EXPECT_FALSE(detail::ParseFixedPoint("4x.1", 4, 2, value));
+    EXPECT_FALSE(detail::ParseFixedPoint("", 0, 2, value));
+
+    std::uint64_t number = 0;
+    ASSERT_TRUE(detail::ParseUnsigned("1700000000123456789", 19, number));
+    EXPECT_EQ(number, 1700000000123456789ULL);
+    EXPECT_FALSE(detail::ParseUnsigned("17000000a0123456789", 19, number));
+}
+
+TEST(CsvIngestTest, PaddedParsersMatchCheckedOnes)
+{
+    // Trailing bytes stand in for the rest of the line the padded parsers may read
+    const std::string digits = "1234567890123456789,,,,,,,,";
+    for (std::size_t length = 1; length <= 19; ++length) {
+        std::uint64_t checked = 0;
+        std::uint64_t padded = 0;
+        ASSERT_TRUE(detail::ParseUnsigned(digits.data(), length, checked));
+        ASSERT_TRUE(detail::ParseUnsigned<true>(digits.data(), length, padded));
+        EXPECT_EQ(padded, checked) << length;
+    }
+    std::uint64_t number = 0;
+    EXPECT_FALSE(detail::ParseUnsigned<true>("12,4,,,,,", 4, number));
+
+    const std::string prices[] = { "101.25,,,,,,,", "-7.1234567,,,", "99,,,,,,,,", "0.5,,,,,,,,,", "12345678901.1,,,,,,,," };
+    for (const std::string& price : prices) {
+        const std::size_t length = price.find(',');
+        std::int64_t checked = 0;
+        std::int64_t padded = 0;
+        ASSERT_TRUE(detail::ParseFixedPoint(price.data(), length, 4, checked));
+        ASSERT_TRUE(detail::ParseFixedPoint<true>(price.data(), length, 4, padded));
+        EXPECT_EQ(padded, checked) << price;
+    }
+}
+
+TEST(CsvIngestTest, ParsesRecordsAndCountsMalformed)
+{
+    const std::string path = TempPath("csv_small");
+    WriteFile(path,
+        "timestamp,instrument,side,price,quantity\n"
+        "1000,7,B,101.25,300\n"
+        "1001,8,S,99.5,10\r\n"
+        "\n"
+        "1002,8,X,99.5,10\n"
+        "1003,9,S,99.5\n"
+        "1004,9,S,100,1");
+
+    CsvTickFile file;
+    ASSERT_TRUE(file.Open(path.c_str()));
+    std::vector<MarketEvent> records;
+    const CsvIngestStats stats = IngestCsv(file, CsvConfig {}, [&](std::size_t) { return CollectingSink { &records }; });
+    ::unlink(path.c_str());
+
+    EXPECT_EQ(stats.records, 3U);
+    EXPECT_EQ(stats.malformed, 2U);
+    ASSERT_EQ(records.size(), 3U);
+    EXPECT_EQ(records[0].timestamp, 1000U);
+    EXPECT_EQ(records[0].instrument, 7U);
+    EXPECT_EQ(records[0].side, Side::Buy);
+    EXPECT_EQ(records[0].price, 1012500);
+    EXPECT_EQ(records[0].quantity, 300U);
+    EXPECT_EQ(records[0].action, BookAction::Trade);
+    EXPECT_EQ(records[1].quantity, 10U);
+    EXPECT_EQ(records[2].price, 1000000);
+    EXPECT_EQ(records[2].quantity, 1U);
+}
+
+TEST(CsvIngestTest, ParallelChunksMatchSingleThread)
+{
+    const std::string path = TempPath("csv_parallel");
+    std::string content = "ts,id,side,px,qty\n";
+    for (int i = 0; i < 20000; ++i) {
+        content += std::to_string(1700000000000000000LL + i) + "," + std::to_string(i % 97) + "," + (i % 2 ? "B" : "S") + ","
+            + std::to_string(100 + i % 13) + "." + std::to_string(i % 10000) + "," + std::to_string(1 + i % 500) + "\n";
+    }
+    WriteFile(path, content);
+    CsvTickFile file;
+    ASSERT_TRUE(file.Open(path.c_str()));
+    ::unlink(path.c_str());
+
+    std::vector<MarketEvent> single;
+    EXPECT_EQ(IngestCsv(file, CsvConfig {}, [&](std::size_t) { return CollectingSink { &single }; }).records, 20000U);
+
+    CsvConfig config;
+    config.threads = 3;
+    std::vector<std::vector<MarketEvent>> parts(3);
+    const CsvIngestStats stats = IngestCsv(file, config, [&](std::size_t chunk) { return CollectingSink { &parts[chunk] }; });
+    EXPECT_EQ(stats.records, 20000U);
+    EXPECT_EQ(stats.malformed, 0U);
+    EXPECT_EQ(stats.bytes + 18, file.Size());
+
+    std::vector<MarketEvent> merged;
+    for (const auto& part : parts) {
+        EXPECT_FALSE(part.empty());
+        merged.insert(merged.end(), part.begin(), part.end());
+    }
+    ASSERT_EQ(merged.size(), single.size());
+    for (std::size_t i = 0; i < single.size(); ++i) {
+        ASSERT_EQ(merged[i].sequence, single[i].sequence);
+        ASSERT_EQ(merged[i].timestamp, single[i].timestamp);
+        ASSERT_EQ(merged[i].price, single[i].price);
+    }
+}
+
+TEST(CsvIngestTest, RingSinkFeedsSpscRing)
+{
+    const std::string path = TempPath("csv_ring");
+    WriteFile(path, "1,1,B,1.0,1\n2,2,S,2.0,2\n");
+    CsvTickFile file;
+    ASSERT_TRUE(file.Open(path.c_str()));
+    ::unlink(path.c_str());
+
+    SPSCRingBuffer<MarketEvent, 16> ring;
+    CsvConfig config;
+    config.has_header = false;
+    EXPECT_EQ(IngestCsv(file, config, [&](std::size_t) { return RingSink<SPSCRingBuffer<MarketEvent, 16>> { &ring }; }).records, 2U);
+    MarketEvent event;
+    ASSERT_TRUE(ring.Pop(event));
+    EXPECT_EQ(event.instrument, 1U);
+    ASSERT_TRUE(ring.Pop(event));
+    EXPECT_EQ(event.price, 20000);
+}
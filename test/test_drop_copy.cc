@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "DropCopy.hpp"
+#include "Gateway.hpp"
+#include "MPSC.hpp"
+#include "RingBuffer.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+auto TempPath(const char* name) -> std::string
+{
+    return std::string(::testing::TempDir()) + name + std::to_string(::getpid());
+}
+
+auto ReadFile(const std::string& path) -> std::string
+{
+    std::string contents;
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return contents;
+    }
+    char chunk[4096];
+    std::size_t read = 0;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        contents.append(chunk, read);
+    }
+    std::fclose(file);
+    return contents;
+}
+
+auto MakeEvent(std::uint64_t order_id, OrderEventType type) -> OrderEvent
+{
+    OrderRequest order;
+    order.order_id = order_id;
+    order.instrument = 7;
+    order.price = 10050;
+    order.quantity = 3;
+    order.side = Side::Sell;
+    OrderEvent event;
+    event.timestamp = 99;
+    event.type = type;
+    OrderEncoder::Encode(order, event.order);
+    return event;
+}
+
+struct NullTransport {
+    void Send(const EncodedOrder& /*order*/) { }
+};
+
+} // namespace
+
+TEST(MPSCTest, ManyProducersNoLoss)
+{
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 100000;
+    auto queue = std::make_unique<MPSCRingBuffer<std::uint64_t, 1024>>();
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                const std::uint64_t value = (static_cast<std::uint64_t>(p) << 32U) | static_cast<std::uint64_t>(i);
+                while (!queue->Push(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<std::uint64_t> next(kProducers, 0);
+    std::uint64_t value = 0;
+    for (int received = 0; received < kProducers * kPerProducer;) {
+        if (queue->Pop(value)) {
+            const auto producer = static_cast<std::size_t>(value >> 32U);
+            // Per producer FIFO order
+            ASSERT_EQ(value & 0xFFFFFFFFULL, next[producer]);
+            ++next[producer];
+            ++received;
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(queue->Empty());
+}
+
+TEST(MPSCTest, RejectsWhenFull)
+{
+    MPSCRingBuffer<int, 4> queue;
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(queue.Push(i));
+    EXPECT_FALSE(queue.Push(4));
+    EXPECT_EQ(queue.GetDropCount(), 1U);
+    int value;
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(queue.Push(4));
+}
+
+TEST(DropCopyTest, GatewayEventsToBinaryFile)
+{
+    const std::string path = TempPath("dropcopy.bin");
+    std::remove(path.c_str());
+    auto queue = std::make_unique<DropCopyQueue>();
+
+    NullTransport transport;
+    Gateway<NullTransport> gateway(transport);
+    gateway.AttachDropCopy(queue.get());
+    RingBuffer<EncodedOrder, 8, OverflowPolicy::Reject, ThreadModel::SingleThread> orders;
+    EXPECT_TRUE(orders.Push(MakeEvent(1, OrderEventType::Sent).order));
+    EXPECT_TRUE(orders.Push(MakeEvent(2, OrderEventType::Sent).order));
+    EXPECT_EQ(gateway.Poll(orders), 2U);
+
+    DropCopyWriter writer(*queue, DropCopyFormat::Binary);
+    ASSERT_TRUE(writer.OpenFile(path.c_str()));
+    writer.Flush();
+    EXPECT_EQ(writer.GetWrittenCount(), 2U);
+
+    const std::string contents = ReadFile(path);
+    ASSERT_EQ(contents.size(), 2 * sizeof(DropCopyRecord));
+    DropCopyRecord record;
+    std::memcpy(&record, contents.data() + sizeof(DropCopyRecord), sizeof(record));
+    EXPECT_EQ(record.sequence, 2U);
+    EXPECT_EQ(record.order_id, 2U);
+    EXPECT_EQ(record.instrument, 7U);
+    EXPECT_EQ(record.price, 10050);
+    EXPECT_EQ(record.event_type, static_cast<std::uint8_t>(OrderEventType::Sent));
+    std::remove(path.c_str());
+}
+
+TEST(DropCopyTest, FixUtcTimestamp)
+{
+    char text[32];
+    // 2024-03-01 13:45:07.123456789 UTC
+    EXPECT_EQ(DropCopyWriter::FormatUtcTimestamp(1709300707123456789LL, text, sizeof(text)), 21);
+    EXPECT_STREQ(text, "20240301-13:45:07.123");
+}
+
+TEST(DropCopyTest, FixOverTcp)
+{
+    const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(::listen(listener, 1), 0);
+    socklen_t length = sizeof(address);
+    ASSERT_EQ(::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length), 0);
+
+    auto queue = std::make_unique<DropCopyQueue>();
+    EXPECT_TRUE(queue->Push(MakeEvent(42, OrderEventType::RiskRejected)));
+
+    DropCopyWriter writer(*queue, DropCopyFormat::Fix);
+    ASSERT_TRUE(writer.ConnectTcp(ntohs(address.sin_port)));
+    const int consumer = ::accept(listener, nullptr, nullptr);
+    ASSERT_GE(consumer, 0);
+    EXPECT_EQ(writer.Poll(), 1U);
+
+    std::string message;
+    char chunk[512];
+    while (message.find("\x01" "10=") == std::string::npos || message.back() != '\x01') {
+        const ssize_t received = ::recv(consumer, chunk, sizeof(chunk), 0);
+        ASSERT_GT(received, 0);
+        message.append(chunk, static_cast<std::size_t>(received));
+    }
+    ::close(consumer);
+    ::close(listener);
+
+    EXPECT_EQ(message.rfind("8=FIX.4.4\x01", 0), 0U);
+    EXPECT_NE(message.find("\x01" "11=42\x01"), std::string::npos);
+    EXPECT_NE(message.find("\x01" "150=8\x01"), std::string::npos);
+    EXPECT_NE(message.find("\x01" "54=2\x01"), std::string::npos);
+    // Required ExecutionReport fields, nothing filled on a reject
+    EXPECT_NE(message.find("\x01" "49=HFTCORE\x01" "56=DROPCOPY\x01"), std::string::npos);
+    EXPECT_NE(message.find("\x01" "37=42\x01"), std::string::npos);
+    EXPECT_NE(message.find("\x01" "17=1\x01"), std::string::npos);
+    EXPECT_NE(message.find("\x01" "39=8\x01"), std::string::npos);
+    EXPECT_NE(message.find("\x01" "151=0\x01" "14=0\x01" "6=0\x01"), std::string::npos);
+    for (const char* tag : { "\x01" "52=", "\x01" "60=" }) {
+        const std::size_t at = message.find(tag);
+        ASSERT_NE(at, std::string::npos);
+        EXPECT_TRUE(std::regex_match(message.substr(at + 4, 21), std::regex(R"(20\d{6}-\d{2}:\d{2}:\d{2}\.\d{3})"))) << message.substr(at + 4, 21);
+    }
+
+    const std::size_t trailer = message.rfind("10=");
+    const unsigned checksum = DropCopyWriter::FixChecksum(message.data(), trailer);
+    EXPECT_EQ(std::stoul(message.substr(trailer + 3, 3)), checksum);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "EventFdRing.hpp"
+
+using namespace hft::core;
+
+TEST(EventFdRingTest, SignalsOnlyWhenSleeping)
+{
+    EventFdRingBuffer<int, 16> ring;
+    ASSERT_GE(ring.EventFd(), 0);
+
+    // Spinning consumer: pushes never reach the kernel
+    EXPECT_TRUE(ring.Push(1));
+    EXPECT_TRUE(ring.Push(2));
+    EXPECT_EQ(ring.GetSignalCount(), 0U);
+
+    // Data pending, the consumer must not sleep
+    EXPECT_FALSE(ring.PrepareToSleep());
+    int value;
+    EXPECT_TRUE(ring.Pop(value));
+    EXPECT_TRUE(ring.Pop(value));
+
+    EXPECT_TRUE(ring.PrepareToSleep());
+    EXPECT_TRUE(ring.Push(3));
+    EXPECT_TRUE(ring.Push(4));
+    EXPECT_EQ(ring.GetSignalCount(), 1U);
+    ring.OnWake();
+}
+
+TEST(EventFdRingTest, EpollConsumerWithSocketAndRing)
+{
+    constexpr int kCount = 20000;
+    EventFdRingBuffer<int, 64> ring;
+    int pipe_fds[2];
+    ASSERT_EQ(::pipe(pipe_fds), 0);
+
+    const int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    ASSERT_GE(epoll_fd, 0);
+    epoll_event registration {};
+    registration.events = EPOLLIN;
+    registration.data.fd = ring.EventFd();
+    ASSERT_EQ(::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ring.EventFd(), &registration), 0);
+    registration.data.fd = pipe_fds[0];
+    ASSERT_EQ(::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &registration), 0);
+
+    std::thread producer([&] {
+        for (int i = 0; i < kCount; ++i) {
+            while (!ring.Push(i)) {
+                std::this_thread::yield();
+            }
+            if (i % 1000 == 0) {
+                // Let the consumer go to sleep now and then
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+        const char byte = 'x';
+        EXPECT_EQ(::write(pipe_fds[1], &byte, 1), 1);
+    });
+
+    int expected = 0;
+    bool socket_seen = false;
+    int value;
+    while (expected < kCount || !socket_seen) {
+        while (ring.Pop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        }
+        if (expected == kCount && socket_seen) {
+            break;
+        }
+        if (ring.PrepareToSleep()) {
+            epoll_event ready[2];
+            const int count = ::epoll_wait(epoll_fd, ready, 2, 5000);
+            ASSERT_GT(count, 0) << "lost wake up";
+            for (int i = 0; i < count; ++i) {
+                if (ready[i].data.fd == pipe_fds[0]) {
+                    char byte;
+                    EXPECT_EQ(::read(pipe_fds[0], &byte, 1), 1);
+                    socket_seen = true;
+                }
+            }
+            ring.OnWake();
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(expected, kCount);
+    EXPECT_LT(ring.GetSignalCount(), static_cast<std::size_t>(kCount));
+    ::close(epoll_fd);
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+}
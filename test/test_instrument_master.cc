@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "InstrumentMaster.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+auto TempPath(const char* name) -> std::string
+{
+    return std::string(::testing::TempDir()) + name + std::to_string(::getpid());
+}
+
+} // namespace
+
+TEST(InstrumentMasterTest, RoundTripLookups)
+{
+    const std::string path = TempPath("instruments.bin");
+    InstrumentMasterWriter writer;
+    for (std::uint32_t i = 0; i < 5000; ++i) {
+        InstrumentDefinition definition;
+        definition.instrument_id = 100000 + (i * 7);
+        definition.symbol = "SYM" + std::to_string(i);
+        definition.venue = static_cast<std::uint16_t>(i % 4);
+        definition.lot_size = 100;
+        definition.tick_size = 5;
+        writer.Add(definition);
+    }
+    ASSERT_TRUE(writer.Write(path));
+    // Rewriting over the live file works, other users may read it
+    ASSERT_TRUE(writer.Write(path));
+    struct stat status {};
+    ASSERT_EQ(::stat(path.c_str(), &status), 0);
+    EXPECT_EQ(status.st_mode & 0777, 0644U);
+
+    InstrumentMaster master;
+    ASSERT_TRUE(master.Open(path.c_str()));
+    EXPECT_EQ(master.Size(), 5000U);
+
+    const InstrumentRecord* record = master.FindById(100000 + (1234 * 7));
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(master.Symbol(*record), "SYM1234");
+    EXPECT_EQ(record->venue, 1234 % 4);
+    EXPECT_EQ(record->tick_size, 5);
+
+    EXPECT_EQ(master.FindBySymbol("SYM4999"), &master.Records()[4999]);
+    EXPECT_EQ(master.FindBySymbol("SYM5000"), nullptr);
+    EXPECT_EQ(master.FindById(1), nullptr);
+
+    InstrumentMaster moved = std::move(master);
+    EXPECT_FALSE(master.IsOpen());
+    EXPECT_NE(moved.FindById(100000), nullptr);
+    std::remove(path.c_str());
+}
+
+TEST(InstrumentMasterTest, RejectsDuplicatesAndBadFiles)
+{
+    const std::string path = TempPath("bad_instruments.bin");
+    InstrumentMasterWriter writer;
+    writer.Add({ 1, "A" });
+    writer.Add({ 1, "B" });
+    EXPECT_FALSE(writer.Write(path));
+
+    InstrumentMasterWriter same_symbol;
+    same_symbol.Add({ 1, "A" });
+    same_symbol.Add({ 2, "B" });
+    same_symbol.Add({ 3, "A" });
+    EXPECT_FALSE(same_symbol.Write(path));
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    const char garbage[128] = "not an instrument master";
+    std::fwrite(garbage, sizeof(garbage), 1, file);
+    std::fclose(file);
+
+    InstrumentMaster master;
+    EXPECT_FALSE(master.Open(path.c_str()));
+    EXPECT_FALSE(master.Open("/nonexistent/instruments.bin"));
+    std::remove(path.c_str());
+}
+
+TEST(InstrumentMasterTest, StridedIdsSpreadOverBuckets)
+{
+    // Exchange ids often come in power of two strides
+    constexpr std::uint32_t kCount = 512;
+    constexpr std::uint64_t kMask = 1023;
+    std::set<std::uint64_t> buckets;
+    for (std::uint32_t i = 0; i < kCount; ++i) {
+        buckets.insert(detail::HashId(i << 12U) & kMask);
+    }
+    EXPECT_GT(buckets.size(), kCount / 2);
+
+    const std::string path = TempPath("strided_instruments.bin");
+    InstrumentMasterWriter writer;
+    for (std::uint32_t i = 0; i < kCount; ++i) {
+        writer.Add({ i << 12U, "S" + std::to_string(i) });
+    }
+    ASSERT_TRUE(writer.Write(path));
+    InstrumentMaster master;
+    ASSERT_TRUE(master.Open(path.c_str()));
+    for (std::uint32_t i = 0; i < kCount; ++i) {
+        const InstrumentRecord* record = master.FindById(i << 12U);
+        ASSERT_NE(record, nullptr);
+        EXPECT_EQ(master.Symbol(*record), "S" + std::to_string(i));
+    }
+    std::remove(path.c_str());
+}
@@ -0,0 +1,267 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <unistd.h>
+#include "ItchReplay.hpp"
+#include "LoadGenerator.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+/**
+ * @brief Random day of several symbols, with the books it must produce
+ *
+ */
+struct Day {
+    ItchWriter writer;
+    std::map<std::uint16_t, L3Book> expected;
+};
+
+auto MakeDay(std::uint16_t symbols, int messages, std::uint64_t seed) -> Day
+{
+    Day day;
+    FastRng rng(seed);
+    std::map<std::uint16_t, std::vector<std::uint64_t>> live;
+    std::uint64_t next_ref = 1;
+    day.writer.SystemEvent(0, 'O');
+    for (std::uint16_t locate = 1; locate <= symbols; ++locate) {
+        day.writer.StockDirectory(locate, "SYM" + std::to_string(locate));
+    }
+    for (int i = 0; i < messages; ++i) {
+        const auto locate = static_cast<std::uint16_t>(1 + rng.NextBelow(symbols));
+        const std::uint64_t timestamp = 1000 + static_cast<std::uint64_t>(i) * 10;
+        auto& refs = live[locate];
+        L3Book& book = day.expected[locate];
+        const std::uint32_t choice = refs.empty() ? 0 : rng.NextBelow(5);
+        if (choice <= 1) {
+            const Side side = rng.NextBelow(2) == 0 ? Side::Buy : Side::Sell;
+            const std::uint32_t price = side == Side::Buy ? 100000 - rng.NextBelow(5) * 100 : 100100 + rng.NextBelow(5) * 100;
+            const std::uint32_t shares = 1 + rng.NextBelow(500);
+            day.writer.AddOrder(locate, timestamp, next_ref, side, shares, price);
+            book.Add(next_ref, side, price, shares);
+            refs.push_back(next_ref++);
+            continue;
+        }
+        const std::size_t slot = rng.NextBelow(static_cast<std::uint32_t>(refs.size()));
+        const std::uint64_t ref = refs[slot];
+        if (choice == 2) {
+            const std::uint32_t shares = 1 + rng.NextBelow(200);
+            day.writer.Execute(locate, timestamp, ref, shares);
+            book.Reduce(ref, shares);
+        } else if (choice == 3) {
+            const std::uint32_t shares = 1 + rng.NextBelow(300);
+            day.writer.Replace(locate, timestamp, ref, next_ref, shares, 100000);
+            book.Replace(ref, next_ref, 100000, shares);
+            refs[slot] = next_ref++;
+            continue;
+        } else {
+            day.writer.Delete(locate, timestamp, ref);
+            book.Delete(ref);
+        }
+        if (book.FindOrder(ref) == nullptr) {
+            refs[slot] = refs.back();
+            refs.pop_back();
+        }
+    }
+    return day;
+}
+
+void ExpectSameLevels(const L3Book& actual, const L3Book& expected)
+{
+    for (const Side side : { Side::Buy, Side::Sell }) {
+        ASSERT_EQ(actual.LevelCount(side), expected.LevelCount(side));
+        for (std::size_t level = 0; level < expected.LevelCount(side); ++level) {
+            EXPECT_EQ(actual.Level(side, level).price, expected.Level(side, level).price);
+            EXPECT_EQ(actual.Level(side, level).shares, expected.Level(side, level).shares);
+            EXPECT_EQ(actual.Level(side, level).orders, expected.Level(side, level).orders);
+        }
+    }
+}
+
+} // namespace
+
+TEST(L3BookTest, TracksOrdersAndLevels)
+{
+    L3Book book;
+    EXPECT_TRUE(book.Add(1, Side::Buy, 100, 10));
+    EXPECT_TRUE(book.Add(2, Side::Buy, 100, 5));
+    EXPECT_TRUE(book.Add(3, Side::Buy, 99, 7));
+    EXPECT_TRUE(book.Add(4, Side::Sell, 101, 3));
+    EXPECT_FALSE(book.Add(4, Side::Sell, 102, 3));
+
+    EXPECT_EQ(book.BestBid().price, 100);
+    EXPECT_EQ(book.BestBid().shares, 15U);
+    EXPECT_EQ(book.BestBid().orders, 2U);
+    EXPECT_EQ(book.Level(Side::Buy, 1).price, 99);
+    EXPECT_EQ(book.BestAsk().price, 101);
+
+    EXPECT_TRUE(book.Reduce(1, 4));
+    EXPECT_EQ(book.BestBid().shares, 11U);
+    EXPECT_TRUE(book.Reduce(2, 5));
+    EXPECT_EQ(book.BestBid().orders, 1U);
+    EXPECT_TRUE(book.Replace(1, 9, 98, 20));
+    EXPECT_EQ(book.BestBid().price, 99);
+    EXPECT_EQ(book.Level(Side::Buy, 1).shares, 20U);
+    EXPECT_TRUE(book.Delete(4));
+    EXPECT_EQ(book.LevelCount(Side::Sell), 0U);
+    EXPECT_FALSE(book.Delete(4));
+    EXPECT_EQ(book.OrderCount(), 2U);
+}
+
+TEST(L3BookTest, TableGrowsAndErasesCleanly)
+{
+    L3Book book;
+    for (std::uint64_t ref = 1; ref <= 5000; ++ref) {
+        ASSERT_TRUE(book.Add(ref * 7919, Side::Sell, 100 + static_cast<std::int64_t>(ref % 50), 1));
+    }
+    for (std::uint64_t ref = 1; ref <= 5000; ref += 2) {
+        ASSERT_TRUE(book.Delete(ref * 7919));
+    }
+    for (std::uint64_t ref = 2; ref <= 5000; ref += 2) {
+        ASSERT_NE(book.FindOrder(ref * 7919), nullptr);
+    }
+    EXPECT_EQ(book.OrderCount(), 2500U);
+    EXPECT_EQ(book.BestAsk().shares, 100U); // refs that are multiples of 50, all even
+}
+
+TEST(ItchIndexTest, ParallelScanMatchesSequential)
+{
+    const Day day = MakeDay(20, 20000, 5);
+    const auto& bytes = day.writer.Bytes();
+
+    ItchIndex sequential;
+    ItchConfig config;
+    const ItchStats single = sequential.Build(bytes.data(), bytes.size(), config);
+    EXPECT_EQ(single.book_messages, 20000U);
+    EXPECT_EQ(single.messages, 20000U + 21U);
+    EXPECT_EQ(single.malformed, 0U);
+    EXPECT_EQ(sequential.Symbol(7), "SYM7");
+    EXPECT_EQ(sequential.ActiveLocates().size(), 20U);
+
+    for (const unsigned threads : { 2U, 3U, 7U, 64U }) {
+        ItchIndex parallel;
+        config.threads = threads;
+        const ItchStats stats = parallel.Build(bytes.data(), bytes.size(), config);
+        EXPECT_EQ(stats.book_messages, single.book_messages);
+        EXPECT_EQ(stats.messages, single.messages);
+        for (std::uint16_t locate = 0; locate <= 21; ++locate) {
+            const auto lhs = sequential.Messages(locate);
+            const auto rhs = parallel.Messages(locate);
+            ASSERT_EQ(lhs.size, rhs.size);
+            for (std::size_t i = 0; i < lhs.size; ++i) {
+                ASSERT_EQ(lhs.offsets[i], rhs.offsets[i]);
+            }
+        }
+        EXPECT_EQ(parallel.Symbol(20), "SYM20");
+    }
+}
+
+TEST(ItchIndexTest, TruncatedTailIsReported)
+{
+    const Day day = MakeDay(3, 100, 9);
+    std::vector<std::uint8_t> bytes = day.writer.Bytes();
+    bytes.resize(bytes.size() - 5);
+    ItchIndex index;
+    ItchConfig config;
+    config.threads = 4;
+    const ItchStats stats = index.Build(bytes.data(), bytes.size(), config);
+    EXPECT_EQ(stats.malformed, 1U);
+    EXPECT_EQ(stats.book_messages, 99U);
+}
+
+TEST(ItchIndexTest, ShortBookMessageIsReported)
+{
+    const Day day = MakeDay(3, 100, 9);
+    std::vector<std::uint8_t> bytes = day.writer.Bytes();
+    // A framed 'A' of 3 bytes instead of 36, replay would read its fields past the end
+    const std::uint8_t short_add[] = { 0, 3, 'A', 0, 1 };
+    bytes.insert(bytes.end(), std::begin(short_add), std::end(short_add));
+    ItchIndex index;
+    ItchConfig config;
+    config.threads = 4;
+    const ItchStats stats = index.Build(bytes.data(), bytes.size(), config);
+    EXPECT_EQ(stats.malformed, 1U);
+    EXPECT_EQ(stats.book_messages, 100U);
+
+    const ItchStats replayed = ReplayBooks(bytes.data(), index, config, [](unsigned) {
+        return [](std::uint16_t, std::uint64_t, const L3Book&) {};
+    });
+    EXPECT_EQ(replayed.book_messages, 100U);
+    EXPECT_EQ(replayed.rejected, 0U);
+}
+
+TEST(ItchReplayTest, ParallelReplayRebuildsEveryBook)
+{
+    const Day day = MakeDay(40, 30000, 13);
+    const auto& bytes = day.writer.Bytes();
+    ItchConfig config;
+    config.threads = 4;
+    ItchIndex index;
+    index.Build(bytes.data(), bytes.size(), config);
+
+    std::vector<std::map<std::uint16_t, L3Book>> finals(config.threads);
+    const ItchStats stats = ReplayBooks(bytes.data(), index, config, [&](unsigned worker) {
+        return [&finals, worker](std::uint16_t locate, std::uint64_t, const L3Book& book) { finals[worker][locate] = book; };
+    });
+    EXPECT_EQ(stats.book_messages, 30000U);
+    EXPECT_EQ(stats.rejected, 0U);
+    EXPECT_EQ(stats.snapshots, 40U);
+
+    std::size_t seen = 0;
+    for (const auto& books : finals) {
+        for (const auto& [locate, book] : books) {
+            ExpectSameLevels(book, day.expected.at(locate));
+            ++seen;
+        }
+    }
+    EXPECT_EQ(seen, 40U);
+}
+
+TEST(ItchReplayTest, SnapshotsAtIntervalBoundaries)
+{
+    ItchWriter writer;
+    writer.StockDirectory(1, "AAPL");
+    writer.AddOrder(1, 100, 1, Side::Buy, 10, 1500000);
+    writer.AddOrder(1, 950, 2, Side::Buy, 5, 1500100);
+    writer.Execute(1, 2500, 2, 5);
+    writer.Delete(1, 2600, 1);
+
+    ItchIndex index;
+    ItchConfig config;
+    config.snapshot_interval_ns = 1000;
+    index.Build(writer.Bytes().data(), writer.Bytes().size(), config);
+
+    std::vector<std::tuple<std::uint64_t, std::int64_t, std::size_t>> snapshots;
+    ReplayBooks(writer.Bytes().data(), index, config, [&](unsigned) {
+        return [&](std::uint16_t locate, std::uint64_t timestamp, const L3Book& book) {
+            EXPECT_EQ(locate, 1U);
+            snapshots.emplace_back(timestamp, book.BestBid().price, book.OrderCount());
+        };
+    });
+    ASSERT_EQ(snapshots.size(), 2U);
+    EXPECT_EQ(snapshots[0], std::make_tuple(std::uint64_t { 1000 }, std::int64_t { 1500100 }, std::size_t { 2 }));
+    EXPECT_EQ(snapshots[1], std::make_tuple(std::uint64_t { 2600 }, std::int64_t { 0 }, std::size_t { 0 }));
+}
+
+TEST(ItchFileTest, MapsFile)
+{
+    const Day day = MakeDay(2, 50, 1);
+    char path[] = "/tmp/itch_test_XXXXXX";
+    const int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    const auto& bytes = day.writer.Bytes();
+    ASSERT_EQ(::write(fd, bytes.data(), bytes.size()), static_cast<ssize_t>(bytes.size()));
+    ::close(fd);
+
+    ItchFile file;
+    ASSERT_TRUE(file.Open(path));
+    ItchIndex index;
+    EXPECT_EQ(index.Build(file.Data(), file.Size(), ItchConfig {}).book_messages, 50U);
+    ::unlink(path);
+}
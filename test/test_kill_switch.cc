@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <csignal>
+#include <string>
+#include <vector>
+#include "Gateway.hpp"
+#include "KillSwitch.hpp"
+#include "SPSC.hpp"
+#include "TradingEngine.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+struct RecordingTransport {
+    std::vector<EncodedOrder> sent;
+    void Send(const EncodedOrder& order) { sent.push_back(order); }
+};
+
+auto SellAt(std::int64_t price) -> MarketEvent
+{
+    MarketEvent event;
+    event.action = BookAction::Add;
+    event.side = Side::Sell;
+    event.price = price;
+    event.quantity = 1;
+    return event;
+}
+
+auto Decoded(const EncodedOrder& encoded) -> OrderRequest
+{
+    OrderRequest order;
+    EXPECT_TRUE(OrderEncoder::Decode(encoded.bytes.data(), encoded.length, order));
+    return order;
+}
+
+} // namespace
+
+TEST(KillSwitchTest, TripBumpsGenerationAndReset)
+{
+    KillSwitch kill_switch;
+    EXPECT_FALSE(kill_switch.IsTripped());
+    EXPECT_EQ(kill_switch.Reason(), KillReason::None);
+
+    kill_switch.Trip(KillReason::Manual);
+    EXPECT_TRUE(kill_switch.IsTripped());
+    EXPECT_EQ(kill_switch.Reason(), KillReason::Manual);
+    EXPECT_EQ(kill_switch.Generation(), 1U);
+    EXPECT_NE(kill_switch.TripTimestamp(), 0U);
+
+    kill_switch.Reset();
+    EXPECT_FALSE(kill_switch.IsTripped());
+    kill_switch.Trip(KillReason::Watchdog);
+    EXPECT_EQ(kill_switch.Generation(), 2U);
+}
+
+TEST(KillSwitchTest, EngineKeepsBooksButStopsEmitting)
+{
+    KillSwitch kill_switch;
+    TradingEngine<> engine(1, RiskLimits {});
+    TakerThreshold threshold;
+    threshold.buy_at_or_below = 100;
+    engine.Strategy().SetThreshold(0, threshold);
+    engine.ArmKillSwitch(&kill_switch);
+
+    SPSCRingBuffer<EncodedOrder, 16> out;
+    EXPECT_TRUE(engine.OnEvent(SellAt(100), out));
+
+    kill_switch.Trip(KillReason::Manual);
+    EXPECT_FALSE(engine.OnEvent(SellAt(99), out));
+    EXPECT_EQ(engine.Books().Book(0).BestAsk().price, 99);
+
+    kill_switch.Reset();
+    EXPECT_TRUE(engine.OnEvent(SellAt(98), out));
+}
+
+TEST(KillSwitchTest, GatewayCancelsOncePerTripAndDiscardsPending)
+{
+    KillSwitch kill_switch;
+    RecordingTransport transport;
+    Gateway<RecordingTransport> gateway(transport);
+    DropCopyQueue drop_copy;
+    gateway.AttachDropCopy(&drop_copy);
+
+    std::vector<EncodedOrder> templates(2);
+    OrderEncoder::EncodeMassCancel(3, templates[0]);
+    OrderEncoder::EncodeMassCancel(7, templates[1]);
+    gateway.ArmKillSwitch(&kill_switch, templates);
+
+    SPSCRingBuffer<EncodedOrder, 16> in;
+    OrderRequest order;
+    order.order_id = 42;
+    EncodedOrder encoded;
+    OrderEncoder::Encode(order, encoded);
+    ASSERT_TRUE(in.Push(encoded));
+    ASSERT_TRUE(in.Push(encoded));
+
+    kill_switch.Trip(KillReason::Risk);
+    EXPECT_EQ(gateway.Poll(in), 0U);
+    EXPECT_EQ(gateway.Poll(in), 0U);
+    EXPECT_TRUE(in.Empty());
+    EXPECT_EQ(gateway.GetKilledCount(), 2U);
+
+    ASSERT_EQ(transport.sent.size(), 2U);
+    const OrderRequest cancel = Decoded(transport.sent[1]);
+    EXPECT_EQ(cancel.action, OrderAction::Cancel);
+    EXPECT_EQ(cancel.instrument, 7U);
+    EXPECT_EQ(cancel.order_id, 0U);
+
+    OrderEvent event;
+    ASSERT_TRUE(drop_copy.Pop(event));
+    EXPECT_EQ(event.type, OrderEventType::Cancelled);
+
+    // A second trip after reset sends the templates again
+    kill_switch.Reset();
+    ASSERT_TRUE(in.Push(encoded));
+    EXPECT_EQ(gateway.Poll(in), 1U);
+    kill_switch.Trip(KillReason::Manual);
+    (void)gateway.Poll(in);
+    EXPECT_EQ(transport.sent.size(), 5U);
+}
+
+TEST(KillSwitchTest, SharedMappingsSeeEachOther)
+{
+    const std::string name = "/hft_kill_test_" + std::to_string(::getpid());
+    SharedKillSwitch::Unlink(name.c_str());
+    {
+        SharedKillSwitch trading;
+        SharedKillSwitch operator_tool;
+        ASSERT_TRUE(trading.Open(name.c_str()));
+        ASSERT_TRUE(operator_tool.Open(name.c_str()));
+        EXPECT_FALSE(trading.Get().IsTripped());
+
+        operator_tool.Get().Trip(KillReason::External);
+        EXPECT_TRUE(trading.Get().IsTripped());
+        EXPECT_EQ(trading.Get().Reason(), KillReason::External);
+    }
+    SharedKillSwitch::Unlink(name.c_str());
+}
+
+TEST(KillSwitchTest, SignalTrips)
+{
+    KillSwitch kill_switch;
+    ASSERT_TRUE(TripOnSignal(SIGUSR1, kill_switch));
+    ASSERT_EQ(std::raise(SIGUSR1), 0);
+    EXPECT_TRUE(kill_switch.IsTripped());
+    EXPECT_EQ(kill_switch.Reason(), KillReason::Signal);
+    std::signal(SIGUSR1, SIG_DFL);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "LoadGenerator.hpp"
+#include "RingBuffer.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+struct Moments {
+    double mean = 0.0;
+    double cv = 0.0; // coefficient of variation of the gaps
+};
+
+template <typename Model>
+auto Measure(Model& model, int samples) -> Moments
+{
+    FastRng rng(7);
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for (int i = 0; i < samples; ++i) {
+        const double gap = model.Next(rng);
+        sum += gap;
+        sum_sq += gap * gap;
+    }
+    Moments moments;
+    moments.mean = sum / samples;
+    moments.cv = std::sqrt((sum_sq / samples) - (moments.mean * moments.mean)) / moments.mean;
+    return moments;
+}
+
+} // namespace
+
+TEST(LoadGeneratorTest, PoissonMatchesRate)
+{
+    PoissonArrivals model(1e6);
+    const Moments moments = Measure(model, 500000);
+    EXPECT_NEAR(moments.mean, 1000.0, 10.0);
+    EXPECT_NEAR(moments.cv, 1.0, 0.02);
+}
+
+TEST(LoadGeneratorTest, HawkesIsBurstyAtSameRate)
+{
+    HawkesArrivals model(1e6, 0.8, 2e7);
+    const Moments moments = Measure(model, 500000);
+    EXPECT_NEAR(moments.mean, 1000.0, 100.0);
+    // Clustered arrivals are over dispersed compared to Poisson
+    EXPECT_GT(moments.cv, 1.5);
+}
+
+TEST(LoadGeneratorTest, ReplayRescalesToRate)
+{
+    // Recorded mean gap 20 ns, 2.5e7/s wants 40 ns: every gap doubles
+    ReplayArrivals model({ 10.0, 30.0 }, 2.5e7);
+    FastRng rng(1);
+    EXPECT_DOUBLE_EQ(model.Next(rng), 20.0);
+    EXPECT_DOUBLE_EQ(model.Next(rng), 60.0);
+    EXPECT_DOUBLE_EQ(model.Next(rng), 20.0);
+
+    ReplayArrivals recorded({ 10.0, 30.0 });
+    EXPECT_DOUBLE_EQ(recorded.Next(rng), 10.0);
+    EXPECT_DOUBLE_EQ(recorded.Next(rng), 30.0);
+}
+
+TEST(LoadGeneratorTest, RunEmitsOrderedEvents)
+{
+    constexpr std::uint64_t kCount = 20000;
+    RingBuffer<MarketEvent, 32768, OverflowPolicy::Reject, ThreadModel::SingleThread> ring;
+    LoadGeneratorConfig config;
+    config.instruments = 16;
+    LoadGenerator<PoissonArrivals> generator(PoissonArrivals(5e7), config);
+
+    const GeneratorStats stats = generator.Run(ring, kCount);
+    EXPECT_EQ(stats.emitted, kCount);
+    EXPECT_EQ(stats.dropped, 0U);
+
+    MarketEvent previous;
+    MarketEvent event;
+    ASSERT_TRUE(ring.Pop(previous));
+    for (std::uint64_t i = 1; i < kCount; ++i) {
+        ASSERT_TRUE(ring.Pop(event));
+        EXPECT_EQ(event.sequence, previous.sequence + 1);
+        EXPECT_GE(event.timestamp, previous.timestamp);
+        EXPECT_LT(event.instrument, 16U);
+        EXPECT_GE(event.quantity, 1U);
+        previous = event;
+    }
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Gateway.hpp"
+#include "OrderQueue.hpp"
+#include "SPSC.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+auto Encoded(OrderAction action, std::uint64_t order_id, std::int64_t price, std::uint32_t quantity = 10) -> EncodedOrder
+{
+    OrderRequest order;
+    order.action = action;
+    order.order_id = order_id;
+    order.price = price;
+    order.quantity = quantity;
+    order.origin_timestamp = static_cast<std::uint64_t>(price);
+    EncodedOrder encoded;
+    OrderEncoder::Encode(order, encoded);
+    return encoded;
+}
+
+template <typename Queue>
+auto DrainAll(Queue& queue) -> std::vector<OrderRequest>
+{
+    std::vector<OrderRequest> orders;
+    EncodedOrder encoded;
+    while (queue.Pop(encoded)) {
+        OrderRequest order;
+        EXPECT_TRUE(OrderEncoder::Decode(encoded.bytes.data(), encoded.length, order));
+        order.origin_timestamp = encoded.origin_timestamp;
+        orders.push_back(order);
+    }
+    return orders;
+}
+
+struct RecordingTransport {
+    std::vector<EncodedOrder> sent;
+    void Send(const EncodedOrder& order) { sent.push_back(order); }
+};
+
+} // namespace
+
+TEST(CoalescingOrderQueueTest, RepeatedAmendsLeaveOnlyTheLast)
+{
+    auto queue = std::make_unique<CoalescingOrderQueue<16>>();
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::New, 1, 100)));
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::New, 2, 200)));
+    EncodedOrder sent;
+    ASSERT_TRUE(queue->Pop(sent)); // order 1 is live at the exchange
+    for (std::int64_t price = 101; price <= 105; ++price) {
+        ASSERT_TRUE(queue->Push(Encoded(OrderAction::Replace, 1, price)));
+    }
+    EXPECT_EQ(queue->Size(), 2U);
+    EXPECT_EQ(queue->GetCoalescedCount(), 4U);
+
+    const auto orders = DrainAll(*queue);
+    ASSERT_EQ(orders.size(), 2U);
+    EXPECT_EQ(orders[0].order_id, 2U);
+    EXPECT_EQ(orders[1].action, OrderAction::Replace);
+    EXPECT_EQ(orders[1].price, 105);
+    EXPECT_EQ(orders[1].origin_timestamp, 105U);
+}
+
+TEST(CoalescingOrderQueueTest, AmendFoldsIntoUnsentNew)
+{
+    auto queue = std::make_unique<CoalescingOrderQueue<16>>();
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::New, 7, 100, 10)));
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::New, 8, 300)));
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::Replace, 7, 102, 4)));
+
+    const auto orders = DrainAll(*queue);
+    ASSERT_EQ(orders.size(), 2U);
+    EXPECT_EQ(orders[0].action, OrderAction::New);
+    EXPECT_EQ(orders[0].order_id, 7U);
+    EXPECT_EQ(orders[0].price, 102);
+    EXPECT_EQ(orders[0].quantity, 4U);
+    EXPECT_EQ(orders[1].order_id, 8U);
+
+    // Sent, so the next amend is a message of its own
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::Replace, 7, 103)));
+    EXPECT_EQ(DrainAll(*queue).front().action, OrderAction::Replace);
+}
+
+TEST(CoalescingOrderQueueTest, CancelsStayOrderedAndDropPendingAmend)
+{
+    auto queue = std::make_unique<CoalescingOrderQueue<16>>();
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::Replace, 1, 101)));
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::New, 2, 200)));
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::New, 3, 300)));
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::Cancel, 1, 101)));
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::Cancel, 3, 300)));
+    // After the cancel, not folded into the New of order 3
+    ASSERT_TRUE(queue->Push(Encoded(OrderAction::Replace, 3, 301)));
+    EXPECT_EQ(queue->GetCoalescedCount(), 1U);
+
+    const auto orders = DrainAll(*queue);
+    ASSERT_EQ(orders.size(), 5U);
+    EXPECT_EQ(orders[0].order_id, 2U);
+    EXPECT_EQ(orders[1].order_id, 3U);
+    EXPECT_EQ(orders[1].action, OrderAction::New);
+    EXPECT_EQ(orders[2].order_id, 1U);
+    EXPECT_EQ(orders[2].action, OrderAction::Cancel);
+    EXPECT_EQ(orders[3].action, OrderAction::Cancel);
+    EXPECT_EQ(orders[4].action, OrderAction::Replace);
+    EXPECT_EQ(orders[4].price, 301);
+    EXPECT_TRUE(queue->Empty());
+}
+
+TEST(CoalescingOrderQueueTest, ManyIdsSurviveProbeChains)
+{
+    auto queue = std::make_unique<CoalescingOrderQueue<64>>();
+    for (std::uint64_t id = 1; id <= 64; ++id) {
+        ASSERT_TRUE(queue->Push(Encoded(OrderAction::Replace, id, 1)));
+    }
+    EXPECT_FALSE(queue->Push(Encoded(OrderAction::New, 100, 1)));
+    for (std::uint64_t id = 1; id <= 64; id += 2) {
+        ASSERT_TRUE(queue->Push(Encoded(OrderAction::Replace, id, 2))); // coalesces while full
+    }
+    EncodedOrder encoded;
+    for (int i = 0; i < 32; ++i) {
+        ASSERT_TRUE(queue->Pop(encoded));
+    }
+    for (std::uint64_t id = 33; id <= 64; ++id) {
+        ASSERT_TRUE(queue->Push(Encoded(OrderAction::Replace, id, 3)));
+    }
+    const auto orders = DrainAll(*queue);
+    ASSERT_EQ(orders.size(), 32U);
+    for (const OrderRequest& order : orders) {
+        EXPECT_EQ(order.price, 3);
+    }
+}
+
+TEST(CoalescingOrderQueueTest, GatewaySendsWithinBudget)
+{
+    SPSCRingBuffer<EncodedOrder, 64> ring;
+    auto queue = std::make_unique<CoalescingOrderQueue<16>>();
+    RecordingTransport transport;
+    Gateway<RecordingTransport> gateway(transport);
+
+    ASSERT_TRUE(ring.Push(Encoded(OrderAction::New, 1, 100)));
+    queue->Absorb(ring);
+    EXPECT_EQ(gateway.Poll(*queue, 1), 1U);
+
+    // Throttled: two messages per poll while the strategy amends faster
+    for (std::int64_t price = 101; price <= 110; ++price) {
+        ASSERT_TRUE(ring.Push(Encoded(OrderAction::Replace, 1, price)));
+    }
+    ASSERT_TRUE(ring.Push(Encoded(OrderAction::New, 2, 500)));
+    EXPECT_EQ(queue->Absorb(ring), 11U);
+    EXPECT_EQ(gateway.Poll(*queue, 2), 2U);
+    EXPECT_TRUE(queue->Empty());
+    ASSERT_EQ(transport.sent.size(), 3U);
+
+    OrderRequest order;
+    ASSERT_TRUE(OrderEncoder::Decode(transport.sent[1].bytes.data(), transport.sent[1].length, order));
+    EXPECT_EQ(order.price, 110);
+    EXPECT_EQ(queue->GetCoalescedCount(), 9U);
+}
+
+TEST(CoalescingOrderQueueTest, FullQueueLeavesOrdersInRing)
+{
+    SPSCRingBuffer<EncodedOrder, 64> ring;
+    auto queue = std::make_unique<CoalescingOrderQueue<4>>();
+    for (std::uint64_t id = 1; id <= 6; ++id) {
+        ASSERT_TRUE(ring.Push(Encoded(OrderAction::New, id, 100)));
+    }
+    EXPECT_EQ(queue->Absorb(ring), 4U);
+    EXPECT_EQ(queue->GetRejectCount(), 0U);
+    EncodedOrder encoded;
+    ASSERT_TRUE(queue->Pop(encoded));
+    EXPECT_EQ(queue->Absorb(ring), 1U);
+    EXPECT_EQ(DrainAll(*queue).back().order_id, 5U);
+}
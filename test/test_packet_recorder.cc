@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "ByteRing.hpp"
+#include "PacketRecorder.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+auto ReadAll(const std::string& path) -> std::vector<std::uint8_t>
+{
+    std::vector<std::uint8_t> bytes;
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return bytes;
+    }
+    std::uint8_t chunk[4096];
+    std::size_t read = 0;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) != 0) {
+        bytes.insert(bytes.end(), chunk, chunk + read);
+    }
+    std::fclose(file);
+    return bytes;
+}
+
+auto U32(const std::vector<std::uint8_t>& bytes, std::size_t offset) -> std::uint32_t
+{
+    std::uint32_t value = 0;
+    std::memcpy(&value, bytes.data() + offset, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+TEST(ByteRingTest, RecordsWrapWithPadding)
+{
+    ByteRingBuffer<256> ring;
+    std::vector<std::uint8_t> payload(100);
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+
+    for (int round = 0; round < 20; ++round) {
+        std::memset(payload.data(), round, payload.size());
+        ASSERT_TRUE(ring.Push(payload.data(), 50 + round)) << round;
+        ASSERT_TRUE(ring.Peek(data, size));
+        ASSERT_EQ(size, static_cast<std::size_t>(50 + round));
+        EXPECT_EQ(data[0], round);
+        EXPECT_EQ(data[size - 1], round);
+        ring.Release();
+        EXPECT_TRUE(ring.Empty());
+    }
+}
+
+TEST(ByteRingTest, RejectsWhenFull)
+{
+    ByteRingBuffer<256> ring;
+    std::uint8_t payload[120] = {};
+    EXPECT_FALSE(ring.Push(payload, 121));
+    ASSERT_TRUE(ring.Push(payload, 100));
+    ASSERT_TRUE(ring.Push(payload, 100));
+    EXPECT_FALSE(ring.Push(payload, 40));
+    EXPECT_EQ(ring.GetDropCount(), 2U);
+
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+    ASSERT_TRUE(ring.Peek(data, size));
+    ring.Release();
+    EXPECT_TRUE(ring.Push(payload, 40));
+}
+
+TEST(PacketRecorderTest, WritesPcapngWithNanosecondTimestamps)
+{
+    const std::string path = "/tmp/hft_recorder_" + std::to_string(::getpid()) + ".pcapng";
+    PacketRecorderConfig config;
+    config.write_size = 4096;
+    auto recorder = std::make_unique<PacketRecorder<1 << 16>>(config);
+    ASSERT_TRUE(recorder->Open(path.c_str()));
+
+    const std::uint64_t base = 1700000000123456789ULL;
+    std::uint8_t datagram[301];
+    for (std::size_t i = 0; i < sizeof(datagram); ++i) {
+        datagram[i] = static_cast<std::uint8_t>(i);
+    }
+    constexpr int kPackets = 100;
+    for (int i = 0; i < kPackets; ++i) {
+        ASSERT_TRUE(recorder->Capture(base + static_cast<std::uint64_t>(i), datagram, 1 + (i * 3) % sizeof(datagram)));
+        if (i % 10 == 0) {
+            (void)recorder->Poll();
+        }
+    }
+    recorder->Close();
+    EXPECT_EQ(recorder->GetPacketCount(), static_cast<std::uint64_t>(kPackets));
+
+    const auto bytes = ReadAll(path);
+    ::unlink(path.c_str());
+    ASSERT_GE(bytes.size(), 60U);
+
+    // Section header then interface description with if_tsresol = 9
+    EXPECT_EQ(U32(bytes, 0), pcapng::kSectionHeader);
+    EXPECT_EQ(U32(bytes, 8), pcapng::kByteOrderMagic);
+    std::size_t offset = U32(bytes, 4);
+    EXPECT_EQ(U32(bytes, offset), pcapng::kInterfaceDescription);
+    EXPECT_EQ(bytes[offset + 16], pcapng::kOptionTimestampResolution);
+    EXPECT_EQ(bytes[offset + 20], 9);
+    offset += U32(bytes, offset + 4);
+
+    int packets = 0;
+    bool statistics = false;
+    while (offset < bytes.size()) {
+        const std::uint32_t type = U32(bytes, offset);
+        const std::uint32_t length = U32(bytes, offset + 4);
+        ASSERT_EQ(length % 4, 0U);
+        ASSERT_EQ(U32(bytes, offset + length - 4), length);
+        if (type == pcapng::kEnhancedPacket) {
+            const std::uint64_t timestamp = (static_cast<std::uint64_t>(U32(bytes, offset + 12)) << 32) | U32(bytes, offset + 16);
+            EXPECT_EQ(timestamp, base + static_cast<std::uint64_t>(packets));
+            const std::uint32_t captured = U32(bytes, offset + 20);
+            EXPECT_EQ(captured, 1 + (packets * 3) % sizeof(datagram));
+            EXPECT_EQ(U32(bytes, offset + 24), captured);
+            EXPECT_EQ(std::memcmp(bytes.data() + offset + 28, datagram, captured), 0);
+            ++packets;
+        } else if (type == pcapng::kInterfaceStatistics) {
+            statistics = true;
+        }
+        offset += length;
+    }
+    EXPECT_EQ(packets, kPackets);
+    EXPECT_TRUE(statistics);
+}
+
+TEST(PacketRecorderTest, TruncatesToSnapLength)
+{
+    const std::string path = "/tmp/hft_recorder_snap_" + std::to_string(::getpid()) + ".pcapng";
+    PacketRecorderConfig config;
+    config.snap_length = 16;
+    auto recorder = std::make_unique<PacketRecorder<1 << 16>>(config);
+    ASSERT_TRUE(recorder->Open(path.c_str()));
+    std::uint8_t datagram[64] = {};
+    ASSERT_TRUE(recorder->Capture(1, datagram, sizeof(datagram)));
+    recorder->Close();
+    const auto bytes = ReadAll(path);
+    ::unlink(path.c_str());
+    const std::size_t packet = 28 + 32;
+    ASSERT_GT(bytes.size(), packet + 28);
+    EXPECT_EQ(U32(bytes, packet), pcapng::kEnhancedPacket);
+    EXPECT_EQ(U32(bytes, packet + 20), 16U);
+    EXPECT_EQ(U32(bytes, packet + 24), 64U);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "LoadGenerator.hpp"
+#include "PartitionedBooks.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+using Builder = PartitionedBookBuilder<4, 1024>;
+
+auto Event(std::uint32_t instrument, Side side, std::int64_t price, std::uint32_t quantity, BookAction action = BookAction::Modify) -> MarketEvent
+{
+    MarketEvent event;
+    event.instrument = instrument;
+    event.side = side;
+    event.price = price;
+    event.quantity = quantity;
+    event.action = action;
+    return event;
+}
+
+auto RandomEvent(FastRng& rng, std::uint32_t instruments) -> MarketEvent
+{
+    // Skewed towards the first few instruments so rebalancing has hot symbols to move
+    const std::uint32_t instrument = rng.NextBelow(4) == 0 ? rng.NextBelow(instruments) : rng.NextBelow(3);
+    const Side side = rng.NextBelow(2) == 0 ? Side::Buy : Side::Sell;
+    const std::int64_t price = side == Side::Buy ? 100 - rng.NextBelow(6) : 101 + rng.NextBelow(6);
+    const auto action = rng.NextBelow(3) == 0 ? BookAction::Delete : BookAction::Add;
+    return Event(instrument, side, price, 1 + rng.NextBelow(20), action);
+}
+
+template <std::size_t Depth>
+void ExpectSameBook(const OrderBook<Depth>& actual, const OrderBook<Depth>& expected)
+{
+    for (const Side side : { Side::Buy, Side::Sell }) {
+        ASSERT_EQ(actual.LevelCount(side), expected.LevelCount(side));
+        for (std::size_t level = 0; level < expected.LevelCount(side); ++level) {
+            EXPECT_EQ(actual.Level(side, level).price, expected.Level(side, level).price);
+            EXPECT_EQ(actual.Level(side, level).quantity, expected.Level(side, level).quantity);
+        }
+    }
+}
+
+} // namespace
+
+TEST(PartitionedBookBuilderTest, RoutesByInstrument)
+{
+    auto builder = std::make_unique<Builder>(16, 3);
+    for (std::uint32_t instrument = 0; instrument < 16; ++instrument) {
+        EXPECT_LT(builder->Owner(instrument), 3U);
+        ASSERT_TRUE(builder->Dispatch(Event(instrument, Side::Buy, 100 + instrument, 5)));
+    }
+    EXPECT_FALSE(builder->Dispatch(Event(16, Side::Buy, 100, 5)));
+    EXPECT_FALSE(builder->Drained());
+
+    std::vector<std::uint32_t> changed;
+    for (std::uint32_t p = 0; p < 3; ++p) {
+        builder->Poll(p, [&](const MarketEvent& event, const OrderBook<4>& book) {
+            EXPECT_EQ(builder->Owner(event.instrument), p);
+            EXPECT_EQ(book.BestBid().price, event.price);
+            changed.push_back(event.instrument);
+        });
+    }
+    EXPECT_EQ(changed.size(), 16U);
+    EXPECT_TRUE(builder->Drained());
+    EXPECT_EQ(builder->Book(9).BestBid().price, 109);
+}
+
+TEST(PartitionedBookBuilderTest, NewOwnerWaitsAtBarrier)
+{
+    auto builder = std::make_unique<Builder>(4, 2);
+    const std::uint32_t instrument = 0;
+    const std::uint32_t from = builder->Owner(instrument);
+    const std::uint32_t to = 1 - from;
+
+    ASSERT_TRUE(builder->Dispatch(Event(instrument, Side::Buy, 100, 5, BookAction::Add)));
+    ASSERT_TRUE(builder->Rebalance(instrument, to));
+    EXPECT_EQ(builder->Owner(instrument), to);
+    ASSERT_TRUE(builder->Dispatch(Event(instrument, Side::Buy, 100, 7, BookAction::Modify)));
+
+    // The new owner holds back until the old owner has applied the Add
+    EXPECT_EQ(builder->Poll(to), 1U);
+    EXPECT_EQ(builder->Poll(to), 0U);
+    EXPECT_EQ(builder->Book(instrument).BestBid().quantity, 0U);
+
+    EXPECT_EQ(builder->Poll(from), 1U);
+    EXPECT_EQ(builder->Book(instrument).BestBid().quantity, 5U);
+    EXPECT_EQ(builder->Poll(to), 1U);
+    EXPECT_EQ(builder->Book(instrument).BestBid().quantity, 7U);
+    EXPECT_TRUE(builder->Drained());
+    EXPECT_EQ(builder->GetMoveCount(), 1U);
+}
+
+TEST(PartitionedBookBuilderTest, RebalanceHotMovesBusiestInstrument)
+{
+    auto builder = std::make_unique<Builder>(64, 2);
+    std::uint32_t hot = 0;
+    std::uint32_t warm = 0;
+    while (builder->Owner(warm) != builder->Owner(hot) || warm == hot) {
+        ++warm;
+    }
+    const std::uint32_t busy = builder->Owner(hot);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(builder->Dispatch(Event(hot, Side::Buy, 100, 1)));
+    }
+    for (int i = 0; i < 60; ++i) {
+        ASSERT_TRUE(builder->Dispatch(Event(warm, Side::Buy, 100, 1)));
+    }
+    // Moving hot (100 of a 160 gap) is the largest move that narrows it
+    EXPECT_EQ(builder->RebalanceHot(1), 1U);
+    EXPECT_NE(builder->Owner(hot), busy);
+    EXPECT_EQ(builder->Owner(warm), busy);
+}
+
+TEST(PartitionedBookBuilderTest, ThreadedBuildMatchesSequentialWithRebalances)
+{
+    constexpr std::uint32_t kInstruments = 32;
+    constexpr std::uint32_t kPartitions = 4;
+    constexpr int kEvents = 200000;
+    auto builder = std::make_unique<Builder>(kInstruments, kPartitions);
+    BookBuilder<4> reference(kInstruments);
+
+    std::atomic<bool> done { false };
+    std::vector<std::thread> workers;
+    for (std::uint32_t p = 0; p < kPartitions; ++p) {
+        workers.emplace_back([&, p] {
+            while (!done.load(std::memory_order_acquire)) {
+                if (builder->Poll(p) == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    FastRng rng(11);
+    for (int i = 0; i < kEvents; ++i) {
+        const MarketEvent event = RandomEvent(rng, kInstruments);
+        reference.Apply(event);
+        while (!builder->Dispatch(event)) {
+            std::this_thread::yield();
+        }
+        if (i % 5000 == 4999) {
+            builder->RebalanceHot(2);
+            while (!builder->Rebalance(rng.NextBelow(kInstruments), rng.NextBelow(kPartitions))) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    while (!builder->Drained()) {
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_GT(builder->GetMoveCount(), 0U);
+    for (std::uint32_t instrument = 0; instrument < kInstruments; ++instrument) {
+        ExpectSameBook(builder->Book(instrument), reference.Book(instrument));
+    }
+}
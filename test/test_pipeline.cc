@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+#include "AllocationGuard.hpp"
+#include "FeedHandler.hpp"
+#include "Gateway.hpp"
+#include "RingBuffer.hpp"
+#include "TradingEngine.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+auto Event(BookAction action, Side side, std::int64_t price, std::uint32_t quantity, std::uint32_t instrument = 0) -> MarketEvent
+{
+    MarketEvent event;
+    event.action = action;
+    event.side = side;
+    event.price = price;
+    event.quantity = quantity;
+    event.instrument = instrument;
+    return event;
+}
+
+struct RecordingTransport {
+    std::vector<EncodedOrder> sent;
+    void Send(const EncodedOrder& order) { sent.push_back(order); }
+};
+
+} // namespace
+
+TEST(OrderBookTest, LevelsStaySorted)
+{
+    OrderBook<4> book;
+    EXPECT_TRUE(book.Apply(Event(BookAction::Add, Side::Buy, 100, 5)));
+    EXPECT_TRUE(book.Apply(Event(BookAction::Add, Side::Buy, 101, 3)));
+    EXPECT_FALSE(book.Apply(Event(BookAction::Add, Side::Buy, 99, 7)));
+    EXPECT_TRUE(book.Apply(Event(BookAction::Add, Side::Sell, 103, 2)));
+    EXPECT_TRUE(book.Apply(Event(BookAction::Add, Side::Sell, 102, 4)));
+
+    EXPECT_EQ(book.BestBid().price, 101);
+    EXPECT_EQ(book.Level(Side::Buy, 2).price, 99);
+    EXPECT_EQ(book.BestAsk().price, 102);
+
+    EXPECT_TRUE(book.Apply(Event(BookAction::Trade, Side::Buy, 101, 3)));
+    EXPECT_EQ(book.BestBid().price, 100);
+    EXPECT_TRUE(book.Apply(Event(BookAction::Modify, Side::Buy, 100, 1)));
+    EXPECT_EQ(book.BestBid().quantity, 1U);
+    EXPECT_TRUE(book.Apply(Event(BookAction::Delete, Side::Sell, 102, 10)));
+    EXPECT_EQ(book.BestAsk().price, 103);
+    EXPECT_EQ(book.LevelCount(Side::Sell), 1U);
+}
+
+TEST(OrderBookTest, DropsLevelsBeyondDepth)
+{
+    OrderBook<2> book;
+    (void)book.Apply(Event(BookAction::Add, Side::Sell, 10, 1));
+    (void)book.Apply(Event(BookAction::Add, Side::Sell, 11, 1));
+    EXPECT_FALSE(book.Apply(Event(BookAction::Add, Side::Sell, 12, 1)));
+    EXPECT_TRUE(book.Apply(Event(BookAction::Add, Side::Sell, 9, 1)));
+    EXPECT_EQ(book.LevelCount(Side::Sell), 2U);
+    EXPECT_EQ(book.Level(Side::Sell, 1).price, 10);
+}
+
+TEST(PipelineTest, FeedToGateway)
+{
+    RingBuffer<FeedPacket, 16, OverflowPolicy::Reject, ThreadModel::SingleThread> packets;
+    RingBuffer<MarketEvent, 16, OverflowPolicy::Reject, ThreadModel::SingleThread> events;
+    RingBuffer<EncodedOrder, 16, OverflowPolicy::Reject, ThreadModel::SingleThread> orders;
+
+    RiskLimits limits;
+    limits.max_position = 5;
+    TradingEngine<> engine(2, limits);
+    TakerThreshold threshold;
+    threshold.buy_at_or_below = 100;
+    threshold.quantity = 5;
+    engine.Strategy().SetThreshold(1, threshold);
+
+    MarketEvent ask = Event(BookAction::Add, Side::Sell, 100, 3, 1);
+    ask.timestamp = 1234;
+    EXPECT_TRUE(packets.Push(EncodePacket(Event(BookAction::Add, Side::Sell, 100, 3, 0))));
+    EXPECT_TRUE(packets.Push(EncodePacket(ask)));
+    FeedPacket malformed;
+    malformed.action = 42;
+    EXPECT_TRUE(packets.Push(malformed));
+
+    FeedHandler feed;
+    EXPECT_EQ(feed.Poll(packets, events), 2U);
+    EXPECT_EQ(feed.GetMalformedCount(), 1U);
+    EXPECT_EQ(engine.Poll(events, orders), 2U);
+
+    RecordingTransport transport;
+    Gateway<RecordingTransport> gateway(transport);
+    EXPECT_EQ(gateway.Poll(orders), 1U);
+    ASSERT_EQ(transport.sent.size(), 1U);
+    EXPECT_EQ(transport.sent[0].origin_timestamp, 1234U);
+
+    OrderRequest decoded;
+    ASSERT_TRUE(OrderEncoder::Decode(transport.sent[0].bytes.data(), transport.sent[0].length, decoded));
+    EXPECT_EQ(decoded.instrument, 1U);
+    EXPECT_EQ(decoded.side, Side::Buy);
+    EXPECT_EQ(decoded.price, 100);
+    EXPECT_EQ(decoded.quantity, 3U);
+    EXPECT_EQ(engine.Risk().Position(1), 3);
+
+    // The position limit stops the next trigger
+    EXPECT_TRUE(events.Push(Event(BookAction::Add, Side::Sell, 99, 5, 1)));
+    EXPECT_EQ(engine.Poll(events, orders), 1U);
+    EXPECT_TRUE(orders.Empty());
+    EXPECT_EQ(engine.Risk().GetRejectCount(), 1U);
+}
+
+TEST(PipelineTest, NoAllocationPerMessage)
+{
+    if (!hft::alloc::HooksInstalled()) {
+        GTEST_SKIP() << "allocation hooks compiled out (sanitizer build or not glibc)";
+    }
+    RingBuffer<FeedPacket, 16, OverflowPolicy::Reject, ThreadModel::SingleThread> packets;
+    RingBuffer<MarketEvent, 16, OverflowPolicy::Reject, ThreadModel::SingleThread> events;
+    RingBuffer<EncodedOrder, 16, OverflowPolicy::Reject, ThreadModel::SingleThread> orders;
+
+    RiskLimits limits;
+    limits.max_position = 1000000;
+    TradingEngine<> engine(4, limits);
+    TakerThreshold threshold;
+    threshold.buy_at_or_below = 100;
+    threshold.quantity = 1;
+    engine.Strategy().SetThreshold(1, threshold);
+
+    // Room for every order up front, the test transport must not allocate either
+    RecordingTransport transport;
+    transport.sent.reserve(1000);
+    Gateway<RecordingTransport> gateway(transport);
+    FeedHandler feed;
+    OrderBook<4> book;
+
+    std::uint64_t allocations = 0;
+    {
+        hft::alloc::HotPathScope scope;
+        for (std::uint32_t i = 0; i < 1000; ++i) {
+            const MarketEvent event = Event(BookAction::Add, Side::Sell, 100 - static_cast<std::int64_t>(i % 2), 1, 1);
+            (void)book.Apply(event);
+            (void)packets.Push(EncodePacket(event));
+            (void)feed.Poll(packets, events);
+            (void)engine.Poll(events, orders);
+            (void)gateway.Poll(orders);
+        }
+        allocations = scope.Allocations();
+    }
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_FALSE(transport.sent.empty());
+    EXPECT_EQ(book.BestAsk().price, 99);
+}
+
+TEST(PipelineTest, FullOrderRingReleasesRiskReservation)
+{
+    // One usable slot, the second order does not fit
+    RingBuffer<EncodedOrder, 2, OverflowPolicy::Reject, ThreadModel::SingleThread> orders;
+    RiskLimits limits;
+    limits.max_position = 100;
+    TradingEngine<> engine(2, limits);
+    TakerThreshold threshold;
+    threshold.buy_at_or_below = 100;
+    threshold.quantity = 3;
+    engine.Strategy().SetThreshold(1, threshold);
+
+    EXPECT_TRUE(engine.OnEvent(Event(BookAction::Add, Side::Sell, 100, 3, 1), orders));
+    EXPECT_EQ(engine.Risk().Position(1), 3);
+    EXPECT_FALSE(engine.OnEvent(Event(BookAction::Add, Side::Sell, 99, 3, 1), orders));
+    EXPECT_EQ(engine.GetDropCount(), 1U);
+    EXPECT_EQ(engine.Risk().Position(1), 3);
+
+    EncodedOrder sent;
+    ASSERT_TRUE(orders.Pop(sent));
+    EXPECT_TRUE(engine.OnEvent(Event(BookAction::Add, Side::Sell, 98, 3, 1), orders));
+    EXPECT_EQ(engine.Risk().Position(1), 6);
+}
+
+TEST(PipelineTest, RiskNotionalDoesNotOverflow)
+{
+    RiskLimits limits;
+    limits.max_order_quantity = 1000;
+    RiskCheck risk(1, limits);
+    OrderRequest order;
+    order.side = Side::Buy;
+    order.quantity = 1000;
+    // price * quantity wraps int64 to a small value
+    order.price = std::numeric_limits<std::int64_t>::max() / 500;
+    EXPECT_FALSE(risk.Check(order));
+    order.price = std::numeric_limits<std::int64_t>::min();
+    EXPECT_FALSE(risk.Check(order));
+    order.price = limits.max_order_notional / 1000;
+    EXPECT_TRUE(risk.Check(order));
+    order.price += 1;
+    EXPECT_FALSE(risk.Check(order));
+    EXPECT_EQ(risk.GetRejectCount(), 3U);
+}
+
+TEST(PipelineTest, RiskAmendsDoNotReserveAgain)
+{
+    RiskLimits limits;
+    limits.max_position = 1000;
+    RiskCheck risk(1, limits);
+    OrderRequest order;
+    order.order_id = 9;
+    order.side = Side::Buy;
+    order.price = 100;
+    order.quantity = 600;
+    ASSERT_TRUE(risk.Check(order));
+
+    order.action = OrderAction::Replace;
+    for (int i = 0; i < 10; ++i) {
+        order.price = 100 + i;
+        EXPECT_TRUE(risk.Check(order));
+    }
+    EXPECT_EQ(risk.Position(0), 600);
+    risk.Release(order);
+    EXPECT_EQ(risk.Position(0), 600);
+
+    // Per order limits still apply to amends
+    order.quantity = limits.max_order_quantity + 1;
+    EXPECT_FALSE(risk.Check(order));
+    EXPECT_EQ(risk.GetRejectCount(), 1U);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+// Force the instrumentation on regardless of the build option
+#ifndef HFT_ENABLE_PROFILING
+#define HFT_ENABLE_PROFILING
+#endif
+#include "Profile.hpp"
+
+using namespace hft;
+
+namespace {
+
+void Inner()
+{
+    HFT_PROFILE_SCOPE("inner");
+}
+
+void Outer()
+{
+    HFT_PROFILE_SCOPE("outer");
+    Inner();
+    Inner();
+}
+
+auto Find(const std::vector<profile::ScopeReport>& reports, const char* name, std::uint32_t depth) -> const profile::ScopeReport*
+{
+    for (const auto& report : reports) {
+        if (std::string(report.name) == name && report.depth == depth) {
+            return &report;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(ProfileTest, IdsAreCompileTime)
+{
+    static_assert(profile::ScopeId("book") != profile::ScopeId("gateway"));
+    static_assert(profile::ScopeId("book") == profile::ScopeId("book"));
+}
+
+TEST(ProfileTest, NestedScopesAggregateAcrossThreads)
+{
+    std::thread worker([] {
+        for (int i = 0; i < 10; ++i)
+            Outer();
+    });
+    for (int i = 0; i < 5; ++i)
+        Outer();
+    Inner();
+    worker.join();
+
+    const auto reports = profile::Collect();
+    const auto* outer = Find(reports, "outer", 0);
+    const auto* nested = Find(reports, "inner", 1);
+    const auto* top = Find(reports, "inner", 0);
+    ASSERT_NE(outer, nullptr);
+    ASSERT_NE(nested, nullptr);
+    ASSERT_NE(top, nullptr);
+
+    EXPECT_EQ(outer->count, 15U);
+    EXPECT_EQ(nested->count, 30U);
+    EXPECT_EQ(nested->parent, outer->path);
+    EXPECT_EQ(top->count, 1U);
+    EXPECT_GE(outer->total_cycles, nested->total_cycles);
+
+    std::ostringstream out;
+    profile::Print(out);
+    EXPECT_NE(out.str().find("  inner calls=30"), std::string::npos);
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "OrderBook.hpp"
+#include "QuoteEngine.hpp"
+#include "SPSC.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+using OrderRing = SPSCRingBuffer<EncodedOrder, 64>;
+
+auto Level(Side side, std::int64_t price, std::uint32_t quantity, BookAction action = BookAction::Modify) -> MarketEvent
+{
+    MarketEvent event;
+    event.price = price;
+    event.quantity = quantity;
+    event.action = action;
+    event.side = side;
+    return event;
+}
+
+template <typename Ring>
+auto Drain(Ring& ring) -> std::vector<OrderRequest>
+{
+    std::vector<OrderRequest> orders;
+    EncodedOrder encoded;
+    OrderRequest order;
+    while (ring.Pop(encoded)) {
+        if (OrderEncoder::Decode(encoded.bytes.data(), encoded.length, order)) {
+            orders.push_back(order);
+        }
+    }
+    return orders;
+}
+
+/**
+ * @brief Apply event to book and hand it to the engine like the pipeline does
+ *
+ */
+auto Update(QuoteEngine& engine, OrderBook<>& book, const MarketEvent& event) -> bool
+{
+    return book.Apply(event) && engine.OnBook(event, book);
+}
+
+QuoteParams Params()
+{
+    QuoteParams params;
+    params.half_spread = 1;
+    params.requote_threshold = 2;
+    params.quantity = 5;
+    return params;
+}
+
+} // namespace
+
+TEST(QuoteEngineTest, QuotesAroundSizeWeightedMid)
+{
+    QuoteEngine engine(1);
+    OrderBook<> book;
+    OrderRing ring;
+    engine.SetParams(0, Params());
+    EXPECT_FALSE(Update(engine, book, Level(Side::Buy, 100, 10)));
+    EXPECT_TRUE(Update(engine, book, Level(Side::Sell, 106, 30)));
+    EXPECT_DOUBLE_EQ(engine.FairValue(0), 101.5); // 100 * 30 + 106 * 10 over 40
+
+    EXPECT_EQ(engine.Flush(ring), 2U);
+    const auto orders = Drain(ring);
+    ASSERT_EQ(orders.size(), 2U);
+    EXPECT_EQ(orders[0].action, OrderAction::New);
+    EXPECT_EQ(orders[0].side, Side::Buy);
+    EXPECT_EQ(orders[0].price, 100);
+    EXPECT_EQ(orders[1].side, Side::Sell);
+    EXPECT_EQ(orders[1].price, 103);
+    EXPECT_EQ(orders[1].quantity, 5U);
+    EXPECT_EQ(engine.Quote(0, Side::Sell).order_id, orders[1].order_id);
+    EXPECT_EQ(engine.QueuedCount(), 0U);
+}
+
+TEST(QuoteEngineTest, SmallMovesAreSuppressed)
+{
+    QuoteEngine engine(1);
+    OrderBook<> book;
+    OrderRing ring;
+    engine.SetParams(0, Params());
+    Update(engine, book, Level(Side::Buy, 100, 10));
+    Update(engine, book, Level(Side::Sell, 110, 10));
+    engine.Flush(ring);
+    const auto placed = Drain(ring);
+    ASSERT_EQ(placed.size(), 2U);
+    EXPECT_EQ(placed[0].price, 104);
+    EXPECT_EQ(placed[1].price, 106);
+
+    // Mid moves to 105.5, both targets within one tick
+    EXPECT_FALSE(Update(engine, book, Level(Side::Buy, 101, 10)));
+    EXPECT_FALSE(Update(engine, book, Level(Side::Buy, 100, 10, BookAction::Delete)));
+    EXPECT_EQ(engine.GetSuppressedCount(), 2U);
+    EXPECT_EQ(engine.Flush(ring), 0U);
+
+    // Bid lifted to 104, mid 107: both sides move 2
+    EXPECT_TRUE(Update(engine, book, Level(Side::Buy, 104, 10)));
+    EXPECT_EQ(engine.Flush(ring), 2U);
+    const auto replaced = Drain(ring);
+    ASSERT_EQ(replaced.size(), 2U);
+    EXPECT_EQ(replaced[0].action, OrderAction::Replace);
+    EXPECT_EQ(replaced[0].order_id, placed[0].order_id);
+    EXPECT_EQ(replaced[0].price, 106);
+    EXPECT_EQ(replaced[1].price, 108);
+}
+
+TEST(QuoteEngineTest, UpdatesCoalesceUntilFlush)
+{
+    QuoteEngine engine(2);
+    std::vector<OrderBook<>> books(2);
+    OrderRing ring;
+    for (std::uint32_t instrument = 0; instrument < 2; ++instrument) {
+        engine.SetParams(instrument, Params());
+        MarketEvent bid = Level(Side::Buy, 100, 10);
+        MarketEvent ask = Level(Side::Sell, 110, 10);
+        bid.instrument = ask.instrument = instrument;
+        Update(engine, books[instrument], bid);
+        Update(engine, books[instrument], ask);
+    }
+    EXPECT_EQ(engine.QueuedCount(), 2U);
+    for (std::int64_t price = 101; price <= 108; ++price) {
+        Update(engine, books[0], Level(Side::Buy, price, 10));
+    }
+    EXPECT_EQ(engine.QueuedCount(), 2U);
+    EXPECT_EQ(engine.Flush(ring), 4U);
+    const auto orders = Drain(ring);
+    ASSERT_EQ(orders.size(), 4U);
+    EXPECT_EQ(orders[0].instrument, 0U);
+    EXPECT_EQ(orders[0].price, 108); // fair 109 from the latest touch only
+    EXPECT_EQ(orders[1].price, 110);
+    EXPECT_EQ(orders[2].instrument, 1U);
+}
+
+TEST(QuoteEngineTest, CancelsWhenBookSideEmpties)
+{
+    QuoteEngine engine(1);
+    OrderBook<> book;
+    OrderRing ring;
+    engine.SetParams(0, Params());
+    Update(engine, book, Level(Side::Buy, 100, 10));
+    Update(engine, book, Level(Side::Sell, 110, 10));
+    engine.Flush(ring);
+    Drain(ring);
+
+    EXPECT_TRUE(Update(engine, book, Level(Side::Sell, 110, 10, BookAction::Delete)));
+    EXPECT_TRUE(std::isnan(engine.FairValue(0)));
+    EXPECT_EQ(engine.Flush(ring), 2U);
+    const auto orders = Drain(ring);
+    ASSERT_EQ(orders.size(), 2U);
+    EXPECT_EQ(orders[0].action, OrderAction::Cancel);
+    EXPECT_EQ(orders[1].action, OrderAction::Cancel);
+    EXPECT_EQ(engine.Quote(0, Side::Buy).quantity, 0U);
+}
+
+TEST(QuoteEngineTest, UnpublishedOrdersStayQueued)
+{
+    QuoteEngine engine(3);
+    std::vector<OrderBook<>> books(3);
+    SPSCRingBuffer<EncodedOrder, 4> ring; // three slots
+    for (std::uint32_t instrument = 0; instrument < 3; ++instrument) {
+        engine.SetParams(instrument, Params());
+        MarketEvent bid = Level(Side::Buy, 100, 10);
+        MarketEvent ask = Level(Side::Sell, 110, 10);
+        bid.instrument = ask.instrument = instrument;
+        Update(engine, books[instrument], bid);
+        Update(engine, books[instrument], ask);
+    }
+    EXPECT_EQ(engine.Flush(ring), 3U);
+    EXPECT_EQ(engine.GetDropCount(), 3U);
+    EXPECT_EQ(engine.QueuedCount(), 2U);
+    EXPECT_EQ(engine.Quote(1, Side::Buy).quantity, 5U);
+    EXPECT_EQ(engine.Quote(1, Side::Sell).quantity, 0U);
+
+    EncodedOrder encoded;
+    while (ring.Pop(encoded)) {
+    }
+    EXPECT_EQ(engine.Flush(ring), 3U);
+    EXPECT_EQ(engine.QueuedCount(), 0U);
+    // Restaged News keep the ids reserved by the first Flush
+    const std::vector<OrderRequest> orders = Drain(ring);
+    ASSERT_EQ(orders.size(), 3U);
+    EXPECT_EQ(orders[0].order_id, 4U);
+    EXPECT_EQ(orders[1].order_id, 5U);
+    EXPECT_EQ(orders[2].order_id, 6U);
+    EXPECT_EQ(engine.NextOrderId(), 7U);
+    EXPECT_EQ(engine.Quote(2, Side::Sell).quantity, 5U);
+    EXPECT_EQ(engine.GetSentCount(), 6U);
+}
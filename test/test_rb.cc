@@ -2,7 +2,9 @@
 #include <thread>
 #include <vector>
 #include <set>
+#include "AllocationGuard.hpp"
 #include "RingBuffer.hpp" // Path to your header
+#include "SPSC.hpp"
 
 using namespace hft::core;
 
@@ -101,4 +103,111 @@ TEST(RingBufferTest, ConcurrencyStressTest)
             FAIL() << "Data mismatch at index " << i;
         }
     }
-}
\ No newline at end of file
+}
+// 6. Single threaded model keeps the FIFO semantics without atomics
+TEST(RingBufferTest, SingleThreadModel)
+{
+    RingBuffer<int, 4, OverflowPolicy::Reject, ThreadModel::SingleThread> rb;
+    static_assert(sizeof(rb) < sizeof(RingBuffer<int, 4>), "SingleThread must drop the cache line padding");
+
+    EXPECT_TRUE(rb.Push(1));
+    EXPECT_TRUE(rb.Push(2));
+    EXPECT_TRUE(rb.Push(3));
+    EXPECT_FALSE(rb.Push(4));
+    EXPECT_EQ(rb.Size(), 3);
+    EXPECT_EQ(rb.Front(), 1);
+
+    int val;
+    EXPECT_TRUE(rb.Pop(val));
+    EXPECT_EQ(val, 1);
+    EXPECT_TRUE(rb.Pop(val));
+    EXPECT_TRUE(rb.Pop(val));
+    EXPECT_EQ(val, 3);
+    EXPECT_FALSE(rb.Pop(val));
+    EXPECT_TRUE(rb.Empty());
+}
+
+// 7. Overwrite works the same way in the single threaded model
+TEST(RingBufferTest, SingleThreadOverwrite)
+{
+    RingBuffer<int, 4, OverflowPolicy::Overwrite, ThreadModel::SingleThread> rb;
+
+    for (int i = 1; i <= 4; ++i)
+        EXPECT_TRUE(rb.Push(i));
+
+    int val;
+    EXPECT_TRUE(rb.Pop(val));
+    EXPECT_EQ(val, 2);
+    EXPECT_EQ(rb.Size(), 2);
+}
+
+// 8. SPSC model: consumer stores head without CAS
+TEST(RingBufferTest, SPSCModelStress)
+{
+    const int kCount = 1000000;
+    RingBuffer<int, 1024, OverflowPolicy::Reject, ThreadModel::SPSC> rb;
+    long long sum = 0;
+
+    std::thread producer([&]() {
+        for (int i = 0; i < kCount; ++i) {
+            while (!rb.Push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int val;
+    int expected = 0;
+    while (expected < kCount) {
+        if (rb.Pop(val)) {
+            ASSERT_EQ(val, expected);
+            sum += val;
+            ++expected;
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(sum, static_cast<long long>(kCount) * (kCount - 1) / 2);
+}
+
+// 9. No allocation per message, with hft_alloc_guard linked into this test
+TEST(RingBufferTest, PushPopDoesNotAllocate)
+{
+    if (!hft::alloc::HooksInstalled()) {
+        GTEST_SKIP() << "allocation hooks compiled out (sanitizer build or not glibc)";
+    }
+    RingBuffer<int, 1024, OverflowPolicy::Reject, ThreadModel::SPSC> rb;
+    SPSCRingBuffer<int, 1024> spsc;
+    int sum = 0;
+    std::uint64_t allocations = 0;
+    {
+        hft::alloc::HotPathScope scope;
+        int val;
+        for (int i = 0; i < 10000; ++i) {
+            (void)rb.Push(i);
+            (void)spsc.Push(i);
+            sum += rb.Pop(val) ? 1 : 0;
+            sum += spsc.Pop(val) ? 1 : 0;
+        }
+        allocations = scope.Allocations();
+    }
+    EXPECT_EQ(sum, 20000);
+    EXPECT_EQ(allocations, 0u);
+}
+
+TEST(SPSCRingBufferTest, PushBatchPublishesWhatFits)
+{
+    SPSCRingBuffer<int, 8> ring;
+    const int values[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    EXPECT_EQ(ring.PushBatch(values, 5), 5U);
+    int out = 0;
+    ASSERT_TRUE(ring.Pop(out));
+    EXPECT_EQ(out, 0);
+    EXPECT_EQ(ring.PushBatch(values + 5, 5), 3U); // 7 usable slots, 4 in use
+    EXPECT_EQ(ring.GetDropCount(), 2U);
+    for (int expected = 1; expected <= 7; ++expected) {
+        ASSERT_TRUE(ring.Pop(out));
+        EXPECT_EQ(out, expected);
+    }
+    EXPECT_TRUE(ring.Empty());
+}
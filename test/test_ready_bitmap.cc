@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "ReadyBitmap.hpp"
+#include "SPSC.hpp"
+
+using namespace hft::core;
+
+TEST(ReadyBitmapTest, DrainVisitsMarkedOnce)
+{
+    ReadyBitmap<8192> bitmap;
+    EXPECT_FALSE(bitmap.Any());
+
+    bitmap.Notify(5);
+    bitmap.Notify(4100);
+    bitmap.Notify(5);
+    bitmap.Notify(8191);
+    EXPECT_TRUE(bitmap.Any());
+
+    std::vector<std::size_t> seen;
+    EXPECT_EQ(bitmap.Drain([&](std::size_t i) { seen.push_back(i); }), 3U);
+    EXPECT_EQ(seen, (std::vector<std::size_t> { 5, 4100, 8191 }));
+
+    EXPECT_FALSE(bitmap.Any());
+    EXPECT_EQ(bitmap.Drain([](std::size_t) { }), 0U);
+}
+
+// Producer pushes into many rings and rings the bell on the empty to
+// non-empty edge, the consumer only drains rings it was told about.
+// Nothing may be left behind.
+TEST(ReadyBitmapTest, NoLostDoorbell)
+{
+    constexpr std::size_t kRings = 256;
+    constexpr int kCount = 200000;
+    using Ring = SPSCRingBuffer<int, 64>;
+    auto rings = std::make_unique<Ring[]>(kRings);
+    ReadyBitmap<kRings> bitmap;
+
+    std::thread producer([&]() {
+        for (int i = 0; i < kCount; ++i) {
+            const std::size_t id = (static_cast<std::size_t>(i) * 7) % kRings;
+            bool was_empty = false;
+            while (!rings[id].PushEdge(i, was_empty)) {
+                std::this_thread::yield();
+            }
+            if (was_empty) {
+                bitmap.Notify(id);
+            }
+        }
+    });
+
+    int received = 0;
+    int val;
+    while (received < kCount) {
+        bitmap.Drain([&](std::size_t id) {
+            do {
+                while (rings[id].Pop(val)) {
+                    ++received;
+                }
+            } while (!rings[id].IsDrained());
+        });
+    }
+    producer.join();
+
+    EXPECT_EQ(received, kCount);
+}
+
+TEST(ReadyBitmapTest, PushEdgeReportsEmptyToNonEmpty)
+{
+    SPSCRingBuffer<int, 8> ring;
+    bool was_empty = false;
+    ASSERT_TRUE(ring.PushEdge(1, was_empty));
+    EXPECT_TRUE(was_empty);
+    ASSERT_TRUE(ring.PushEdge(2, was_empty));
+    EXPECT_FALSE(was_empty);
+
+    int val = 0;
+    ASSERT_TRUE(ring.Pop(val));
+    EXPECT_FALSE(ring.IsDrained());
+    ASSERT_TRUE(ring.Pop(val));
+    EXPECT_TRUE(ring.IsDrained());
+
+    ASSERT_TRUE(ring.PushEdge(3, was_empty));
+    EXPECT_TRUE(was_empty);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "LoadGenerator.hpp"
+#include "MarketData.hpp"
+#include "Order.hpp"
+#include "RingBuffer.hpp"
+#include "RingSearch.hpp"
+#include "SPSC.hpp"
+
+using namespace hft::core;
+
+TEST(RingSearchTest, SegmentsFollowWraparound)
+{
+    SPSCRingBuffer<int, 8> ring;
+    int out = 0;
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_TRUE(ring.Push(i));
+    }
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.Pop(out));
+    }
+    for (int i = 6; i < 10; ++i) {
+        ASSERT_TRUE(ring.Push(i));
+    }
+    const auto segments = ring.Segments();
+    EXPECT_EQ(segments.first_size, 4U);
+    EXPECT_EQ(segments.second_size, 2U);
+    for (std::size_t i = 0; i < segments.Size(); ++i) {
+        EXPECT_EQ(segments[i], static_cast<int>(i) + 4);
+    }
+}
+
+TEST(RingSearchTest, FindsOrderIdsAcrossWrap)
+{
+    auto ring = std::make_unique<RingBuffer<OrderRequest, 64, OverflowPolicy::Reject, ThreadModel::SPSC>>();
+    OrderRequest order;
+    for (int i = 0; i < 50; ++i) {
+        order.order_id = 1000 + i;
+        ASSERT_TRUE(ring->Push(order));
+    }
+    for (int i = 0; i < 40; ++i) {
+        ASSERT_TRUE(ring->Pop(order));
+    }
+    // Occupied region is slots 40..63 then 0..29, ids 1040..1089
+    for (int i = 50; i < 90; ++i) {
+        order.order_id = 1000 + i;
+        ASSERT_TRUE(ring->Push(order));
+    }
+    const auto segments = ring->Segments();
+    ASSERT_EQ(segments.Size(), 50U);
+    ASSERT_NE(segments.second_size, 0U);
+
+    EXPECT_EQ(FindFirst<&OrderRequest::order_id>(segments, 1040U), 0U);
+    EXPECT_EQ(FindFirst<&OrderRequest::order_id>(segments, 1063U), 23U);
+    EXPECT_EQ(FindFirst<&OrderRequest::order_id>(segments, 1064U), 24U);
+    EXPECT_EQ(FindFirst<&OrderRequest::order_id>(segments, 1089U), 49U);
+    EXPECT_EQ(FindFirst<&OrderRequest::order_id>(segments, 1039U), kNotFound);
+}
+
+TEST(RingSearchTest, MatchesScalarScan)
+{
+    auto ring = std::make_unique<SPSCRingBuffer<MarketEvent, 1024>>();
+    FastRng rng(7);
+    MarketEvent event;
+    for (int round = 0; round < 3; ++round) {
+        while (ring->Push(event)) {
+            event.instrument = static_cast<std::uint32_t>(rng.NextBelow(16));
+            event.sequence = rng.NextBelow(64);
+        }
+        for (int i = 0; i < 300; ++i) {
+            ASSERT_TRUE(ring->Pop(event));
+        }
+    }
+    const auto segments = ring->Segments();
+    std::vector<std::size_t> expected(segments.Size());
+    std::vector<std::size_t> actual(segments.Size());
+    for (std::uint32_t key = 0; key < 16; ++key) {
+        const std::size_t count = FindAllScalar<&MarketEvent::instrument>(segments, key, expected.data(), expected.size());
+        ASSERT_EQ(FindAll<&MarketEvent::instrument>(segments, key, actual.data(), actual.size()), count);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.begin() + count, actual.begin()));
+    }
+    for (std::uint64_t key = 0; key < 64; ++key) {
+        const std::size_t count = FindAllScalar<&MarketEvent::sequence>(segments, key, expected.data(), expected.size());
+        ASSERT_EQ(FindAll<&MarketEvent::sequence>(segments, key, actual.data(), actual.size()), count);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.begin() + count, actual.begin()));
+    }
+}
+
+TEST(RingSearchTest, StopsAtMaxOut)
+{
+    SPSCRingBuffer<MarketEvent, 32> ring;
+    MarketEvent event;
+    event.instrument = 5;
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(ring.Push(event));
+    }
+    std::size_t hits[3] = { 0, 0, 0 };
+    EXPECT_EQ(FindAll<&MarketEvent::instrument>(ring.Segments(), 5U, hits, 3), 3U);
+    EXPECT_EQ(hits[2], 2U);
+
+    SPSCRingBuffer<MarketEvent, 32> empty;
+    EXPECT_EQ(FindFirst<&MarketEvent::instrument>(empty.Segments(), 5U), kNotFound);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include "RingSizing.hpp"
+
+using namespace hft::core;
+
+TEST(RingSizingTest, TracksPeakBacklog)
+{
+    auto ring = std::make_unique<RecordedRing<std::uint64_t, 1024>>();
+    for (std::uint64_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(ring->Push(i));
+    }
+    std::uint64_t value = 0;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(ring->Pop(value));
+    }
+    for (std::uint64_t i = 0; i < 5; ++i) {
+        ASSERT_TRUE(ring->Push(i));
+    }
+    while (ring->Pop(value)) {
+    }
+
+    const CapacityReport report = ring->Analyze();
+    EXPECT_EQ(report.capacity, 1024u);
+    EXPECT_EQ(report.slot_bytes, sizeof(std::uint64_t));
+    EXPECT_EQ(report.arrivals, 15u);
+    EXPECT_EQ(report.departures, 15u);
+    EXPECT_EQ(report.dropped, 0u);
+    EXPECT_EQ(report.peak_backlog, 12u);
+    // 12 * 1.25 = 15 fits the 15 usable slots of 16
+    EXPECT_EQ(report.recommended_capacity, 16u);
+    EXPECT_EQ(ring->Analyze(0.0).recommended_capacity, 16u);
+    EXPECT_EQ(ring->Analyze(0.5).recommended_capacity, 32u);
+    EXPECT_LT(report.RecommendedBytes(), report.Bytes());
+}
+
+TEST(RingSizingTest, DroppedPushesRaiseTheRecommendation)
+{
+    RecordedRing<std::uint64_t, 8> ring;
+    std::size_t accepted = 0;
+    for (std::uint64_t i = 0; i < 20; ++i) {
+        accepted += ring.Push(i) ? 1 : 0;
+    }
+    EXPECT_EQ(accepted, 7u);
+
+    const CapacityReport report = ring.Analyze();
+    EXPECT_EQ(report.dropped, 13u);
+    EXPECT_EQ(ring.GetDropCount(), 13u);
+    EXPECT_EQ(report.peak_backlog, 7u);
+    // Nothing was popped, every refused push would still be queued
+    EXPECT_EQ(report.demand_backlog, 20u);
+    EXPECT_EQ(report.recommended_capacity, 32u);
+
+    std::ostringstream out;
+    Print(out, "feed", report);
+    EXPECT_NE(out.str().find("undersized"), std::string::npos);
+}
+
+TEST(RingSizingTest, CountsBatches)
+{
+    RecordedRing<std::uint64_t, 16> ring;
+    std::array<std::uint64_t, 20> values {};
+    EXPECT_EQ(ring.PushBatch(values.data(), values.size()), 15u);
+
+    const CapacityReport report = ring.Analyze();
+    EXPECT_EQ(report.arrivals, 15u);
+    EXPECT_EQ(report.dropped, 5u);
+    EXPECT_EQ(report.peak_backlog, 15u);
+}
+
+TEST(RingSizingTest, FlagsSessionsLongerThanTheBuckets)
+{
+    RingOccupancyRecorder recorder(64, 8, 1.0, 1);
+    recorder.OnPush(1);
+    const std::uint64_t start = ReadTsc();
+    while (ReadTsc() - start < 100000) {
+        CpuRelax();
+    }
+    recorder.OnPop();
+
+    const CapacityReport report = recorder.Analyze();
+    EXPECT_TRUE(report.truncated);
+    EXPECT_EQ(report.peak_backlog, 1u);
+}
+
+TEST(RingSizingTest, RecordsAcrossThreads)
+{
+    constexpr std::uint64_t kMessages = 200000;
+    auto ring = std::make_unique<RecordedRing<std::uint64_t, 256>>(100.0);
+    std::uint64_t consumed = 0;
+
+    std::thread consumer([&] {
+        std::uint64_t value = 0;
+        while (consumed < kMessages) {
+            if (ring->Pop(value)) {
+                EXPECT_EQ(value, consumed);
+                ++consumed;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (std::uint64_t i = 0; i < kMessages;) {
+        if (ring->Push(i)) {
+            ++i;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+
+    const CapacityReport report = ring->Analyze();
+    EXPECT_EQ(report.arrivals, kMessages);
+    EXPECT_EQ(report.departures, kMessages);
+    EXPECT_LE(report.peak_backlog, 255u);
+    EXPECT_GE(report.recommended_capacity - 1, report.peak_backlog);
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "LoadGenerator.hpp"
+#include "SlidingWindow.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+struct Sample {
+    std::uint64_t timestamp;
+    double value;
+    double weight;
+};
+
+/**
+ * @brief Recomputes every statistic from scratch
+ *
+ */
+struct Reference {
+    std::deque<Sample> samples;
+    WindowConfig config;
+
+    void Add(const Sample& sample)
+    {
+        samples.push_back(sample);
+        while (samples.size() > config.max_count) {
+            samples.pop_front();
+        }
+        while (config.max_age != 0 && sample.timestamp - samples.front().timestamp >= config.max_age) {
+            samples.pop_front();
+        }
+    }
+
+    template <std::size_t Capacity>
+    void Expect(const SlidingWindow<Capacity>& window) const
+    {
+        ASSERT_EQ(window.Count(), samples.size());
+        double min = samples.front().value;
+        double max = min;
+        double sum = 0.0;
+        double weight = 0.0;
+        double weighted = 0.0;
+        for (const Sample& sample : samples) {
+            min = std::min(min, sample.value);
+            max = std::max(max, sample.value);
+            sum += sample.value;
+            weight += sample.weight;
+            weighted += sample.value * sample.weight;
+        }
+        const double mean = sum / static_cast<double>(samples.size());
+        double m2 = 0.0;
+        for (const Sample& sample : samples) {
+            m2 += (sample.value - mean) * (sample.value - mean);
+        }
+        EXPECT_EQ(window.Min(), min);
+        EXPECT_EQ(window.Max(), max);
+        EXPECT_NEAR(window.Sum(), sum, 1e-6);
+        EXPECT_NEAR(window.Mean(), mean, 1e-9);
+        EXPECT_NEAR(window.Variance(), m2 / static_cast<double>(samples.size()), 1e-6);
+        EXPECT_NEAR(window.Vwap(), weighted / weight, 1e-9);
+    }
+};
+
+auto RandomSamples(std::size_t count, std::uint64_t seed) -> std::vector<Sample>
+{
+    FastRng rng(seed);
+    std::vector<Sample> samples(count);
+    std::uint64_t timestamp = 0;
+    for (Sample& sample : samples) {
+        timestamp += rng.NextBelow(100);
+        sample.timestamp = timestamp;
+        sample.value = 1000.0 + static_cast<double>(rng.NextBelow(2000)) / 8.0;
+        sample.weight = 1.0 + rng.NextBelow(50);
+    }
+    return samples;
+}
+
+} // namespace
+
+TEST(SlidingWindowTest, EmptyWindowIsNaN)
+{
+    SlidingWindow<8> window;
+    EXPECT_TRUE(window.Empty());
+    EXPECT_TRUE(std::isnan(window.Min()));
+    EXPECT_TRUE(std::isnan(window.Mean()));
+    EXPECT_TRUE(std::isnan(window.Vwap()));
+}
+
+TEST(SlidingWindowTest, CountWindowMatchesReference)
+{
+    WindowConfig config;
+    config.max_count = 100;
+    auto window = std::make_unique<SlidingWindow<128>>(config);
+    Reference reference { {}, config };
+    for (const Sample& sample : RandomSamples(5000, 1)) {
+        window->Add(sample.timestamp, sample.value, sample.weight);
+        reference.Add(sample);
+        if (sample.timestamp % 7 == 0) {
+            reference.Expect(*window);
+        }
+    }
+    reference.Expect(*window);
+}
+
+TEST(SlidingWindowTest, TimeWindowMatchesReference)
+{
+    WindowConfig config;
+    config.max_age = 1500;
+    auto window = std::make_unique<SlidingWindow<256>>(config);
+    Reference reference { {}, WindowConfig { 256, config.max_age } };
+    for (const Sample& sample : RandomSamples(5000, 2)) {
+        window->Add(sample.timestamp, sample.value, sample.weight);
+        reference.Add(sample);
+    }
+    reference.Expect(*window);
+
+    window->Expire(reference.samples.back().timestamp + 1500);
+    EXPECT_TRUE(window->Empty());
+}
+
+TEST(SlidingWindowTest, BatchMatchesSingleAdds)
+{
+    WindowConfig config;
+    config.max_count = 200;
+    config.max_age = 4000;
+    auto window = std::make_unique<SlidingWindow<256>>(config);
+    Reference reference { {}, config };
+
+    const auto samples = RandomSamples(6000, 3);
+    std::vector<std::uint64_t> timestamps;
+    std::vector<double> values;
+    std::vector<double> weights;
+    for (const Sample& sample : samples) {
+        timestamps.push_back(sample.timestamp);
+        values.push_back(sample.value);
+        weights.push_back(sample.weight);
+    }
+
+    FastRng rng(4);
+    std::size_t done = 0;
+    while (done < samples.size()) {
+        const std::size_t batch = std::min<std::size_t>(1 + rng.NextBelow(500), samples.size() - done);
+        window->AddBatch(timestamps.data() + done, values.data() + done, weights.data() + done, batch);
+        for (std::size_t i = 0; i < batch; ++i) {
+            reference.Add(samples[done + i]);
+        }
+        done += batch;
+        reference.Expect(*window);
+    }
+}
+
+TEST(SlidingWindowTest, BatchWithoutWeights)
+{
+    SlidingWindow<16> window(WindowConfig { 4, 0 });
+    const std::uint64_t timestamps[] = { 1, 2, 3, 4, 5, 6 };
+    const double values[] = { 5, 1, 4, 2, 8, 3 };
+    window.AddBatch(timestamps, values, nullptr, 6);
+    EXPECT_EQ(window.Count(), 4U);
+    EXPECT_EQ(window.Min(), 2.0);
+    EXPECT_EQ(window.Max(), 8.0);
+    EXPECT_DOUBLE_EQ(window.Sum(), 17.0);
+    EXPECT_DOUBLE_EQ(window.Vwap(), 17.0 / 4.0);
+}
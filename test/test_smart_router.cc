@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "Seqlock.hpp"
+#include "SmartOrderRouter.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+struct Pair {
+    std::uint64_t a = 0;
+    std::uint64_t b = 0;
+    std::uint64_t c = 0;
+};
+
+auto Ask(std::int64_t price, std::uint32_t quantity) -> VenueQuote
+{
+    VenueQuote quote;
+    quote.bid_price = price - 1;
+    quote.ask_price = price;
+    quote.bid_quantity = quantity;
+    quote.ask_quantity = quantity;
+    return quote;
+}
+
+auto Parent(std::uint64_t id, Side side, std::int64_t limit, std::uint32_t quantity) -> OrderRequest
+{
+    OrderRequest order;
+    order.order_id = id;
+    order.side = side;
+    order.price = limit;
+    order.quantity = quantity;
+    return order;
+}
+
+template <typename Router>
+auto PopChild(Router& router, std::uint32_t venue, OrderRequest& out) -> bool
+{
+    EncodedOrder encoded;
+    if (!router.Ring(venue).Pop(encoded)) {
+        return false;
+    }
+    return OrderEncoder::Decode(encoded.bytes.data(), encoded.length, out);
+}
+
+} // namespace
+
+TEST(SeqlockTest, StoreAndLoad)
+{
+    Seqlock<Pair> lock;
+    EXPECT_EQ(lock.Version(), 1U);
+    lock.Store(Pair { 1, 2, 3 });
+    const Pair value = lock.Load();
+    EXPECT_EQ(value.a, 1U);
+    EXPECT_EQ(value.c, 3U);
+    EXPECT_EQ(lock.Version(), 2U);
+}
+
+TEST(SeqlockTest, ReaderNeverSeesTornValue)
+{
+    Seqlock<Pair> lock;
+    std::atomic<bool> done { false };
+    std::thread writer([&] {
+        for (std::uint64_t i = 1; i <= 200000; ++i) {
+            lock.Store(Pair { i, i, i });
+        }
+        done.store(true);
+    });
+    std::uint64_t torn = 0;
+    while (!done.load()) {
+        const Pair value = lock.Load();
+        torn += (value.a != value.b || value.b != value.c) ? 1 : 0;
+    }
+    writer.join();
+    EXPECT_EQ(torn, 0U);
+    EXPECT_EQ(lock.Load().a, 200000U);
+}
+
+TEST(SmartOrderRouterTest, RanksByAllInCost)
+{
+    ConsolidatedBook<> book(4);
+    auto router = std::make_unique<SmartOrderRouter<>>(book, 3);
+    book.Update(0, 0, Ask(100, 10));
+    book.Update(1, 0, Ask(100, 10));
+    book.Update(2, 0, Ask(101, 10));
+    router->SetVenue(0, VenueProfile { 2, 0, true });
+    router->SetVenue(1, VenueProfile { -1, 0, true }); // rebate
+    router->SetVenue(2, VenueProfile { 0, 0, true });
+
+    SmartOrderRouter<>::Result result;
+    EXPECT_EQ(router->Route(Parent(7, Side::Buy, 101, 25), result), 25U);
+    ASSERT_EQ(result.child_count, 3U);
+    EXPECT_EQ(result.children[0].venue, 1U); // 99 all in
+    EXPECT_EQ(result.children[1].venue, 2U); // 101
+    EXPECT_EQ(result.children[2].venue, 0U); // 102
+    EXPECT_EQ(result.children[2].quantity, 5U);
+    EXPECT_EQ(result.unrouted, 0U);
+
+    OrderRequest child;
+    ASSERT_TRUE(PopChild(*router, 1, child));
+    EXPECT_EQ(child.order_id, SmartOrderRouter<>::ChildId(7, 1));
+    EXPECT_TRUE(SmartOrderRouter<>::IsChildId(child.order_id));
+    EXPECT_EQ(SmartOrderRouter<>::ParentId(child.order_id), 7U);
+    EXPECT_EQ(child.price, 100);
+    EXPECT_EQ(child.quantity, 10U);
+    EXPECT_EQ(child.action, OrderAction::New);
+    ASSERT_TRUE(PopChild(*router, 0, child));
+    EXPECT_EQ(child.quantity, 5U);
+}
+
+TEST(SmartOrderRouterTest, LatencyPenaltyBreaksEqualPrices)
+{
+    ConsolidatedBook<> book(1);
+    RouterConfig config;
+    config.latency_cost_per_us = 1;
+    config.latency_smoothing = 0.5;
+    SmartOrderRouter<> router(book, 2, config);
+    book.Update(0, 0, Ask(100, 10));
+    book.Update(1, 0, Ask(100, 10));
+    router.SetVenue(0, VenueProfile { 0, 5000, true });
+    router.SetVenue(1, VenueProfile { 0, 1000, true });
+
+    SmartOrderRouter<>::Result result;
+    router.Route(Parent(1, Side::Buy, 100, 5), result);
+    ASSERT_EQ(result.child_count, 1U);
+    EXPECT_EQ(result.children[0].venue, 1U);
+
+    router.RecordLatency(1, 20000);
+    EXPECT_EQ(router.Venue(1).latency_ns, 10500U);
+    router.Route(Parent(2, Side::Buy, 100, 5), result);
+    ASSERT_EQ(result.child_count, 1U);
+    EXPECT_EQ(result.children[0].venue, 0U);
+}
+
+TEST(SmartOrderRouterTest, SellRespectsLimitAndReportsRemainder)
+{
+    ConsolidatedBook<> book(1);
+    SmartOrderRouter<> router(book, 3);
+    book.Update(0, 0, Ask(101, 4)); // bid 100
+    book.Update(1, 0, Ask(106, 4)); // bid 105
+    book.Update(2, 0, Ask(99, 4)); // bid 98, below the limit
+    router.SetVenue(1, VenueProfile { 0, 0, false });
+
+    SmartOrderRouter<>::Result result;
+    EXPECT_EQ(router.Route(Parent(3, Side::Sell, 100, 10), result), 4U);
+    ASSERT_EQ(result.child_count, 1U);
+    EXPECT_EQ(result.children[0].venue, 0U);
+    EXPECT_EQ(result.children[0].price, 100);
+    EXPECT_EQ(result.unrouted, 6U);
+
+    OrderRequest cancel = Parent(3, Side::Sell, 100, 10);
+    cancel.action = OrderAction::Cancel;
+    EXPECT_EQ(router.Route(cancel, result), 0U);
+    EXPECT_EQ(result.child_count, 0U);
+}
+
+TEST(SmartOrderRouterTest, FullVenueRingCountsDrop)
+{
+    ConsolidatedBook<4> book(1);
+    SmartOrderRouter<4, 4> router(book, 1);
+    book.Update(0, 0, Ask(100, 1000));
+    SmartOrderRouter<4, 4>::Result result;
+    for (std::uint64_t id = 0; id < 3; ++id) {
+        EXPECT_EQ(router.Route(Parent(id, Side::Buy, 100, 1), result), 1U);
+    }
+    EXPECT_EQ(router.Route(Parent(3, Side::Buy, 100, 1), result), 0U);
+    EXPECT_EQ(result.unrouted, 1U);
+    EXPECT_EQ(router.GetDropCount(), 1U);
+}
+
+TEST(SmartOrderRouterTest, RejectsOutOfRangeIds)
+{
+    ConsolidatedBook<4> book(2);
+    EXPECT_FALSE(book.Update(4, 0, Ask(100, 10)));
+    EXPECT_FALSE(book.Update(0, 2, Ask(100, 10)));
+    EXPECT_EQ(book.Quote(4, 0).ask_quantity, 0U);
+    EXPECT_EQ(book.Quote(0, 2).ask_quantity, 0U);
+    EXPECT_TRUE(book.Update(3, 1, Ask(100, 10)));
+    EXPECT_EQ(book.Quote(3, 1).ask_quantity, 10U);
+
+    // A parent id at the limit could produce a child id outside the child range
+    using Router = SmartOrderRouter<4, 4>;
+    Router router(book, 4);
+    Router::Result result;
+    OrderRequest parent = Parent(Router::kMaxParentId, Side::Buy, 100, 5);
+    parent.instrument = 1;
+    EXPECT_EQ(router.Route(parent, result), 0U);
+    EXPECT_EQ(result.unrouted, 5U);
+
+    parent.order_id = Router::kMaxParentId - 1;
+    EXPECT_EQ(router.Route(parent, result), 5U);
+    ASSERT_EQ(result.child_count, 1U);
+    EXPECT_EQ(Router::ParentId(result.children[0].order_id), Router::kMaxParentId - 1);
+    EXPECT_FALSE(Router::IsChildId(parent.order_id));
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "RingBuffer.hpp"
+#include "Snapshot.hpp"
+#include "TradingEngine.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+constexpr std::uint32_t kEngineSection = 1;
+constexpr std::uint32_t kInstruments = 4;
+
+auto TempPath(const char* name) -> std::string
+{
+    return std::string(::testing::TempDir()) + name + std::to_string(::getpid());
+}
+
+auto Event(std::uint64_t sequence) -> MarketEvent
+{
+    MarketEvent event;
+    event.sequence = sequence;
+    event.instrument = static_cast<std::uint32_t>(sequence % kInstruments);
+    event.side = sequence % 2 == 0 ? Side::Buy : Side::Sell;
+    event.price = event.side == Side::Buy ? 100 - static_cast<std::int64_t>(sequence % 5) : 101 + static_cast<std::int64_t>(sequence % 5);
+    event.quantity = 1 + static_cast<std::uint32_t>(sequence % 3);
+    return event;
+}
+
+using OrderRing = RingBuffer<EncodedOrder, 1024, OverflowPolicy::Overwrite, ThreadModel::SingleThread>;
+
+} // namespace
+
+TEST(SnapshotTest, CaptureAtBarrierWhileRunning)
+{
+    const std::string path = TempPath("engine.snap");
+    std::remove(path.c_str());
+
+    TradingEngine<> engine(kInstruments, RiskLimits {});
+    SnapshotStore store;
+    ASSERT_TRUE(store.Open(path.c_str(), 1 << 16));
+    SnapshotCoordinator coordinator(store);
+    const std::uint32_t stage = coordinator.AddStage(kEngineSection, engine.SnapshotSize());
+    ASSERT_NE(stage, SnapshotCoordinator::kInvalidStage);
+
+    // Reference state at the barrier
+    TradingEngine<> expected(kInstruments, RiskLimits {});
+    OrderRing orders;
+    for (std::uint64_t sequence = 1; sequence <= 500; ++sequence) {
+        (void)expected.OnEvent(Event(sequence), orders);
+    }
+
+    ASSERT_TRUE(coordinator.Request(500));
+    EXPECT_FALSE(coordinator.Request(600));
+
+    // The stage keeps running past the barrier, capture happens on its own thread
+    std::thread stage_thread([&] {
+        OrderRing out;
+        for (std::uint64_t sequence = 1; sequence <= 1000; ++sequence) {
+            coordinator.BeforeEvent(stage, sequence, engine);
+            (void)engine.OnEvent(Event(sequence), out);
+        }
+    });
+    stage_thread.join();
+    ASSERT_TRUE(coordinator.TryCommit());
+    EXPECT_FALSE(coordinator.Pending());
+    EXPECT_FALSE(coordinator.Request(500));
+    store.Close();
+
+    // Restart from the file
+    SnapshotStore reopened;
+    ASSERT_TRUE(reopened.Open(path.c_str(), 1 << 16));
+    TradingEngine<> restored(kInstruments, RiskLimits {});
+    std::uint64_t barrier = 0;
+    ASSERT_TRUE(RestoreStage(reopened, kEngineSection, restored, barrier));
+    EXPECT_EQ(barrier, 500U);
+    EXPECT_EQ(restored.LastSequence(), 500U);
+    for (std::uint32_t i = 0; i < kInstruments; ++i) {
+        for (Side side : { Side::Buy, Side::Sell }) {
+            ASSERT_EQ(restored.Books().Book(i).LevelCount(side), expected.Books().Book(i).LevelCount(side));
+            for (std::size_t level = 0; level < restored.Books().Book(i).LevelCount(side); ++level) {
+                EXPECT_EQ(restored.Books().Book(i).Level(side, level).price, expected.Books().Book(i).Level(side, level).price);
+                EXPECT_EQ(restored.Books().Book(i).Level(side, level).quantity, expected.Books().Book(i).Level(side, level).quantity);
+            }
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotTest, IdleStageAndCorruption)
+{
+    const std::string path = TempPath("idle.snap");
+    std::remove(path.c_str());
+
+    TradingEngine<> engine(kInstruments, RiskLimits {});
+    SnapshotStore store;
+    ASSERT_TRUE(store.Open(path.c_str(), 1 << 16));
+    SnapshotView view;
+    EXPECT_FALSE(store.Latest(view));
+
+    SnapshotCoordinator coordinator(store);
+    const std::uint32_t stage = coordinator.AddStage(kEngineSection, engine.SnapshotSize());
+    OrderRing out;
+    for (std::uint64_t sequence = 1; sequence <= 10; ++sequence) {
+        (void)engine.OnEvent(Event(sequence), out);
+    }
+
+    ASSERT_TRUE(coordinator.Request(10));
+    EXPECT_FALSE(coordinator.TryCommit());
+    coordinator.OnIdle(stage, engine.LastSequence(), engine);
+    ASSERT_TRUE(coordinator.TryCommit());
+    ASSERT_TRUE(store.Latest(view));
+    EXPECT_EQ(view.barrier_sequence, 10U);
+
+    // Flip a payload byte behind the store's back
+    const SnapshotSection* section = view.Find(kEngineSection);
+    ASSERT_NE(section, nullptr);
+    const_cast<std::uint8_t*>(view.data)[section->offset + 20] ^= 0xFF;
+    EXPECT_FALSE(store.Latest(view));
+
+    SnapshotStore mismatched;
+    EXPECT_FALSE(mismatched.Open(path.c_str(), 1 << 12));
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotTest, RequestAfterStagePassedBarrierIsAbandoned)
+{
+    const std::string path = TempPath("late.snap");
+    std::remove(path.c_str());
+
+    TradingEngine<> engine(kInstruments, RiskLimits {});
+    SnapshotStore store;
+    ASSERT_TRUE(store.Open(path.c_str(), 1 << 16));
+    SnapshotCoordinator coordinator(store);
+    const std::uint32_t stage = coordinator.AddStage(kEngineSection, engine.SnapshotSize());
+
+    OrderRing out;
+    std::uint64_t sequence = 1;
+    for (; sequence <= 600; ++sequence) {
+        coordinator.BeforeEvent(stage, sequence, engine);
+        (void)engine.OnEvent(Event(sequence), out);
+    }
+
+    // The stage is at 600, its state as of 500 is gone
+    ASSERT_TRUE(coordinator.Request(500));
+    for (; sequence <= 700; ++sequence) {
+        coordinator.BeforeEvent(stage, sequence, engine);
+        (void)engine.OnEvent(Event(sequence), out);
+    }
+    EXPECT_FALSE(coordinator.TryCommit());
+    EXPECT_FALSE(coordinator.Pending());
+    EXPECT_EQ(coordinator.GetAbandonedCount(), 1U);
+    SnapshotView view;
+    EXPECT_FALSE(store.Latest(view));
+
+    // Same when the late request is seen from the idle hook
+    ASSERT_TRUE(coordinator.Request(650));
+    coordinator.OnIdle(stage, engine.LastSequence(), engine);
+    EXPECT_FALSE(coordinator.TryCommit());
+    EXPECT_EQ(coordinator.GetAbandonedCount(), 2U);
+
+    // A barrier ahead of the stage still works
+    ASSERT_TRUE(coordinator.Request(750));
+    for (; sequence <= 800; ++sequence) {
+        coordinator.BeforeEvent(stage, sequence, engine);
+        (void)engine.OnEvent(Event(sequence), out);
+    }
+    ASSERT_TRUE(coordinator.TryCommit());
+    ASSERT_TRUE(store.Latest(view));
+    EXPECT_EQ(view.barrier_sequence, 750U);
+
+    TradingEngine<> restored(kInstruments, RiskLimits {});
+    std::uint64_t barrier = 0;
+    ASSERT_TRUE(RestoreStage(store, kEngineSection, restored, barrier));
+    EXPECT_EQ(restored.LastSequence(), 750U);
+    store.Close();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include "MarketData.hpp"
+#include "SoARing.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+using PriceRing = SoARingBuffer<MarketEvent, 8, ThreadModel::SPSC, &MarketEvent::price, &MarketEvent::quantity, &MarketEvent::instrument>;
+
+auto Tick(std::int64_t price, std::uint32_t quantity) -> MarketEvent
+{
+    MarketEvent event;
+    event.price = price;
+    event.quantity = quantity;
+    event.instrument = static_cast<std::uint32_t>(price);
+    event.sequence = 99;
+    return event;
+}
+
+template <typename F>
+auto Sum(const RingSegments<F>& segments) -> std::int64_t
+{
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < segments.first_size; ++i) {
+        sum += segments.first[i];
+    }
+    for (std::size_t i = 0; i < segments.second_size; ++i) {
+        sum += segments.second[i];
+    }
+    return sum;
+}
+
+} // namespace
+
+TEST(SoARingTest, PushPopRoundTripsStoredFields)
+{
+    PriceRing ring;
+    ASSERT_TRUE(ring.Push(Tick(100, 5)));
+    ASSERT_TRUE(ring.Push(Tick(101, 6)));
+    EXPECT_EQ(ring.Size(), 2U);
+
+    MarketEvent out;
+    out.sequence = 7;
+    ASSERT_TRUE(ring.Pop(out));
+    EXPECT_EQ(out.price, 100);
+    EXPECT_EQ(out.quantity, 5U);
+    EXPECT_EQ(out.instrument, 100U);
+    // Not a stored field
+    EXPECT_EQ(out.sequence, 7U);
+}
+
+TEST(SoARingTest, RejectsWhenFull)
+{
+    PriceRing ring;
+    for (int i = 0; i < 7; ++i) {
+        ASSERT_TRUE(ring.Push(Tick(i, 1)));
+    }
+    EXPECT_FALSE(ring.Push(Tick(7, 1)));
+    EXPECT_EQ(ring.GetDropCount(), 1U);
+}
+
+TEST(SoARingTest, FieldViewsAreContiguousAndWrap)
+{
+    PriceRing ring;
+    MarketEvent out;
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_TRUE(ring.Push(Tick(i, 1)));
+    }
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(ring.Pop(out));
+    }
+    for (int i = 6; i < 12; ++i) {
+        ASSERT_TRUE(ring.Push(Tick(i, 2)));
+    }
+
+    const auto prices = ring.Field<&MarketEvent::price>();
+    EXPECT_EQ(prices.Size(), 7U);
+    EXPECT_EQ(prices.first_size, 3U);
+    EXPECT_EQ(prices.second_size, 4U);
+    EXPECT_EQ(prices[0], 5);
+    EXPECT_EQ(prices[6], 11);
+    EXPECT_EQ(Sum(prices), 5 + 6 + 7 + 8 + 9 + 10 + 11);
+    EXPECT_EQ(Sum(ring.Field<&MarketEvent::quantity>()), 1 + 6 * 2);
+
+    ring.Consume(4);
+    EXPECT_EQ(ring.Size(), 3U);
+    ASSERT_TRUE(ring.Pop(out));
+    EXPECT_EQ(out.price, 9);
+
+    ring.Consume(100);
+    EXPECT_TRUE(ring.Empty());
+}
+
+TEST(SoARingTest, FieldArraysAreCacheLineAligned)
+{
+    auto ring = std::make_unique<SoARingBuffer<MarketEvent, 1024, ThreadModel::SingleThread, &MarketEvent::price, &MarketEvent::quantity>>();
+    (void)ring->Push(Tick(1, 1));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ring->Field<&MarketEvent::price>().first) % 64, 0U);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ring->Field<&MarketEvent::quantity>().first) % 64, 0U);
+}
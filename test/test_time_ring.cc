@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "MarketData.hpp"
+#include "TimeIndexedRing.hpp"
+
+using namespace hft::core;
+
+namespace {
+
+using History = TimeIndexedRing<MarketEvent, 8, &MarketEvent::timestamp>;
+
+auto At(std::uint64_t timestamp) -> MarketEvent
+{
+    MarketEvent event;
+    event.timestamp = timestamp;
+    event.price = static_cast<std::int64_t>(timestamp);
+    return event;
+}
+
+} // namespace
+
+TEST(TimeIndexedRingTest, LowerBoundBeforeWrap)
+{
+    History history;
+    EXPECT_EQ(history.LowerBound(5), 0U);
+    for (std::uint64_t ts : { 10, 20, 20, 30 }) {
+        ASSERT_TRUE(history.Push(At(ts)));
+    }
+    EXPECT_EQ(history.LowerBound(0), 0U);
+    EXPECT_EQ(history.LowerBound(10), 0U);
+    EXPECT_EQ(history.LowerBound(11), 1U);
+    EXPECT_EQ(history.LowerBound(20), 1U);
+    EXPECT_EQ(history.LowerBound(30), 3U);
+    EXPECT_EQ(history.LowerBound(31), 4U);
+}
+
+TEST(TimeIndexedRingTest, RejectsGoingBackInTime)
+{
+    History history;
+    ASSERT_TRUE(history.Push(At(10)));
+    EXPECT_FALSE(history.Push(At(9)));
+    EXPECT_EQ(history.Size(), 1U);
+    EXPECT_EQ(history.GetRejectCount(), 1U);
+}
+
+TEST(TimeIndexedRingTest, LowerBoundAcrossWrap)
+{
+    History history;
+    for (std::uint64_t ts = 1; ts <= 13; ++ts) {
+        ASSERT_TRUE(history.Push(At(ts * 10)));
+    }
+    // Retains 60..130, physically wrapped
+    ASSERT_EQ(history.Size(), 8U);
+    EXPECT_EQ(history.At(0).timestamp, 60U);
+    const auto segments = history.Segments();
+    EXPECT_EQ(segments.first_size, 3U);
+    EXPECT_EQ(segments.second_size, 5U);
+    EXPECT_EQ(segments[7].timestamp, 130U);
+
+    for (std::size_t i = 1; i < 8; ++i) {
+        EXPECT_EQ(history.LowerBound(60 + i * 10), i);
+        EXPECT_EQ(history.LowerBound(60 + i * 10 - 5), i);
+    }
+    EXPECT_EQ(history.LowerBound(131), 8U);
+    // Evicted history cannot answer
+    EXPECT_EQ(history.LowerBound(60), kNotFound);
+    EXPECT_EQ(history.LowerBound(20), kNotFound);
+}
+
+TEST(TimeIndexedRingTest, AsOfReturnsStateAtTime)
+{
+    History history;
+    EXPECT_EQ(history.AsOf(100), kNotFound);
+    for (std::uint64_t ts = 1; ts <= 12; ++ts) {
+        ASSERT_TRUE(history.Push(At(ts * 10)));
+    }
+    EXPECT_EQ(history.AsOf(49), kNotFound);
+    EXPECT_EQ(history.At(history.AsOf(50)).timestamp, 50U);
+    EXPECT_EQ(history.At(history.AsOf(95)).timestamp, 90U);
+    EXPECT_EQ(history.At(history.AsOf(1000)).timestamp, 120U);
+    EXPECT_EQ(history.TotalPushed(), 12U);
+}